@@ -0,0 +1,62 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LOGIC_MINIATURE_MAPCACHE_H
+#define LOGIC_MINIATURE_MAPCACHE_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <opendlv/data/environment/Point3.h>
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+/**
+ * Binary file cache of the graph built from the map. The file starts with a
+ * versioned header holding a key, which is a hash of everything the graph
+ * was built from. A file with another version or key is ignored, so the
+ * graph is only rebuilt when the map configuration changes. The file is
+ * memory mapped when loaded, and written to a temporary file that is
+ * renamed into place, so a crash while saving never leaves a broken cache.
+ */
+class MapCache {
+ public:
+  explicit MapCache(const std::string &);
+  MapCache(const MapCache &) = delete;
+  MapCache &operator=(const MapCache &) = delete;
+  virtual ~MapCache();
+  static uint64_t hash(const void *, uint32_t, uint64_t);
+  bool load(uint64_t, std::vector<data::environment::Point3> &, 
+      std::vector<std::array<int32_t, 4>> &) const;
+  bool save(uint64_t, const std::vector<data::environment::Point3> &, 
+      const std::vector<std::array<int32_t, 4>> &) const;
+
+ private:
+  static const uint32_t VERSION;
+
+  std::string m_filename;
+};
+
+}
+}
+}
+
+#endif
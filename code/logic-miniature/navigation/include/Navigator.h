@@ -0,0 +1,189 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LOGIC_MINIATURE_NAVIGATOR_H
+#define LOGIC_MINIATURE_NAVIGATOR_H
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+#include <opendavinci/odcore/io/conference/ContainerListener.h>
+
+#include <opendlv/data/environment/Line.h>
+#include <opendlv/data/environment/Point3.h>
+
+#include "MapCache.h"
+#include "PathPlanner.h"
+#include "PosePredictor.h"
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+
+enum class navigationState
+{
+  REVERSE,
+  ROTATE_RIGHT,
+  ROTATE_LEFT,
+  FOLLOW,
+  PLAN
+};
+
+enum class stateModifier
+{
+  NONE,
+  DELAY
+};
+
+/**
+ * Gains and tolerances of the path following. The defaults are the values
+ * tuned on the robot, each of them can be overridden in the configuration.
+ */
+struct navigationParameters{
+  navigationParameters();
+  double goalTolerance;
+  double minPreviewLength;
+  double maxPreviewLength;
+  double turnRate;
+  int32_t eStill;
+  int32_t eDynFollowSpeed;
+};
+
+/**
+ * The navigation logic without any conference attached. Incoming containers
+ * are given to nextContainer and each call to step returns the containers to
+ * send, using the given time as the current time. This way the same logic is
+ * driven by the module in wall-clock time and by an in-process simulation on
+ * a virtual clock.
+ */
+class Navigator : public odcore::io::conference::ContainerListener {
+ public:
+  explicit Navigator(bool);
+  Navigator(const Navigator &) = delete;
+  Navigator &operator=(const Navigator &) = delete;
+  virtual ~Navigator();
+  void setUp(const odcore::base::KeyValueConfiguration &,
+      const odcore::data::TimeStamp &);
+  virtual void nextContainer(odcore::data::Container &);
+  std::vector<odcore::data::Container> step(const odcore::data::TimeStamp &);
+  navigationParameters getParameters() const;
+  void setParameters(const navigationParameters &);
+  std::vector<data::environment::Line> getWalls() const;
+  std::vector<data::environment::Point3> getPointsOfInterest() const;
+  uint32_t getGoalsReached() const;
+
+ private:
+
+  static const double S_W_SIDE_DETECTION;
+  static const double S_W_FRONT_DETECTION;
+  static const double S_W_CLOSE_FRONT_DETECTION;
+  static const double S_OUT_OF_RANGE;
+
+  static const double T_REVERSE;
+  static const double T_ROTATE_REVERSE;
+  static const double T_TURN;
+
+  static const double T_LPS_TIMEOUT;
+
+
+  static const int32_t E_FORWARD;
+  static const int32_t E_REVERSE;
+  static const int32_t E_ROTATE_RIGHT_L;
+  static const int32_t E_ROTATE_RIGHT_R;
+  static const int32_t E_ROTATE_LEFT_L;
+  static const int32_t E_ROTATE_LEFT_R;
+  static const int32_t E_DYN_TURN_SPEED;
+  //static const uint32_t E_SEARCH;
+
+  static const uint32_t UPDATE_FREQ;
+
+
+  static const uint8_t WALL_MARGINS;
+  static const uint8_t NODE_SPACING;
+
+
+  void decodeResolveSensors();
+  void logicHandling();
+  void pathPlanning();
+  std::array<int32_t, 2> engineHandling();
+  std::array<int32_t, 2> followPreview();
+  std::array<int32_t, 2> forward();
+  bool modifierHandling(const std::vector<odcore::data::TimeStamp> &since, const std::vector<double> &until);
+  bool modifierHandling(const std::vector<odcore::data::TimeStamp> &since, const double &until);
+  bool modifierHandling(const odcore::data::TimeStamp &since, const double &until);
+  bool modifierHandling(const std::vector<double> &since, const std::vector<double> &until);
+  bool modifierHandling(const std::vector<double> &since, const double &until);
+  bool modifierHandling(const double &since, const double &until);
+  std::vector<data::environment::Point3> ReadPointString(std::string const &) const;
+  void createGraph(void);
+  uint64_t getMapKey() const;
+  void calculatePath();
+
+
+  std::vector<data::environment::Line> m_outerWalls;
+  std::vector<data::environment::Line> m_innerWalls;
+  std::vector<data::environment::Point3> m_pointsOfInterest;
+  std::map<uint16_t, float> m_analogReadings;
+  std::map<uint16_t, bool> m_gpioReadings;
+  std::vector<uint16_t> m_gpioOutputPins;
+  std::vector<uint16_t> m_pwmOutputPins;
+  PathPlanner m_planner;
+  std::string m_mapCacheFilename;
+  std::vector<data::environment::Point3> m_path;
+  navigationParameters m_parameters;
+  PosePredictor m_posePredictor;
+  bool m_usePosePredictor;
+
+  navigationState m_currentState;
+  navigationState m_lastState;
+  stateModifier m_currentModifer;
+
+  odcore::data::TimeStamp m_t_Current;
+  odcore::data::TimeStamp m_t_Last;
+  odcore::data::TimeStamp m_t_LPS;
+  std::array<int32_t,2> m_MotorDuties;
+
+  bool m_s_w_FrontLeft;
+  odcore::data::TimeStamp m_s_w_FrontLeft_t;
+  bool m_s_w_FrontRight;
+  odcore::data::TimeStamp m_s_w_FrontRight_t;
+  uint16_t m_updateCounter;
+  bool m_debug;
+
+  data::environment::Point3 m_currentPosition;
+  double m_currentYaw;
+  uint32_t m_currentPreview;
+  uint8_t m_goToInterestPoint;
+  uint32_t m_goalsReached;
+  uint32_t m_speakerDuty;
+
+
+
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LOGIC_MINIATURE_PATHPLANNER_H
+#define LOGIC_MINIATURE_PATHPLANNER_H
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <opendlv/data/environment/Point3.h>
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+/**
+ * Shortest path search over the grid of free nodes. All memory is allocated
+ * when the nodes are set, after that planning does not touch the heap. The
+ * search state of each node is stamped with the generation of the plan that
+ * wrote it, so the state of the previous plan is cleared by increasing the
+ * generation rather than by clearing the arrays.
+ */
+class PathPlanner {
+ public:
+  PathPlanner();
+  PathPlanner(const PathPlanner &) = delete;
+  PathPlanner &operator=(const PathPlanner &) = delete;
+  virtual ~PathPlanner();
+  void setNodes(const std::vector<data::environment::Point3> &, double);
+  void setGraph(const std::vector<data::environment::Point3> &, 
+      const std::vector<std::array<int32_t, 4>> &, double);
+  const std::vector<data::environment::Point3> &getNodes() const;
+  const std::vector<std::array<int32_t, 4>> &getNeighbours() const;
+  bool plan(const data::environment::Point3 &, 
+      const data::environment::Point3 &, 
+      std::vector<data::environment::Point3> &);
+  uint32_t getNodeCount() const;
+
+ private:
+  int32_t getClosestNode(const data::environment::Point3 &) const;
+  void nextGeneration();
+
+  std::vector<data::environment::Point3> m_nodes;
+  std::vector<std::array<int32_t, 4>> m_neighbours;
+  std::vector<int32_t> m_cost;
+  std::vector<int32_t> m_parent;
+  std::vector<uint32_t> m_costGeneration;
+  std::vector<uint32_t> m_closedGeneration;
+  std::vector<std::pair<int32_t, int32_t>> m_open;
+  uint32_t m_generation;
+  int32_t m_edgeCost;
+};
+
+}
+}
+}
+
+#endif
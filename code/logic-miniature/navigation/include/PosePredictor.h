@@ -0,0 +1,81 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LOGIC_MINIATURE_POSEPREDICTOR_H
+#define LOGIC_MINIATURE_POSEPREDICTOR_H
+
+#include <array>
+
+#include <opendavinci/odcore/data/TimeStamp.h>
+
+#include <opendlv/data/environment/Point3.h>
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+/**
+ * Dead reckoning of the robot pose between LPS updates. The pose is driven
+ * by a unicycle model of the commanded motor duties and is pulled towards
+ * each LPS measurement by a complementary filter. The pose can be asked for
+ * at any time, and is then extrapolated to that time plus the command delay,
+ * which is when a command given now takes effect.
+ */
+class PosePredictor {
+ public:
+  PosePredictor();
+  PosePredictor(const PosePredictor &) = delete;
+  PosePredictor &operator=(const PosePredictor &) = delete;
+  virtual ~PosePredictor();
+  void setModel(double, double, int32_t, int32_t);
+  void setGains(double, double);
+  void setCommandDelay(double);
+  void setMotorDuties(const std::array<int32_t, 2> &, 
+      const odcore::data::TimeStamp &);
+  void correct(const data::environment::Point3 &, double, 
+      const odcore::data::TimeStamp &);
+  void predict(const odcore::data::TimeStamp &, data::environment::Point3 &, 
+      double &) const;
+  bool isInitialised() const;
+
+ private:
+  double getWheelSpeed(int32_t) const;
+  void integrate(double, double &, double &, double &) const;
+  void propagate(int64_t);
+
+  double m_wheelSpeed;
+  double m_robotRadius;
+  int32_t m_minDuty;
+  int32_t m_maxDuty;
+  double m_positionGain;
+  double m_yawGain;
+  int64_t m_commandDelay;
+  double m_velocity;
+  double m_yawRate;
+  double m_positionX;
+  double m_positionY;
+  double m_yaw;
+  int64_t m_time;
+  bool m_isInitialised;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "MapCache.h"
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+namespace {
+
+struct mapCacheHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  uint32_t nodeCount;
+  uint32_t reserved;
+};
+
+struct mapCacheNode {
+  double x;
+  double y;
+  std::array<int32_t, 4> neighbours;
+};
+
+const char MAGIC[4] = {'N', 'A', 'V', 'M'};
+
+}
+
+// Increase when the graph or the file layout changes.
+const uint32_t MapCache::VERSION = 1;
+
+/*
+  Constructor.
+*/
+MapCache::MapCache(const std::string &a_filename)
+    : m_filename(a_filename)
+{
+}
+
+/*
+  Destructor.
+*/
+MapCache::~MapCache()
+{
+}
+
+/*
+  FNV-1a hash of the given bytes, continuing from the given hash. Use the
+  FNV offset basis 14695981039346656037 to start a new hash.
+*/
+uint64_t MapCache::hash(const void *a_data, uint32_t a_size, uint64_t a_hash)
+{
+  const uint8_t *data = static_cast<const uint8_t *>(a_data);
+  for (uint32_t i = 0; i < a_size; i++) {
+    a_hash ^= data[i];
+    a_hash *= 1099511628211ull;
+  }
+  return a_hash;
+}
+
+/*
+  Loads the graph if the file exists, was saved with the same version and
+  key, and is consistent, that is has the size given by its node count and
+  only refers to neighbours that exist. Otherwise the graph is left untouched
+  so that it can be rebuilt.
+*/
+bool MapCache::load(uint64_t a_key, 
+    std::vector<data::environment::Point3> &a_nodes, 
+    std::vector<std::array<int32_t, 4>> &a_neighbours) const
+{
+  int fd = open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0 || fileStatus.st_size < 0
+      || static_cast<uint64_t>(fileStatus.st_size) < sizeof(mapCacheHeader)
+      || static_cast<uint64_t>(fileStatus.st_size) 
+          > std::numeric_limits<size_t>::max()) {
+    close(fd);
+    return false;
+  }
+  size_t const fileSize = static_cast<size_t>(fileStatus.st_size);
+  void *memory = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    return false;
+  }
+
+  bool isLoaded = false;
+  const mapCacheHeader *header = static_cast<const mapCacheHeader *>(memory);
+  // In 64 bits, since the node count times the node size may not fit in a
+  // size_t on a 32 bit target.
+  uint64_t const expectedSize = sizeof(mapCacheHeader) 
+      + static_cast<uint64_t>(header->nodeCount) * sizeof(mapCacheNode);
+  if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 
+      && header->version == VERSION && header->key == a_key 
+      && static_cast<uint64_t>(fileSize) == expectedSize) {
+    uint32_t const nodeCount = header->nodeCount;
+    const uint8_t *nodes = 
+        static_cast<const uint8_t *>(memory) + sizeof(mapCacheHeader);
+    std::vector<data::environment::Point3> loadedNodes(nodeCount);
+    std::vector<std::array<int32_t, 4>> loadedNeighbours(nodeCount);
+    bool isValid = true;
+    for (uint32_t i = 0; i < nodeCount && isValid; i++) {
+      // Copied out of the mapping rather than cast, to not depend on its
+      // alignment.
+      mapCacheNode node;
+      std::memcpy(&node, nodes + i * sizeof(mapCacheNode), sizeof(node));
+      for (int32_t neighbour : node.neighbours) {
+        if (neighbour < -1 
+            || static_cast<int64_t>(neighbour) >= nodeCount) {
+          isValid = false;
+        }
+      }
+      loadedNodes[i] = data::environment::Point3(node.x, node.y, 0);
+      loadedNeighbours[i] = node.neighbours;
+    }
+    if (isValid) {
+      a_nodes.swap(loadedNodes);
+      a_neighbours.swap(loadedNeighbours);
+      isLoaded = true;
+    }
+  }
+
+  munmap(memory, fileSize);
+  return isLoaded;
+}
+
+/*
+  Saves the graph under the given key, replacing any earlier file.
+*/
+bool MapCache::save(uint64_t a_key, 
+    const std::vector<data::environment::Point3> &a_nodes, 
+    const std::vector<std::array<int32_t, 4>> &a_neighbours) const
+{
+  if (a_nodes.size() != a_neighbours.size()) {
+    return false;
+  }
+
+  mapCacheHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.key = a_key;
+  header.nodeCount = static_cast<uint32_t>(a_nodes.size());
+  header.reserved = 0;
+  std::vector<char> data(sizeof(header) + a_nodes.size() 
+      * sizeof(mapCacheNode));
+  std::memcpy(data.data(), &header, sizeof(header));
+  for (uint32_t i = 0; i < a_nodes.size(); i++) {
+    mapCacheNode node;
+    node.x = a_nodes[i].getX();
+    node.y = a_nodes[i].getY();
+    node.neighbours = a_neighbours[i];
+    std::memcpy(data.data() + sizeof(header) + i * sizeof(node), &node, 
+        sizeof(node));
+  }
+
+  // A unique file next to the cache, so that navigators saving at the same
+  // time do not write into each other's file before it is renamed.
+  std::string temporaryFilename = m_filename + ".XXXXXX";
+  int const fileDescriptor = mkstemp(&temporaryFilename[0]);
+  if (fileDescriptor == -1) {
+    return false;
+  }
+  bool isWritten = (fchmod(fileDescriptor, 0644) == 0);
+  size_t written = 0;
+  while (isWritten && written < data.size()) {
+    ssize_t const count = write(fileDescriptor, data.data() + written, 
+        data.size() - written);
+    isWritten = (count > 0);
+    if (isWritten) {
+      written += static_cast<size_t>(count);
+    }
+  }
+  isWritten = (close(fileDescriptor) == 0 && isWritten);
+  if (!isWritten 
+      || std::rename(temporaryFilename.c_str(), m_filename.c_str()) != 0) {
+    std::remove(temporaryFilename.c_str());
+    return false;
+  }
+  return true;
+}
+
+}
+}
+}
@@ -0,0 +1,1032 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <cstdlib>
+#include <iostream>
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/strings/StringToolbox.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+
+#include <opendavinci/odcore/wrapper/Eigen.h>
+
+#include <odvdopendlvdata/GeneratedHeaders_ODVDOpenDLVData.h>
+#include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
+
+#include "Navigator.h"
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+
+/*
+  Constant Definitions
+*/
+
+//const double Navigator::S_W_SIDE_DETECTION = 1.6;
+//const double Navigator::S_W_FRONT_DETECTION = 1.5;
+//const double Navigator::S_W_CLOSE_FRONT_DETECTION = 1.1;
+//const double Navigator::S_I_SEARCH_MISS = 1.75;
+//const double Navigator::S_I_SEARCH_FOUND = 1.7;
+//const double Navigator::S_OUT_OF_RANGE = 1.79;
+
+
+const double Navigator::T_REVERSE = 0.7;
+const double Navigator::T_ROTATE_REVERSE = 0.2;
+const double Navigator::T_TURN = 1;
+
+
+const double Navigator::T_LPS_TIMEOUT = 1000;
+
+const int32_t Navigator::E_FORWARD = 35000;
+const int32_t Navigator::E_REVERSE = -35000;
+const int32_t Navigator::E_ROTATE_RIGHT_L = 35000;
+const int32_t Navigator::E_ROTATE_RIGHT_R = -35000;
+const int32_t Navigator::E_ROTATE_LEFT_L  = -35000;
+const int32_t Navigator::E_ROTATE_LEFT_R  = 35000;
+const int32_t Navigator::E_DYN_TURN_SPEED = 15000;
+
+//const uint32_t Navigator::E_SEARCH = 55000;
+
+
+const uint32_t Navigator::UPDATE_FREQ = 50;
+
+const uint8_t Navigator::WALL_MARGINS = 2;
+const uint8_t Navigator::NODE_SPACING = 2;
+
+
+/*
+  Default parameters, as tuned on the robot.
+*/
+navigationParameters::navigationParameters()
+    : goalTolerance(3)
+    , minPreviewLength(4)
+    , maxPreviewLength(10)
+    , turnRate(0.1)
+    , eStill(30000)
+    , eDynFollowSpeed(6000) // max 10500
+{
+}
+
+/*
+  Constructor.
+*/
+Navigator::Navigator(bool a_debug)
+    : m_outerWalls()
+    , m_innerWalls()
+    , m_pointsOfInterest()
+    , m_analogReadings()
+    , m_gpioReadings()
+    , m_gpioOutputPins()
+    , m_pwmOutputPins()
+    , m_planner()
+    , m_mapCacheFilename()
+    , m_path()
+    , m_parameters()
+    , m_posePredictor()
+    , m_usePosePredictor(false)
+
+    , m_currentState()
+    , m_lastState()
+    , m_currentModifer()
+
+    , m_t_Current()
+    , m_t_Last()
+    , m_t_LPS()
+    , m_MotorDuties()
+
+    , m_s_w_FrontLeft(0)
+    , m_s_w_FrontLeft_t()
+    , m_s_w_FrontRight(0)
+    , m_s_w_FrontRight_t()
+    , m_updateCounter(0)
+    , m_debug(a_debug)
+    , m_currentPosition(-1000,-1000,0)
+    , m_currentYaw(0)
+    , m_currentPreview()
+    , m_goToInterestPoint(0)
+    , m_goalsReached(0)
+    , m_speakerDuty(0)
+{
+  m_lastState =  navigationState::PLAN;
+  m_currentState = navigationState::PLAN;
+  m_currentModifer = stateModifier::NONE;
+  m_t_Current = odcore::data::TimeStamp();
+}
+
+/*
+  Destructor.
+*/
+Navigator::~Navigator() 
+{
+}
+
+/* 
+  Reads the pins and the map from the configuration and builds the graph.
+  All internal timers start at the given time, which is the wall-clock for
+  the module and the start of the virtual clock in simulation.
+*/
+void Navigator::setUp(const odcore::base::KeyValueConfiguration &a_kv,
+    const odcore::data::TimeStamp &a_now)
+{
+  m_t_Current = a_now;
+  m_t_Last = a_now;
+  m_t_LPS = a_now;
+  m_s_w_FrontLeft_t = a_now;
+  m_s_w_FrontRight_t = a_now;
+
+  std::string const gpioPinsString = 
+      a_kv.getValue<std::string>("logic-miniature-navigation.gpio-pins");
+  std::vector<std::string> gpioPinsVector = 
+      odcore::strings::StringToolbox::split(gpioPinsString, ',');
+  for (auto pin : gpioPinsVector) {
+    m_gpioOutputPins.push_back(std::stoi(pin)); 
+  }
+
+  std::string const pwmPinsString = 
+      a_kv.getValue<std::string>("logic-miniature-navigation.pwm-pins");
+  std::vector<std::string> pwmPinsVector = 
+      odcore::strings::StringToolbox::split(pwmPinsString, ',');
+  for (auto pin : pwmPinsVector) {
+    m_pwmOutputPins.push_back(std::stoi(pin));
+  }
+  
+  std::string const outerWallsString = 
+      a_kv.getValue<std::string>("logic-miniature-navigation.outer-walls");
+  std::vector<data::environment::Point3> outerWallPoints = ReadPointString(outerWallsString);
+  if (outerWallPoints.size() == 4) {
+    m_outerWalls.push_back(data::environment::Line(outerWallPoints[0], outerWallPoints[1]));
+    m_outerWalls.push_back(data::environment::Line(outerWallPoints[1], outerWallPoints[2]));
+    m_outerWalls.push_back(data::environment::Line(outerWallPoints[2], outerWallPoints[3]));
+    m_outerWalls.push_back(data::environment::Line(outerWallPoints[3], outerWallPoints[0]));
+
+    if (m_debug) {
+      std::cout << "Outer walls 1 - " << m_outerWalls[0].toString() <<  std::endl;
+      std::cout << "Outer walls 2 - " << m_outerWalls[1].toString() <<  std::endl;
+      std::cout << "Outer walls 3 - " << m_outerWalls[2].toString() <<  std::endl;
+      std::cout << "Outer walls 4 - " << m_outerWalls[3].toString() <<  std::endl;
+    }
+  } else {
+    std::cout << "Warning: Outer walls format error. (" << outerWallsString << ")" << std::endl;
+  }
+  
+  std::string const innerWallsString = 
+      a_kv.getValue<std::string>("logic-miniature-navigation.inner-walls");
+  std::vector<data::environment::Point3> innerWallPoints = ReadPointString(innerWallsString);
+  for (uint32_t i = 0; i < innerWallPoints.size(); i += 2) {
+    if (i < innerWallPoints.size() - 1) {
+      data::environment::Line innerWall(innerWallPoints[i], innerWallPoints[i+1]);
+      m_innerWalls.push_back(innerWall);
+      if (m_debug) {
+        std::cout << "Inner wall - " << innerWall.toString() << std::endl;
+      }
+    }
+  }
+  
+  std::string const pointsOfInterestString = 
+      a_kv.getValue<std::string>("logic-miniature-navigation.points-of-interest");
+  m_pointsOfInterest = ReadPointString(pointsOfInterestString);
+  if (m_debug) {
+    for (uint32_t i = 0; i < m_pointsOfInterest.size(); i++) {
+      std::cout << "Point of interest " << i << ": " << m_pointsOfInterest[i].toString() << std::endl;
+    }
+  }
+
+  bool valueFound;
+  double const goalTolerance = a_kv.getOptionalValue<double>(
+      "logic-miniature-navigation.goal-tolerance", valueFound);
+  if (valueFound) {
+    m_parameters.goalTolerance = goalTolerance;
+  }
+  double const minPreviewLength = a_kv.getOptionalValue<double>(
+      "logic-miniature-navigation.min-preview-length", valueFound);
+  if (valueFound) {
+    m_parameters.minPreviewLength = minPreviewLength;
+  }
+  double const maxPreviewLength = a_kv.getOptionalValue<double>(
+      "logic-miniature-navigation.max-preview-length", valueFound);
+  if (valueFound) {
+    m_parameters.maxPreviewLength = maxPreviewLength;
+  }
+  double const turnRate = a_kv.getOptionalValue<double>(
+      "logic-miniature-navigation.turn-rate", valueFound);
+  if (valueFound) {
+    m_parameters.turnRate = turnRate;
+  }
+  int32_t const eStill = a_kv.getOptionalValue<int32_t>(
+      "logic-miniature-navigation.engine-still", valueFound);
+  if (valueFound) {
+    m_parameters.eStill = eStill;
+  }
+  int32_t const eDynFollowSpeed = a_kv.getOptionalValue<int32_t>(
+      "logic-miniature-navigation.engine-dyn-follow-speed", valueFound);
+  if (valueFound) {
+    m_parameters.eDynFollowSpeed = eDynFollowSpeed;
+  }
+
+  // The predictor is off unless turned on, since its model is only
+  // calibrated for the simulation.
+  int32_t const usePosePredictor = a_kv.getOptionalValue<int32_t>(
+      "logic-miniature-navigation.predictor", valueFound);
+  if (valueFound) {
+    m_usePosePredictor = (usePosePredictor == 1);
+  }
+  double const wheelSpeed = a_kv.getOptionalValue<double>(
+      "logic-miniature-navigation.predictor-wheel-speed", valueFound);
+  if (valueFound) {
+    double const robotRadius = a_kv.getValue<double>(
+        "logic-miniature-navigation.predictor-robot-radius");
+    int32_t const minDuty = a_kv.getValue<int32_t>(
+        "logic-miniature-navigation.predictor-min-duty");
+    int32_t const maxDuty = a_kv.getValue<int32_t>(
+        "logic-miniature-navigation.predictor-max-duty");
+    m_posePredictor.setModel(wheelSpeed, robotRadius, minDuty, maxDuty);
+  }
+  double const positionGain = a_kv.getOptionalValue<double>(
+      "logic-miniature-navigation.predictor-position-gain", valueFound);
+  if (valueFound) {
+    double const yawGain = a_kv.getValue<double>(
+        "logic-miniature-navigation.predictor-yaw-gain");
+    m_posePredictor.setGains(positionGain, yawGain);
+  }
+  double const commandDelay = a_kv.getOptionalValue<double>(
+      "logic-miniature-navigation.predictor-command-delay", valueFound);
+  if (valueFound) {
+    m_posePredictor.setCommandDelay(commandDelay);
+  }
+
+  std::string const mapCacheFilename = a_kv.getOptionalValue<std::string>(
+      "logic-miniature-navigation.map-cache", valueFound);
+  if (valueFound) {
+    m_mapCacheFilename = mapCacheFilename;
+  }
+
+  createGraph();
+}
+
+/* 
+  Runs one iteration of the navigation logic at the given time and returns
+  the requests that should be sent to the actuators (if any).
+*/
+std::vector<odcore::data::Container> Navigator::step(const odcore::data::TimeStamp &a_now)
+{
+  std::vector<odcore::data::Container> containers;
+
+  //Update the current time
+  m_t_Current = a_now;
+  // 
+  decodeResolveSensors();
+
+  // Act on the pose extrapolated to when the commands take effect, rather
+  // than on the last LPS reading.
+  if (m_usePosePredictor && m_posePredictor.isInitialised()) {
+    m_posePredictor.predict(m_t_Current, m_currentPosition, m_currentYaw);
+  }
+  
+  navigationState old_state = m_currentState;
+  logicHandling();
+  std::array<int32_t, 2> motorDuties = engineHandling();
+
+  /*
+  Engine Speed update
+  */
+
+  // MotorDuties[0] is left Engine
+  // MotorDuties[1] is right Engine
+
+
+  if (m_debug) {
+    std::cout << "Motor Duty L:" << m_MotorDuties[0] << " R:" <<  m_MotorDuties[1] << std::endl;
+  }
+
+
+  if (motorDuties[0] != m_MotorDuties[0] or 
+      motorDuties[1] != m_MotorDuties[1] or 
+      old_state != m_currentState or
+      m_updateCounter > UPDATE_FREQ) {
+    
+    m_MotorDuties = motorDuties;
+    m_posePredictor.setMotorDuties(m_MotorDuties, m_t_Current);
+
+    if (old_state != m_currentState) {
+      m_lastState = m_currentState;
+      m_t_Last = m_t_Current;
+    }
+    m_updateCounter = 0;
+
+    //motorDuties[0] = 30000;
+    //motorDuties[1] = 50000;
+  
+    //Left wheel
+
+
+
+    //Power
+    opendlv::proxy::PwmRequest request1(0, abs(motorDuties[0]));
+    odcore::data::Container c1(request1);
+    c1.setSenderStamp(0);
+          
+    opendlv::proxy::ToggleRequest::ToggleState leftMotorState1;
+    opendlv::proxy::ToggleRequest::ToggleState leftMotorState2;
+     if (motorDuties[0] > 0) {
+      leftMotorState1 = opendlv::proxy::ToggleRequest::On;
+      leftMotorState2 = opendlv::proxy::ToggleRequest::Off;
+    } else {
+      leftMotorState1 = opendlv::proxy::ToggleRequest::Off;
+      leftMotorState2 = opendlv::proxy::ToggleRequest::On;
+    }
+
+    //Set the direction
+    opendlv::proxy::ToggleRequest requestGpio3(60, leftMotorState1);
+    odcore::data::Container c5(requestGpio3);
+    opendlv::proxy::ToggleRequest requestGpio4(51, leftMotorState2);
+    odcore::data::Container c6(requestGpio4);
+
+
+    //Right wheel
+
+    //Power
+    opendlv::proxy::PwmRequest request2(0, abs(motorDuties[1]));
+    odcore::data::Container c2(request2);
+    c2.setSenderStamp(2);
+
+
+    // Set direction
+    opendlv::proxy::ToggleRequest::ToggleState rightMotorState1;
+    opendlv::proxy::ToggleRequest::ToggleState rightMotorState2;
+
+    if (motorDuties[1] > 0) {
+      rightMotorState1 = opendlv::proxy::ToggleRequest::On;
+      rightMotorState2 = opendlv::proxy::ToggleRequest::Off;
+    } else {
+      rightMotorState1 = opendlv::proxy::ToggleRequest::Off;
+      rightMotorState2 = opendlv::proxy::ToggleRequest::On;
+    }
+
+    opendlv::proxy::ToggleRequest requestGpio1(30, rightMotorState1);
+    odcore::data::Container c3(requestGpio1);
+    opendlv::proxy::ToggleRequest requestGpio2(31, rightMotorState2);
+    odcore::data::Container c4(requestGpio2);
+
+    opendlv::proxy::PwmRequest requestSpeaker(0, m_speakerDuty);
+    odcore::data::Container cSpeak(requestSpeaker);
+    cSpeak.setSenderStamp(3);
+
+    //Send the data
+    containers.push_back(c1);
+    containers.push_back(c2);
+    containers.push_back(c3);
+    containers.push_back(c4);
+    containers.push_back(c5);
+    containers.push_back(c6);
+    containers.push_back(cSpeak);
+
+  } else {
+    m_updateCounter += 1;
+  }
+
+  return containers;
+}
+
+void Navigator::decodeResolveSensors()
+{
+  m_s_w_FrontRight = m_gpioReadings[49];
+  if (m_s_w_FrontRight) {
+    m_s_w_FrontLeft_t = m_t_Current;
+  }
+  m_s_w_FrontLeft  = m_gpioReadings[48];
+  if (m_s_w_FrontLeft) {
+    m_s_w_FrontLeft_t = m_t_Current;
+  }
+
+}
+
+
+
+  void Navigator::logicHandling() 
+  {
+    std::string state = "";
+    std::string outState = "";
+    std::string comment = "";
+
+    double t1 = 0;
+    double t2 = 0;
+    std::vector<double> v;
+
+
+    switch(m_currentState) { 
+      case navigationState::REVERSE:
+        state = "REVERSE";
+
+
+        t1 = static_cast<double>(m_t_Current.toMicroseconds() - m_s_w_FrontLeft_t.toMicroseconds()) / 1000000.0;
+        t2 = static_cast<double>(m_t_Current.toMicroseconds() - m_s_w_FrontRight_t.toMicroseconds()) / 1000000.0;
+        v.push_back(t1);
+        v.push_back(t2);
+
+        if (modifierHandling(v, T_TURN)) 
+        {
+          if (t1 > t2) {
+            outState = "ROTATE_RIGHT";
+            m_currentState = navigationState::ROTATE_RIGHT;
+          } else {
+            outState = "ROTATE_LEFT";
+            m_currentState = navigationState::ROTATE_LEFT;
+          }
+        }
+        //TODO: logic for US
+        break;
+
+      case navigationState::ROTATE_RIGHT:
+        state = "ROTATE_RIGHT";
+
+        if (modifierHandling(m_t_Last, T_TURN))
+        {
+          if (!m_s_w_FrontRight && !m_s_w_FrontLeft) {
+            outState = "FOLLOW";
+            m_currentState = navigationState::FOLLOW; 
+          } else if (m_s_w_FrontRight && m_s_w_FrontLeft) {
+            outState = "REVERSE";
+            m_currentState = navigationState::REVERSE; 
+          }
+        }
+        //TODO: logic for US
+        break;
+
+      case navigationState::ROTATE_LEFT:
+        state = "ROTATE_LEFT";
+        if (modifierHandling(m_t_Last, T_TURN))
+        {
+          if(!m_s_w_FrontRight && !m_s_w_FrontLeft) {
+              outState = "FOLLOW";
+              m_currentState = navigationState::FOLLOW;
+          } else if (m_s_w_FrontRight && m_s_w_FrontLeft) {
+            outState = "REVERSE";
+            m_currentState = navigationState::REVERSE; 
+          }
+        }
+        //TODO: logic for US
+        break;
+
+      case navigationState::PLAN:
+        state = "PLAN";
+        if (m_updateCounter == 1) {
+          calculatePath();
+
+          if (m_debug) {
+            for (auto node : m_path){
+                std::cout << "Path:" << node.toString() << std::endl; 
+
+            }
+          }
+        } else if (m_updateCounter > 1 && !m_path.empty()) {
+          outState = "FOLLOW";
+          m_currentState = navigationState::FOLLOW;
+        }
+        break;
+
+      case navigationState::FOLLOW:
+        state = "FOLLOW";
+
+        if (m_s_w_FrontLeft && m_s_w_FrontRight) {
+          outState = "REVERSE";
+          m_currentState = navigationState::REVERSE;
+          m_currentModifer = stateModifier::DELAY;
+
+        } else if (m_s_w_FrontRight) {
+          outState = "ROTATE_LEFT";
+          m_currentState = navigationState::REVERSE;
+          m_currentModifer = stateModifier::DELAY;
+
+        } else if (m_s_w_FrontLeft) {
+          outState = "ROTATE_RIGHT";
+          m_currentState = navigationState::REVERSE;
+          m_currentModifer = stateModifier::DELAY;
+        }
+        //TODO: logic for ultrasound
+        //TODO: logic for pathplanning if too far from path
+        break;
+
+      default:
+        state = "UNKOWN";
+        outState = "PLAN";
+        m_currentState = navigationState::PLAN;
+        break;
+    }
+
+    if (m_debug){
+      if(m_currentModifer == stateModifier::DELAY) {
+        std::cout << "[NAVSTATE:" << state << "(DELAY):" << outState << "]" << std::endl;
+      } else {
+        std::cout << "[NAVSTATE:" << state << ":" << outState << "]" << std::endl;
+      }
+    }
+
+  }
+  void Navigator::pathPlanning() {
+    return;
+  }
+
+  /*
+  * engineHandling returns the engine values to be set
+  *
+  * It returns the duty cycle values for the engines
+  * depending on the state and other factors
+  * 
+  */
+  std::array<int32_t, 2> Navigator::engineHandling(){
+    std::array<int32_t, 2> out;
+    double t2 = 0;
+    out[0] = 0;
+    out[1] = 0;
+
+    switch(m_currentState) {
+      case navigationState::REVERSE:
+        out[0] = E_REVERSE;
+        out[1] = E_REVERSE;
+        break;
+
+      case navigationState::ROTATE_RIGHT:
+        out[0]  = E_ROTATE_RIGHT_L;
+        out[1] = E_ROTATE_RIGHT_R;
+        break;
+
+      case navigationState::ROTATE_LEFT:
+        out[0]  = E_ROTATE_LEFT_L;
+        out[1] = E_ROTATE_LEFT_R;
+        break;
+
+      case navigationState::FOLLOW:
+        t2 = static_cast<double>(m_t_Current.toMicroseconds() - m_t_LPS.toMicroseconds()) / 1000000.0;
+        if (t2 > T_LPS_TIMEOUT) {
+          out = forward();
+        } else {
+          out = followPreview();
+        }
+        break;
+
+      case navigationState::PLAN:
+        out[0] = 0;
+        out[1] = 0;
+        break;
+    }
+
+    return out;
+
+
+  }
+
+  //Handles the engine logic to follow the preview point
+  std::array<int32_t,2> Navigator::followPreview() {
+    std::array<int32_t, 2> out;
+    out[0] = 0;
+    out[1] = 0;    
+    double deltaDiff1 = 0;
+    double deltaDiff2 = 0;
+    double delta = 0;
+    double length = 0;
+
+    int it = 0;
+    data::environment::Point3 preview;
+
+    while(true) {
+      preview = m_path[m_currentPreview];
+      data::environment::Point3 diff = preview - m_currentPosition;
+      length = diff.length();
+
+       if (m_path.back().getDistanceTo(m_currentPosition) < m_parameters.goalTolerance){
+          m_goalsReached++;
+          if (m_goToInterestPoint == 0) {
+            m_goToInterestPoint = 2;
+          } else {
+            m_goToInterestPoint = 0;
+          }
+          m_currentState = navigationState::PLAN;
+          return out;
+      }
+          
+      if (length > m_parameters.maxPreviewLength || it > 1000) {
+        //m_currentPreview = 0;
+        m_currentState = navigationState::PLAN;
+        return out;
+      } else if(length > m_parameters.minPreviewLength || m_currentPreview == (m_path.size() - 1)) {
+          deltaDiff1 = (diff.getAngleXY() - m_currentYaw);
+          deltaDiff2 = (deltaDiff1/abs(deltaDiff1))*(abs(deltaDiff1) -2*M_PI);
+
+          delta = m_parameters.turnRate * (abs(deltaDiff1) < abs(deltaDiff2) ? deltaDiff1 : deltaDiff2); 
+
+        if (m_debug) {
+          std::cout << "Delta:" << delta << ";" << length << ";" << diff.getAngleXY() << ";" << m_currentYaw << ";" << m_currentPreview << ";" << m_path.size() - 1 << std::endl;
+        }
+        break;
+      } else {
+        m_currentPreview = m_currentPreview + 1;
+      }
+    }
+
+    // max forward = 360000
+    //  15000 < out < 360000
+
+    out[0] = m_parameters.eStill + m_parameters.eDynFollowSpeed * (1 - delta);
+    out[1] = m_parameters.eStill + m_parameters.eDynFollowSpeed * (1 + delta);
+    if (m_debug) {
+      std::cout << "[NAVSTATE:" << m_path[m_path.size()-1].toString() << " P: " << preview.toString() << " L:" << out[0] << " R:" << out[1] << std::endl;
+    }
+    return out;
+
+  }
+
+
+  std::array<int32_t,2> Navigator::forward() {
+    std::array<int32_t, 2> out;
+    out[0] = E_FORWARD;
+    out[1] = E_FORWARD;
+    return out;
+  }
+
+
+
+  //Different versions of modifierHandling
+  
+  bool Navigator::modifierHandling(const std::vector<double> &since, const std::vector<double> &until) 
+  {
+    if (m_currentModifer == stateModifier::NONE) {
+      return true;
+
+    } else if (m_currentModifer == stateModifier::DELAY) {
+      if (since.size() != until.size()) {
+        return false;
+      }
+
+      for(uint i=0; i < since.size(); i++){
+        if (since[i] <= until[i]) {
+          return false;
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool Navigator::modifierHandling(const std::vector<odcore::data::TimeStamp> &since, const std::vector<double> &until) 
+  {
+    if (m_currentModifer == stateModifier::NONE) {
+      return true;
+
+    } else if (m_currentModifer == stateModifier::DELAY) {
+      if (since.size() != until.size()) {
+        return false;
+      }
+
+      for(uint i=0; i < since.size(); i++){
+        double t = static_cast<double>(m_t_Current.toMicroseconds() - since[i].toMicroseconds()) / 1000000.0;
+        if (t <= until[i]) {
+          return false;
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+  
+  bool Navigator::modifierHandling(const std::vector<double> &since, const double &until)
+  {
+    if (m_currentModifer == stateModifier::NONE) {
+      return true;
+
+    } else if (m_currentModifer == stateModifier::DELAY) {
+
+      for(uint i=0; i < since.size(); i++){
+        if (since[i] <= until) {
+          return false;
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool Navigator::modifierHandling(const std::vector<odcore::data::TimeStamp> &since, const double &until)
+  {
+    if (m_currentModifer == stateModifier::NONE) {
+      return true;
+
+    } else if (m_currentModifer == stateModifier::DELAY) {
+
+      for(uint i=0; i < since.size(); i++){
+        double t = static_cast<double>(m_t_Current.toMicroseconds() - since[i].toMicroseconds()) / 1000000.0;
+        if (t <= until) {
+          return false;
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool Navigator::modifierHandling(const odcore::data::TimeStamp &since, const double &until)
+  {
+    double t = static_cast<double>(m_t_Current.toMicroseconds() - since.toMicroseconds()) / 1000000.0;
+    return modifierHandling(t, until);
+  }
+
+  bool Navigator::modifierHandling(const double &since, const double &until){
+    if (m_currentModifer == stateModifier::NONE) {
+      return true;
+
+    } else if (m_currentModifer == stateModifier::DELAY) {
+      if (since > until) {
+        return true;
+      }
+
+    }
+    return false;
+  }
+
+
+
+/* 
+  This method receives messages from all other modules (in the same conference 
+  id, cid). Here, the messages AnalogReading and ToggleReading is received
+  from the modules interfacing to the hardware. The time of the last State is
+  taken from the container, so that it follows the clock of the sender.
+*/
+void Navigator::nextContainer(odcore::data::Container &a_c)
+{
+  int32_t dataType = a_c.getDataType();
+  if (dataType == opendlv::proxy::AnalogReading::ID()) {
+    opendlv::proxy::AnalogReading reading = 
+        a_c.getData<opendlv::proxy::AnalogReading>();
+
+    uint16_t pin = reading.getPin();
+    float voltage = reading.getVoltage();
+
+    m_analogReadings[pin] = voltage; // Save the input to the class global map.
+
+    if (m_debug) {
+      std::cout << "[logic-miniature-navigation] Received an AnalogReading: " 
+          << reading.toString() << "." << std::endl;
+    }
+
+  } else if (dataType == opendlv::proxy::ToggleReading::ID()) {
+    opendlv::proxy::ToggleReading reading = 
+        a_c.getData<opendlv::proxy::ToggleReading>();
+
+    uint16_t pin = reading.getPin();
+    bool state;
+    if (reading.getState() == opendlv::proxy::ToggleReading::On) {
+      state = true;
+    } else {
+      state = false;
+    }
+
+    m_gpioReadings[pin] = state; // Save the state to the class global map.
+
+    if (m_debug) {
+      std::cout << "[logic-miniature-navigation] Received a ToggleReading: "
+          << reading.toString() << "." << std::endl;
+    }
+  } else if (dataType == opendlv::model::State::ID()) {
+    opendlv::model::State state = 
+        a_c.getData<opendlv::model::State>();
+
+    double positionX = static_cast<double>(state.getPosition().getX());
+    double positionY = static_cast<double>(state.getPosition().getY());
+    double yaw = static_cast<double>(state.getAngularDisplacement().getZ());
+
+    m_currentPosition = data::environment::Point3(positionX, positionY, 0);
+    m_currentYaw = yaw;
+    m_t_LPS = a_c.getReceivedTimeStamp();
+    m_posePredictor.correct(m_currentPosition, m_currentYaw, m_t_LPS);
+
+
+    if (m_debug) {
+      std::cout << "[logic-miniature-navigation] Received a State: position "
+          << positionX << ", " << positionY << " yaw " << yaw << "." << std::endl;
+    }
+  }
+}
+
+navigationParameters Navigator::getParameters() const
+{
+  return m_parameters;
+}
+
+void Navigator::setParameters(const navigationParameters &a_parameters)
+{
+  m_parameters = a_parameters;
+}
+
+std::vector<data::environment::Line> Navigator::getWalls() const
+{
+  std::vector<data::environment::Line> walls(m_outerWalls);
+  walls.insert(walls.end(), m_innerWalls.begin(), m_innerWalls.end());
+  return walls;
+}
+
+std::vector<data::environment::Point3> Navigator::getPointsOfInterest() const
+{
+  return m_pointsOfInterest;
+}
+
+uint32_t Navigator::getGoalsReached() const
+{
+  return m_goalsReached;
+}
+
+std::vector<data::environment::Point3> Navigator::ReadPointString(std::string const &a_pointsString) const
+{
+  std::vector<data::environment::Point3> points;
+  std::vector<std::string> pointStringVector = 
+      odcore::strings::StringToolbox::split(a_pointsString, ';');
+  for (auto pointString : pointStringVector) {
+    std::vector<std::string> coordinateVector = 
+        odcore::strings::StringToolbox::split(pointString, ',');
+    if (coordinateVector.size() == 2) {
+      double x = std::stod(coordinateVector[0]);
+      double y = std::stod(coordinateVector[1]);
+      double z = 0.0;
+      points.push_back(data::environment::Point3(x, y, z));
+    }
+  }
+  return points;
+}
+
+void Navigator::createGraph(void){
+
+    // A graph cached from an earlier start with the same map is used as it
+    // is, which makes a restart close to instant.
+    uint64_t const mapKey = getMapKey();
+    MapCache mapCache(m_mapCacheFilename);
+    if (!m_mapCacheFilename.empty()) {
+      std::vector<data::environment::Point3> cachedNodes;
+      std::vector<std::array<int32_t, 4>> cachedNeighbours;
+      if (mapCache.load(mapKey, cachedNodes, cachedNeighbours)) {
+        m_planner.setGraph(cachedNodes, cachedNeighbours, NODE_SPACING);
+        m_path.reserve(cachedNodes.size());
+        if (m_debug) {
+          std::cout << "Loaded " << cachedNodes.size() << " nodes from " 
+              << m_mapCacheFilename << std::endl;
+        }
+        return;
+      }
+    }
+
+    //data::environment::Point3 pointX(WALL_MARGINS, 0, 0);
+    //data::environment::Point3 pointY(0, WALL_MARGINS, 0);
+
+    std::vector<std::array<float, 4>> inWallLimits;
+    std::array<float, 4> inWallLimit = {{0, 0, 0, 0}};
+    std::array<float, 4> outWallLimit = {{0, 0, 0, 0}};
+    int t = 0;
+
+    for (auto lineInner : m_innerWalls) {
+      inWallLimit[0] = ((lineInner.getA().getX()+WALL_MARGINS) > (lineInner.getB().getX()+WALL_MARGINS)) ? (lineInner.getA().getX()+WALL_MARGINS) : (lineInner.getB().getX()+WALL_MARGINS);
+      inWallLimit[1] = ((lineInner.getA().getX()-WALL_MARGINS) < (lineInner.getB().getX()-WALL_MARGINS)) ? (lineInner.getA().getX()-WALL_MARGINS) : (lineInner.getB().getX()-WALL_MARGINS);
+      inWallLimit[2] = ((lineInner.getA().getY()+WALL_MARGINS) > (lineInner.getB().getY()+WALL_MARGINS)) ? (lineInner.getA().getY()+WALL_MARGINS) : (lineInner.getB().getY()+WALL_MARGINS);
+      inWallLimit[3] = ((lineInner.getA().getY()-WALL_MARGINS) < (lineInner.getB().getY()-WALL_MARGINS)) ? (lineInner.getA().getY()-WALL_MARGINS) : (lineInner.getB().getY()-WALL_MARGINS);
+
+      inWallLimits.push_back(inWallLimit);
+      if (m_debug) {
+        std::cout << "innerWalls:" << inWallLimit[0] << ","<< inWallLimit[1] << ","<< inWallLimit[2] << ","<< inWallLimit[3] << std::endl;
+      }
+
+      t++;
+    }
+
+    t = 1;
+
+    for (auto lineOuter : m_outerWalls) {
+      switch(t){
+        case 1:
+          outWallLimit[2] = ((lineOuter.getA().getY()+WALL_MARGINS) > (lineOuter.getB().getY()+WALL_MARGINS)) ? (lineOuter.getA().getY()+WALL_MARGINS) : (lineOuter.getB().getY()+WALL_MARGINS);
+          break;
+        case 2:
+          outWallLimit[0] = ((lineOuter.getA().getX()+WALL_MARGINS) > (lineOuter.getB().getX()+WALL_MARGINS)) ? (lineOuter.getA().getX()+WALL_MARGINS) : (lineOuter.getB().getX()+WALL_MARGINS);
+          break;
+        case 3:
+          outWallLimit[3] = ((lineOuter.getA().getY()-WALL_MARGINS) < (lineOuter.getB().getY()-WALL_MARGINS)) ? (lineOuter.getA().getY()-WALL_MARGINS) : (lineOuter.getB().getY()-WALL_MARGINS);
+          break;
+        case 4:
+          outWallLimit[1] = ((lineOuter.getA().getX()-WALL_MARGINS) < (lineOuter.getB().getX()-WALL_MARGINS)) ? (lineOuter.getA().getX()-WALL_MARGINS) : (lineOuter.getB().getX()-WALL_MARGINS);
+          break;
+        default:
+          break;
+    }
+     
+      t++;
+    }
+      if (m_debug) {
+        std::cout << "OuterWalls:" << outWallLimit[0] << ","<< outWallLimit[1] << ","<< outWallLimit[2] << ","<< outWallLimit[3] << std::endl;
+      }
+
+      t = 1;
+      bool blocked = false;
+      data::environment::Point3 currentNode(0, 0, 0);
+      std::vector<data::environment::Point3> nodes;
+
+      for (double yNodes = round((double) outWallLimit[2]+0.5);  yNodes < round((double) outWallLimit[3]+0.5); yNodes += NODE_SPACING){
+        for (double xNodes = round((double) outWallLimit[0]+0.5); xNodes < round((double) outWallLimit[1]+0.5); xNodes += NODE_SPACING){
+            blocked = false;
+            for(auto innerArray : inWallLimits){
+              if (xNodes < (double) innerArray[0] && xNodes > (double) innerArray[1] && yNodes < (double) innerArray[2] && yNodes > (double) innerArray[3]){
+                  blocked = true;
+                  break;
+              }
+        
+            }
+            
+            if (!blocked){
+              currentNode.setX(xNodes);
+              currentNode.setY(yNodes);
+              nodes.push_back(currentNode);
+
+              //std::cout << "Nodes" << currentNode.toString() << std::endl;
+              t++;
+            }
+         }
+      }
+
+      // The path buffer is sized for the longest possible path, so that
+      // planning never allocates.
+      m_planner.setNodes(nodes, NODE_SPACING);
+      m_path.reserve(nodes.size());
+
+      if (!m_mapCacheFilename.empty() && !mapCache.save(mapKey, 
+            m_planner.getNodes(), m_planner.getNeighbours())) {
+        std::cerr << "[logic-miniature-navigation] Could not write the map cache " 
+            << m_mapCacheFilename << std::endl;
+      }
+}
+
+/*
+  A hash of everything the graph is built from. The walls are hashed as
+  parsed numbers, so formatting changes in the configuration do not
+  invalidate the cache.
+*/
+uint64_t Navigator::getMapKey() const
+{
+  uint64_t key = 14695981039346656037ull;
+  key = MapCache::hash(&WALL_MARGINS, sizeof(WALL_MARGINS), key);
+  key = MapCache::hash(&NODE_SPACING, sizeof(NODE_SPACING), key);
+  std::vector<data::environment::Line> const walls = getWalls();
+  uint32_t const wallCount = static_cast<uint32_t>(walls.size());
+  uint32_t const outerWallCount = static_cast<uint32_t>(m_outerWalls.size());
+  key = MapCache::hash(&wallCount, sizeof(wallCount), key);
+  key = MapCache::hash(&outerWallCount, sizeof(outerWallCount), key);
+  for (auto const &wall : walls) {
+    double const coordinates[4] = {wall.getA().getX(), wall.getA().getY(), 
+        wall.getB().getX(), wall.getB().getY()};
+    key = MapCache::hash(coordinates, sizeof(coordinates), key);
+  }
+  return key;
+}
+
+void Navigator::calculatePath(){
+    bool const isReachable = m_planner.plan(m_currentPosition, 
+        m_pointsOfInterest.at(m_goToInterestPoint), m_path);
+    m_currentPreview = 0;
+
+    if (m_debug) {
+      if (!isReachable) {
+        std::cout << "No path to point of interest " 
+            << static_cast<uint32_t>(m_goToInterestPoint) << std::endl;
+      } else {
+        std::cout << "startNode:" << m_path.front().toString() << std::endl;
+        std::cout << "stopNode:" << m_path.back().toString() << std::endl;
+      }
+    }
+
+    // Without a path the navigator stays in PLAN, and tries the other goal
+    // when it plans again, instead of following the start node alone.
+    if (!isReachable) {
+      m_path.clear();
+      if (m_goToInterestPoint == 0) {
+        m_goToInterestPoint = 2;
+      } else {
+        m_goToInterestPoint = 0;
+      }
+    }
+}
+
+
+}
+}
+}
@@ -0,0 +1,221 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <algorithm>
+#include <functional>
+
+#include "PathPlanner.h"
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+/*
+  Constructor.
+*/
+PathPlanner::PathPlanner()
+    : m_nodes()
+    , m_neighbours()
+    , m_cost()
+    , m_parent()
+    , m_costGeneration()
+    , m_closedGeneration()
+    , m_open()
+    , m_generation(0)
+    , m_edgeCost(2)
+{
+}
+
+/*
+  Destructor.
+*/
+PathPlanner::~PathPlanner()
+{
+}
+
+/*
+  Sets the free nodes of a grid with the given spacing. Nodes one spacing
+  apart along x or y are neighbours.
+*/
+void PathPlanner::setNodes(const std::vector<data::environment::Point3> &a_nodes, 
+    double a_spacing)
+{
+  uint32_t const nodeCount = static_cast<uint32_t>(a_nodes.size());
+  std::array<int32_t, 4> const noNeighbours = {{-1, -1, -1, -1}};
+  std::vector<std::array<int32_t, 4>> neighbours(nodeCount, noNeighbours);
+  for (uint32_t i = 0; i < nodeCount; i++) {
+    data::environment::Point3 const candidates[4] = {
+        a_nodes[i] - data::environment::Point3(a_spacing, 0, 0),
+        a_nodes[i] + data::environment::Point3(a_spacing, 0, 0),
+        a_nodes[i] - data::environment::Point3(0, a_spacing, 0),
+        a_nodes[i] + data::environment::Point3(0, a_spacing, 0)};
+    for (uint32_t j = 0; j < nodeCount; j++) {
+      for (uint32_t k = 0; k < 4; k++) {
+        if (a_nodes[j] == candidates[k]) {
+          neighbours[i][k] = static_cast<int32_t>(j);
+        }
+      }
+    }
+  }
+  setGraph(a_nodes, neighbours, a_spacing);
+}
+
+/*
+  Sets the nodes together with their already known neighbours, -1 marks a
+  missing neighbour. This is the only place where memory is allocated.
+*/
+void PathPlanner::setGraph(const std::vector<data::environment::Point3> &a_nodes, 
+    const std::vector<std::array<int32_t, 4>> &a_neighbours, double a_spacing)
+{
+  uint32_t const nodeCount = static_cast<uint32_t>(a_nodes.size());
+  m_nodes = a_nodes;
+  m_neighbours = a_neighbours;
+  m_edgeCost = static_cast<int32_t>(a_spacing);
+
+  m_cost.assign(nodeCount, 0);
+  m_parent.assign(nodeCount, -1);
+  m_costGeneration.assign(nodeCount, 0);
+  m_closedGeneration.assign(nodeCount, 0);
+  m_open.clear();
+  m_open.reserve(4 * nodeCount + 1);
+  m_generation = 0;
+}
+
+const std::vector<data::environment::Point3> &PathPlanner::getNodes() const
+{
+  return m_nodes;
+}
+
+const std::vector<std::array<int32_t, 4>> &PathPlanner::getNeighbours() const
+{
+  return m_neighbours;
+}
+
+/*
+  Plans from the node closest to the start to the node closest to the goal.
+  The path is written to the given vector, which does not allocate as long
+  as its capacity is at least the number of nodes. Equal costs are expanded
+  in node order, so the path is the same as from a plain Dijkstra search
+  over the node list. If the goal cannot be reached the path is only the
+  start node, and if there are no nodes it is empty.
+*/
+bool PathPlanner::plan(const data::environment::Point3 &a_start, 
+    const data::environment::Point3 &a_goal, 
+    std::vector<data::environment::Point3> &a_path)
+{
+  a_path.clear();
+  if (m_nodes.empty()) {
+    return false;
+  }
+
+  nextGeneration();
+  int32_t const start = getClosestNode(a_start);
+  int32_t const goal = getClosestNode(a_goal);
+
+  m_cost[start] = 0;
+  m_parent[start] = -1;
+  m_costGeneration[start] = m_generation;
+  m_open.clear();
+  m_open.push_back(std::make_pair(0, start));
+
+  std::greater<std::pair<int32_t, int32_t>> const isLater;
+  while (!m_open.empty()) {
+    std::pop_heap(m_open.begin(), m_open.end(), isLater);
+    int32_t const current = m_open.back().second;
+    m_open.pop_back();
+    if (m_closedGeneration[current] == m_generation) {
+      continue;
+    }
+    m_closedGeneration[current] = m_generation;
+    if (current == goal) {
+      break;
+    }
+
+    for (int32_t const neighbour : m_neighbours[current]) {
+      if (neighbour < 0 || m_closedGeneration[neighbour] == m_generation) {
+        continue;
+      }
+      int32_t const cost = m_cost[current] + m_edgeCost;
+      if (m_costGeneration[neighbour] != m_generation 
+          || cost < m_cost[neighbour]) {
+        m_cost[neighbour] = cost;
+        m_parent[neighbour] = current;
+        m_costGeneration[neighbour] = m_generation;
+        m_open.push_back(std::make_pair(cost, neighbour));
+        std::push_heap(m_open.begin(), m_open.end(), isLater);
+      }
+    }
+  }
+
+  if (m_closedGeneration[goal] != m_generation) {
+    a_path.push_back(m_nodes[start]);
+    return false;
+  }
+
+  // Count the nodes first, so that the path can be written in order from
+  // the start without reversing it.
+  uint32_t length = 0;
+  for (int32_t i = goal; i >= 0; i = m_parent[i]) {
+    length++;
+  }
+  a_path.resize(length);
+  for (int32_t i = goal; i >= 0; i = m_parent[i]) {
+    length--;
+    a_path[length] = m_nodes[i];
+  }
+  return true;
+}
+
+uint32_t PathPlanner::getNodeCount() const
+{
+  return static_cast<uint32_t>(m_nodes.size());
+}
+
+int32_t PathPlanner::getClosestNode(const data::environment::Point3 &a_point) 
+    const
+{
+  int32_t closest = 0;
+  double closestDistance = 1000;
+  for (uint32_t i = 0; i < m_nodes.size(); i++) {
+    double const distance = m_nodes[i].getDistanceTo(a_point);
+    if (distance < closestDistance) {
+      closest = static_cast<int32_t>(i);
+      closestDistance = distance;
+    }
+  }
+  return closest;
+}
+
+/*
+  Invalidates the search state of all nodes. The arrays are only cleared
+  when the generation counter wraps around.
+*/
+void PathPlanner::nextGeneration()
+{
+  m_generation++;
+  if (m_generation == 0) {
+    std::fill(m_costGeneration.begin(), m_costGeneration.end(), 0);
+    std::fill(m_closedGeneration.begin(), m_closedGeneration.end(), 0);
+    m_generation = 1;
+  }
+}
+
+}
+}
+}
@@ -0,0 +1,209 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <cmath>
+#include <cstdlib>
+
+#include "PosePredictor.h"
+
+namespace opendlv {
+namespace logic {
+namespace miniature {
+
+/*
+  Constructor. The default model is the one of the simulated robot, with the
+  positions in the units of the map.
+*/
+PosePredictor::PosePredictor()
+    : m_wheelSpeed(6.0)
+    , m_robotRadius(1.2)
+    , m_minDuty(25000)
+    , m_maxDuty(50000)
+    , m_positionGain(0.8)
+    , m_yawGain(0.8)
+    , m_commandDelay(0)
+    , m_velocity(0.0)
+    , m_yawRate(0.0)
+    , m_positionX(0.0)
+    , m_positionY(0.0)
+    , m_yaw(0.0)
+    , m_time(0)
+    , m_isInitialised(false)
+{
+}
+
+/*
+  Destructor.
+*/
+PosePredictor::~PosePredictor()
+{
+}
+
+/*
+  The wheel speed at the maximum duty, the distance from the centre of the
+  robot to a wheel, and the duty range between standing still and full
+  speed.
+*/
+void PosePredictor::setModel(double a_wheelSpeed, double a_robotRadius, 
+    int32_t a_minDuty, int32_t a_maxDuty)
+{
+  m_wheelSpeed = a_wheelSpeed;
+  m_robotRadius = a_robotRadius;
+  m_minDuty = a_minDuty;
+  m_maxDuty = a_maxDuty;
+}
+
+/*
+  How much of the difference between the predicted pose and a measurement
+  that is corrected at each measurement. A gain of one trusts the LPS fully
+  and a gain of zero ignores it.
+*/
+void PosePredictor::setGains(double a_positionGain, double a_yawGain)
+{
+  m_positionGain = a_positionGain;
+  m_yawGain = a_yawGain;
+}
+
+/*
+  The time in seconds from a command is given until the robot acts on it.
+*/
+void PosePredictor::setCommandDelay(double a_commandDelay)
+{
+  m_commandDelay = static_cast<int64_t>(a_commandDelay * 1000000.0);
+}
+
+/*
+  The duties sent to the left and the right motor, a negative duty means
+  that the motor is reversed.
+*/
+void PosePredictor::setMotorDuties(const std::array<int32_t, 2> &a_duties, 
+    const odcore::data::TimeStamp &a_time)
+{
+  if (m_isInitialised) {
+    propagate(a_time.toMicroseconds());
+  }
+  double const leftSpeed = getWheelSpeed(a_duties[0]);
+  double const rightSpeed = getWheelSpeed(a_duties[1]);
+  m_velocity = (leftSpeed + rightSpeed) / 2.0;
+  m_yawRate = (rightSpeed - leftSpeed) / (2.0 * m_robotRadius);
+}
+
+/*
+  Blends in a measured pose. The first measurement is taken as it is. A
+  measurement that is older than the predicted pose, for example when the
+  duties were changed after it was taken, is first moved forward in time
+  with the current motion.
+*/
+void PosePredictor::correct(const data::environment::Point3 &a_position, 
+    double a_yaw, const odcore::data::TimeStamp &a_time)
+{
+  int64_t const time = a_time.toMicroseconds();
+  if (!m_isInitialised) {
+    m_positionX = a_position.getX();
+    m_positionY = a_position.getY();
+    m_yaw = a_yaw;
+    m_time = time;
+    m_isInitialised = true;
+    return;
+  }
+
+  double measuredX = a_position.getX();
+  double measuredY = a_position.getY();
+  double measuredYaw = a_yaw;
+  if (time > m_time) {
+    propagate(time);
+  } else {
+    integrate(static_cast<double>(m_time - time) / 1000000.0, measuredX, 
+        measuredY, measuredYaw);
+  }
+
+  double const yawError = 
+      std::atan2(std::sin(measuredYaw - m_yaw), std::cos(measuredYaw - m_yaw));
+  m_positionX += m_positionGain * (measuredX - m_positionX);
+  m_positionY += m_positionGain * (measuredY - m_positionY);
+  m_yaw = std::atan2(std::sin(m_yaw + m_yawGain * yawError), 
+      std::cos(m_yaw + m_yawGain * yawError));
+}
+
+/*
+  The pose at the given time plus the command delay.
+*/
+void PosePredictor::predict(const odcore::data::TimeStamp &a_time, 
+    data::environment::Point3 &a_position, double &a_yaw) const
+{
+  double positionX = m_positionX;
+  double positionY = m_positionY;
+  double yaw = m_yaw;
+  int64_t const time = a_time.toMicroseconds() + m_commandDelay;
+  if (time > m_time) {
+    integrate(static_cast<double>(time - m_time) / 1000000.0, positionX, 
+        positionY, yaw);
+  }
+  a_position = data::environment::Point3(positionX, positionY, 0);
+  a_yaw = std::atan2(std::sin(yaw), std::cos(yaw));
+}
+
+bool PosePredictor::isInitialised() const
+{
+  return m_isInitialised;
+}
+
+double PosePredictor::getWheelSpeed(int32_t a_duty) const
+{
+  double const range = static_cast<double>(m_maxDuty - m_minDuty);
+  if (range <= 0.0) {
+    return 0.0;
+  }
+  double fraction = static_cast<double>(std::abs(a_duty) - m_minDuty) / range;
+  fraction = (fraction < 0.0) ? 0.0 : fraction;
+  fraction = (fraction > 1.0) ? 1.0 : fraction;
+  return (a_duty < 0) ? -m_wheelSpeed * fraction : m_wheelSpeed * fraction;
+}
+
+/*
+  Moves a pose along the arc given by the current velocity and yaw rate.
+*/
+void PosePredictor::integrate(double a_deltaTime, double &a_positionX, 
+    double &a_positionY, double &a_yaw) const
+{
+  double const deltaYaw = m_yawRate * a_deltaTime;
+  if (std::abs(deltaYaw) < 1e-6) {
+    a_positionX += m_velocity * std::cos(a_yaw) * a_deltaTime;
+    a_positionY += m_velocity * std::sin(a_yaw) * a_deltaTime;
+  } else {
+    double const radius = m_velocity / m_yawRate;
+    a_positionX += radius * (std::sin(a_yaw + deltaYaw) - std::sin(a_yaw));
+    a_positionY -= radius * (std::cos(a_yaw + deltaYaw) - std::cos(a_yaw));
+  }
+  a_yaw += deltaYaw;
+}
+
+void PosePredictor::propagate(int64_t a_time)
+{
+  if (a_time > m_time) {
+    integrate(static_cast<double>(a_time - m_time) / 1000000.0, m_positionX, 
+        m_positionY, m_yaw);
+    m_yaw = std::atan2(std::sin(m_yaw), std::cos(m_yaw));
+    m_time = a_time;
+  }
+}
+
+}
+}
+}
@@ -22,7 +22,13 @@
 #include "cxxtest/TestSuite.h"
 
 // Include local header files.
+#include <unistd.h>
+
+#include <cstdio>
+
+#include "../include/MapCache.h"
 #include "../include/Navigation.h"
+#include "../include/PosePredictor.h"
 
 class NavigationTest : public CxxTest::TestSuite {
    public:
@@ -33,6 +39,88 @@ class NavigationTest : public CxxTest::TestSuite {
     void testApplication() {
         TS_ASSERT(true);
     }
+
+    void testPosePredictorExtrapolates() {
+        opendlv::logic::miniature::PosePredictor predictor;
+        predictor.setModel(6.0, 1.2, 25000, 50000);
+        predictor.correct(opendlv::data::environment::Point3(1.0, 2.0, 0.0), 
+            0.0, odcore::data::TimeStamp(10, 0));
+        std::array<int32_t, 2> const duties = {{50000, 50000}};
+        predictor.setMotorDuties(duties, odcore::data::TimeStamp(10, 0));
+
+        opendlv::data::environment::Point3 position;
+        double yaw = 0.0;
+        predictor.predict(odcore::data::TimeStamp(10, 500000), position, yaw);
+        TS_ASSERT_DELTA(position.getX(), 4.0, 1e-6);
+        TS_ASSERT_DELTA(position.getY(), 2.0, 1e-6);
+        TS_ASSERT_DELTA(yaw, 0.0, 1e-6);
+    }
+
+    void testPosePredictorCorrects() {
+        opendlv::logic::miniature::PosePredictor predictor;
+        predictor.setGains(0.5, 0.5);
+        predictor.correct(opendlv::data::environment::Point3(0.0, 0.0, 0.0), 
+            3.0, odcore::data::TimeStamp(10, 0));
+        predictor.correct(opendlv::data::environment::Point3(2.0, 0.0, 0.0), 
+            -3.0, odcore::data::TimeStamp(10, 100000));
+
+        opendlv::data::environment::Point3 position;
+        double yaw = 0.0;
+        predictor.predict(odcore::data::TimeStamp(10, 100000), position, yaw);
+        TS_ASSERT_DELTA(position.getX(), 1.0, 1e-6);
+        // The yaw is blended the short way around, across pi.
+        TS_ASSERT(yaw > 3.0 || yaw < -3.0);
+    }
+
+    void testMapCacheRoundTrip() {
+        std::string const filename = "NavigationTestSuite.map";
+        opendlv::logic::miniature::MapCache mapCache(filename);
+        std::vector<opendlv::data::environment::Point3> nodes;
+        nodes.push_back(opendlv::data::environment::Point3(1.0, 2.0, 0.0));
+        nodes.push_back(opendlv::data::environment::Point3(3.0, 2.0, 0.0));
+        std::vector<std::array<int32_t, 4>> neighbours;
+        neighbours.push_back({{-1, 1, -1, -1}});
+        neighbours.push_back({{0, -1, -1, -1}});
+        TS_ASSERT(mapCache.save(42, nodes, neighbours));
+
+        std::vector<opendlv::data::environment::Point3> loadedNodes;
+        std::vector<std::array<int32_t, 4>> loadedNeighbours;
+        TS_ASSERT(!mapCache.load(43, loadedNodes, loadedNeighbours));
+        TS_ASSERT(mapCache.load(42, loadedNodes, loadedNeighbours));
+        TS_ASSERT_EQUALS(loadedNodes.size(), 2u);
+        TS_ASSERT_DELTA(loadedNodes[1].getX(), 3.0, 1e-9);
+        TS_ASSERT_EQUALS(loadedNeighbours[0][1], 1);
+        TS_ASSERT_EQUALS(loadedNeighbours[1][0], 0);
+        std::remove(filename.c_str());
+    }
+
+    void testMapCacheRejectsInconsistentFile() {
+        std::string const filename = "NavigationTestSuite.map";
+        opendlv::logic::miniature::MapCache mapCache(filename);
+        std::vector<opendlv::data::environment::Point3> nodes;
+        nodes.push_back(opendlv::data::environment::Point3(1.0, 2.0, 0.0));
+        nodes.push_back(opendlv::data::environment::Point3(3.0, 2.0, 0.0));
+        std::vector<std::array<int32_t, 4>> neighbours;
+        neighbours.push_back({{-1, 1, -1, -1}});
+        neighbours.push_back({{0, -1, 2, -1}});
+        TS_ASSERT(mapCache.save(42, nodes, neighbours));
+
+        std::vector<opendlv::data::environment::Point3> loadedNodes;
+        std::vector<std::array<int32_t, 4>> loadedNeighbours;
+        TS_ASSERT(!mapCache.load(42, loadedNodes, loadedNeighbours));
+        TS_ASSERT(loadedNodes.empty());
+        TS_ASSERT(loadedNeighbours.empty());
+
+        neighbours[1][2] = -2;
+        TS_ASSERT(mapCache.save(42, nodes, neighbours));
+        TS_ASSERT(!mapCache.load(42, loadedNodes, loadedNeighbours));
+
+        neighbours[1][2] = -1;
+        TS_ASSERT(mapCache.save(42, nodes, neighbours));
+        TS_ASSERT_EQUALS(truncate(filename.c_str(), 40), 0);
+        TS_ASSERT(!mapCache.load(42, loadedNodes, loadedNeighbours));
+        std::remove(filename.c_str());
+    }
 };
 
 #endif
@@ -0,0 +1,113 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PATHPLANNER_TESTSUITE_H
+#define PATHPLANNER_TESTSUITE_H
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "cxxtest/TestSuite.h"
+
+// Include local header files.
+#include "../include/PathPlanner.h"
+
+// Counts all heap allocations made by this test runner.
+static uint64_t g_allocationCount = 0;
+
+void *operator new(std::size_t a_size) {
+    g_allocationCount++;
+    void *memory = std::malloc(a_size == 0 ? 1 : a_size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *a_memory) noexcept {
+    std::free(a_memory);
+}
+
+class PathPlannerTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    // A 10 by 10 grid with a wall from (8, 0) to (8, 14).
+    std::vector<opendlv::data::environment::Point3> getNodes() {
+        std::vector<opendlv::data::environment::Point3> nodes;
+        for (double y = 0; y < 20; y += 2) {
+            for (double x = 0; x < 20; x += 2) {
+                if (!(x > 7 && x < 9 && y < 15)) {
+                    nodes.push_back(
+                        opendlv::data::environment::Point3(x, y, 0));
+                }
+            }
+        }
+        return nodes;
+    }
+
+    void testPathAroundWall() {
+        opendlv::logic::miniature::PathPlanner planner;
+        planner.setNodes(getNodes(), 2);
+        std::vector<opendlv::data::environment::Point3> path;
+        TS_ASSERT(planner.plan(opendlv::data::environment::Point3(0, 0, 0), 
+            opendlv::data::environment::Point3(18, 0, 0), path));
+        TS_ASSERT_EQUALS(path.front(), 
+            opendlv::data::environment::Point3(0, 0, 0));
+        TS_ASSERT_EQUALS(path.back(), 
+            opendlv::data::environment::Point3(18, 0, 0));
+        // Up to y = 16, over the wall and down again.
+        TS_ASSERT_EQUALS(path.size(), 26u);
+        for (uint32_t i = 1; i < path.size(); i++) {
+            TS_ASSERT_DELTA(path[i].getDistanceTo(path[i - 1]), 2.0, 1e-9);
+        }
+    }
+
+    void testUnreachableGoal() {
+        std::vector<opendlv::data::environment::Point3> nodes;
+        nodes.push_back(opendlv::data::environment::Point3(0, 0, 0));
+        nodes.push_back(opendlv::data::environment::Point3(10, 0, 0));
+        opendlv::logic::miniature::PathPlanner planner;
+        planner.setNodes(nodes, 2);
+        std::vector<opendlv::data::environment::Point3> path;
+        TS_ASSERT(!planner.plan(opendlv::data::environment::Point3(0, 0, 0), 
+            opendlv::data::environment::Point3(10, 0, 0), path));
+        TS_ASSERT_EQUALS(path.size(), 1u);
+    }
+
+    void testNoAllocationWhenPlanning() {
+        std::vector<opendlv::data::environment::Point3> const nodes = 
+            getNodes();
+        opendlv::logic::miniature::PathPlanner planner;
+        planner.setNodes(nodes, 2);
+        std::vector<opendlv::data::environment::Point3> path;
+        path.reserve(nodes.size());
+
+        uint64_t const allocationCount = g_allocationCount;
+        for (uint32_t i = 0; i < 100; i++) {
+            planner.plan(nodes[i % nodes.size()], 
+                nodes[(i * 7) % nodes.size()], path);
+        }
+        TS_ASSERT_EQUALS(g_allocationCount, allocationCount);
+    }
+};
+
+#endif
@@ -22,9 +22,12 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
 
+#include "SysfsAttribute.h"
+
 namespace opendlv {
 namespace proxy {
 namespace miniature {
@@ -46,6 +49,7 @@ class Analog : public odcore::base::module::TimeTriggeredConferenceClientModule
     float m_conversionConst;
     bool m_debug;
     std::vector<uint16_t> m_pins;
+    std::vector<SysfsAttribute> m_rawFiles;
 };
 
 } 
@@ -18,7 +18,6 @@
 
 #include <cmath>
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
 
@@ -39,6 +38,7 @@ Analog::Analog(const int &argc, char **argv)
     , m_conversionConst()
     , m_debug()
     , m_pins()
+    , m_rawFiles()
 {
 }
 
@@ -60,10 +60,26 @@ void Analog::setUp()
   for(std::string const& str : pinsVecString) {
     m_pins.push_back(std::stoi(str));
   }
+
+  // The raw readings are opened once, and read with a single pread each.
+  bool hasSystemPath = false;
+  std::string const systemPath = kv.getOptionalValue<std::string>(
+      "proxy-miniature-analog.systemPath", hasSystemPath);
+  std::string const path = 
+      hasSystemPath ? systemPath : "/sys/bus/iio/devices/iio:device0";
+  m_rawFiles.resize(m_pins.size());
+  for (uint32_t i = 0; i < m_pins.size(); i++) {
+    if (!m_rawFiles[i].Open(path + "/in_voltage" + std::to_string(m_pins[i]) 
+        + "_raw", false)) {
+      std::cerr << "[" << getName() << "] Could not open " 
+          << m_rawFiles[i].GetPath() << "." << std::endl;
+    }
+  }
 }
 
 void Analog::tearDown() 
 {
+  m_rawFiles.clear();
 }
 
 
@@ -90,22 +106,18 @@ odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode Analog::body()
 
 std::vector<std::pair<uint16_t, float>> Analog::getReadings() {
   std::vector<std::pair<uint16_t, float>> reading;
-  for(uint16_t const pin : m_pins) {
-    std::string filename = "/sys/bus/iio/devices/iio:device0/in_voltage" 
-        + std::to_string(pin) + "_raw";
-    std::ifstream file(filename, std::ifstream::in);
-    std::string line;
-    if(file.is_open()){
-      std::getline(file, line);
-      uint16_t rawReading = std::stoi(line);
-      reading.push_back(std::make_pair(pin, rawReading*m_conversionConst));
+  for (uint32_t i = 0; i < m_pins.size(); i++) {
+    uint16_t const pin = m_pins[i];
+    int64_t rawReading = 0;
+    if (m_rawFiles[i].ReadInteger(rawReading)) {
+      reading.push_back(std::make_pair(pin, 
+          static_cast<float>(rawReading) * m_conversionConst));
     } else {
       std::cerr << "[" << getName() 
           << "] Could not read from analog input. (pin: " << pin 
-          << ", filename: " << filename << ")" << std::endl;
+          << ", filename: " << m_rawFiles[i].GetPath() << ")" << std::endl;
       reading.push_back(std::make_pair(pin,std::nanf("")));
     }
-    file.close();
   }
   return reading;
 }
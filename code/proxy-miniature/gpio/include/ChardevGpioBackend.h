@@ -0,0 +1,67 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_CHARDEVGPIOBACKEND_H
+#define PROXY_MINIATURE_CHARDEVGPIOBACKEND_H
+
+#include <string>
+#include <vector>
+
+#include "GpioBackend.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * GPIO through the character devices of the GPIO chips, with version 2 of
+ * the Linux GPIO uAPI. The pins are numbered as in sysfs, so each pin is a
+ * line of the chip numbered by the pin divided by the lines per chip. All
+ * the pins of a chip, called a bank, are requested as one handle, and read
+ * or written with one ioctl, so a tick is one system call per bank.
+ */
+class ChardevGpioBackend : public GpioBackend {
+ public:
+  ChardevGpioBackend(std::string const &, uint32_t);
+  ChardevGpioBackend(ChardevGpioBackend const &) = delete;
+  ChardevGpioBackend &operator=(ChardevGpioBackend const &) = delete;
+  virtual ~ChardevGpioBackend();
+  virtual void Open(std::vector<uint16_t> const &, std::vector<bool> const &, 
+      std::vector<bool> const &);
+  virtual void Close();
+  virtual bool GetValues(uint64_t &);
+  virtual bool SetValues(uint64_t, uint64_t);
+  uint32_t GetBankCount() const;
+
+ private:
+  struct bank {
+    uint32_t chip;
+    int file;
+    std::vector<uint32_t> indices;
+  };
+
+  std::string m_chipPath;
+  uint32_t m_linesPerChip;
+  std::vector<bank> m_banks;
+};
+
+}
+}
+}
+
+#endif
@@ -28,6 +28,8 @@
 
 #include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
 
+#include "GpioBackend.h"
+
 namespace opendlv {
 namespace proxy {
 namespace miniature {
@@ -48,19 +50,18 @@ class Gpio : public odcore::base::module::TimeTriggeredConferenceClientModule {
   void tearDown();
   virtual odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
 
-  void OpenGpio();
+  bool OpenGpio();
   void CloseGpio();
-  void Reset();
-  void SetDirection(uint16_t const, std::string);
-  std::string GetDirection(uint16_t const) const;
-  void SetValue(uint16_t const, bool const);
-  bool GetValue(uint16_t const) const;
+  int32_t GetIndex(uint16_t const) const;
+  void SetValue(uint32_t const, bool const);
 
   bool m_debug;
   bool m_initialised;
+  bool m_isReadFailing;
   std::vector<std::pair<bool, std::string>> m_initialValuesDirections;
   std::string m_path;
   std::vector<uint16_t> m_pins;
+  std::unique_ptr<GpioBackend> m_backend;
 };
 
 }
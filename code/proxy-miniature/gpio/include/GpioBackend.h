@@ -0,0 +1,49 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_GPIOBACKEND_H
+#define PROXY_MINIATURE_GPIOBACKEND_H
+
+#include <cstdint>
+#include <vector>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Interface to the GPIO lines of the configured pins. The values of all
+ * pins are read and written at once as bits, where bit i is the pin at
+ * index i of the configuration, so at most 64 pins are supported. Open
+ * throws a std::runtime_error on errors.
+ */
+class GpioBackend {
+ public:
+  virtual ~GpioBackend() {}
+  virtual void Open(std::vector<uint16_t> const &, std::vector<bool> const &, 
+      std::vector<bool> const &) = 0;
+  virtual void Close() = 0;
+  virtual bool GetValues(uint64_t &) = 0;
+  virtual bool SetValues(uint64_t, uint64_t) = 0;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_SYSFSGPIOBACKEND_H
+#define PROXY_MINIATURE_SYSFSGPIOBACKEND_H
+
+#include <string>
+#include <vector>
+
+#include "GpioBackend.h"
+#include "SysfsAttribute.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * GPIO through the sysfs interface, such as /sys/class/gpio. The pins are
+ * exported, and the value of each is opened once and read or written with
+ * one system call per pin.
+ */
+class SysfsGpioBackend : public GpioBackend {
+ public:
+  SysfsGpioBackend(std::string const &);
+  SysfsGpioBackend(SysfsGpioBackend const &) = delete;
+  SysfsGpioBackend &operator=(SysfsGpioBackend const &) = delete;
+  virtual ~SysfsGpioBackend();
+  virtual void Open(std::vector<uint16_t> const &, std::vector<bool> const &, 
+      std::vector<bool> const &);
+  virtual void Close();
+  virtual bool GetValues(uint64_t &);
+  virtual bool SetValues(uint64_t, uint64_t);
+
+ private:
+  std::string m_path;
+  std::vector<uint16_t> m_pins;
+  std::vector<SysfsAttribute> m_valueFiles;
+};
+
+}
+}
+}
+
+#endif
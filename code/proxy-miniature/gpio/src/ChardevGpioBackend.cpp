@@ -0,0 +1,221 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "ChardevGpioBackend.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Takes the path of the chips without their number, such as /dev/gpiochip,
+ * and the number of lines of each chip.
+ */
+ChardevGpioBackend::ChardevGpioBackend(std::string const &a_chipPath, 
+    uint32_t a_linesPerChip)
+    : GpioBackend()
+    , m_chipPath(a_chipPath)
+    , m_linesPerChip((a_linesPerChip > 0) ? a_linesPerChip : 32)
+    , m_banks()
+{
+}
+
+ChardevGpioBackend::~ChardevGpioBackend()
+{
+  Close();
+}
+
+uint32_t ChardevGpioBackend::GetBankCount() const
+{
+  return static_cast<uint32_t>(m_banks.size());
+}
+
+/**
+ * Groups the pins by chip, and requests the lines of each chip as one
+ * handle. The lines are inputs, except for the outputs, which are given
+ * their initial values in the same request so they never glitch.
+ */
+void ChardevGpioBackend::Open(std::vector<uint16_t> const &a_pins, 
+    std::vector<bool> const &a_isOutputs, 
+    std::vector<bool> const &a_initialValues)
+{
+  Close();
+  if (a_pins.size() > 64) {
+    throw std::runtime_error("At most 64 pins are supported.");
+  }
+  for (uint32_t i = 0; i < a_pins.size(); i++) {
+    uint32_t const chip = a_pins[i] / m_linesPerChip;
+    uint32_t j = 0;
+    while (j < m_banks.size() && m_banks[j].chip != chip) {
+      j++;
+    }
+    if (j == m_banks.size()) {
+      bank const newBank = {chip, -1, std::vector<uint32_t>()};
+      m_banks.push_back(newBank);
+    }
+    m_banks[j].indices.push_back(i);
+  }
+
+#ifdef GPIO_V2_GET_LINE_IOCTL
+  for (auto &chipBank : m_banks) {
+    std::string const filename = m_chipPath + std::to_string(chipBank.chip);
+    int const chipFile = open(filename.c_str(), O_RDWR | O_CLOEXEC);
+    if (chipFile < 0) {
+      std::string const error = std::strerror(errno);
+      Close();
+      throw std::runtime_error(std::string("Could not open ") + filename 
+          + ": " + error);
+    }
+
+    struct gpio_v2_line_request request;
+    std::memset(&request, 0, sizeof(request));
+    std::strncpy(request.consumer, "opendlv-proxy-miniature-gpio", 
+        sizeof(request.consumer) - 1);
+    request.num_lines = static_cast<uint32_t>(chipBank.indices.size());
+    request.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+    uint64_t outputs = 0;
+    uint64_t values = 0;
+    for (uint32_t j = 0; j < chipBank.indices.size(); j++) {
+      uint32_t const i = chipBank.indices[j];
+      request.offsets[j] = a_pins[i] % m_linesPerChip;
+      if (a_isOutputs[i]) {
+        outputs |= (1ull << j);
+        if (a_initialValues[i]) {
+          values |= (1ull << j);
+        }
+      }
+    }
+    if (outputs != 0) {
+      request.config.num_attrs = 2;
+      request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+      request.config.attrs[0].attr.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+      request.config.attrs[0].mask = outputs;
+      request.config.attrs[1].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+      request.config.attrs[1].attr.values = values;
+      request.config.attrs[1].mask = outputs;
+    }
+
+    int const result = ioctl(chipFile, GPIO_V2_GET_LINE_IOCTL, &request);
+    std::string const error = std::strerror(errno);
+    close(chipFile);
+    if (result < 0) {
+      Close();
+      throw std::runtime_error(std::string("Could not request the lines of ") 
+          + filename + ": " + error);
+    }
+    chipBank.file = request.fd;
+  }
+#else
+  (void) a_isOutputs;
+  (void) a_initialValues;
+  m_banks.clear();
+  throw std::runtime_error(
+      "Built without the GPIO uAPI v2, which needs Linux 5.10.");
+#endif
+}
+
+void ChardevGpioBackend::Close()
+{
+  for (auto const &chipBank : m_banks) {
+    if (chipBank.file >= 0) {
+      close(chipBank.file);
+    }
+  }
+  m_banks.clear();
+}
+
+/**
+ * Reads all the lines of each bank with one ioctl, and fails if the lines
+ * are not requested.
+ */
+bool ChardevGpioBackend::GetValues(uint64_t &a_values)
+{
+#ifdef GPIO_V2_GET_LINE_IOCTL
+  if (m_banks.empty()) {
+    return false;
+  }
+  uint64_t values = 0;
+  for (auto const &chipBank : m_banks) {
+    struct gpio_v2_line_values lineValues;
+    lineValues.bits = 0;
+    lineValues.mask = (chipBank.indices.size() == 64) ? 
+        ~0ull : (1ull << chipBank.indices.size()) - 1;
+    if (ioctl(chipBank.file, GPIO_V2_LINE_GET_VALUES_IOCTL, &lineValues) < 0) {
+      return false;
+    }
+    for (uint32_t j = 0; j < chipBank.indices.size(); j++) {
+      if ((lineValues.bits & (1ull << j)) != 0) {
+        values |= (1ull << chipBank.indices[j]);
+      }
+    }
+  }
+  a_values = values;
+  return true;
+#else
+  (void) a_values;
+  return false;
+#endif
+}
+
+/**
+ * Writes the masked lines of each bank with one ioctl, skipping the banks
+ * with none of them.
+ */
+bool ChardevGpioBackend::SetValues(uint64_t a_mask, uint64_t a_values)
+{
+#ifdef GPIO_V2_GET_LINE_IOCTL
+  bool isWritten = true;
+  for (auto const &chipBank : m_banks) {
+    struct gpio_v2_line_values lineValues;
+    lineValues.bits = 0;
+    lineValues.mask = 0;
+    for (uint32_t j = 0; j < chipBank.indices.size(); j++) {
+      uint32_t const i = chipBank.indices[j];
+      if ((a_mask & (1ull << i)) != 0) {
+        lineValues.mask |= (1ull << j);
+        if ((a_values & (1ull << i)) != 0) {
+          lineValues.bits |= (1ull << j);
+        }
+      }
+    }
+    if (lineValues.mask != 0 
+        && ioctl(chipBank.file, GPIO_V2_LINE_SET_VALUES_IOCTL, &lineValues) 
+        < 0) {
+      isWritten = false;
+    }
+  }
+  return isWritten;
+#else
+  (void) a_mask;
+  (void) a_values;
+  return false;
+#endif
+}
+
+}
+}
+}
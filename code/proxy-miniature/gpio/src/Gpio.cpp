@@ -17,8 +17,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
-#include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -28,7 +28,9 @@
 
 #include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
 
+#include "ChardevGpioBackend.h"
 #include "Gpio.h"
+#include "SysfsGpioBackend.h"
 
 namespace opendlv {
 namespace proxy {
@@ -38,9 +40,11 @@ Gpio::Gpio(const int &argc, char **argv)
     : TimeTriggeredConferenceClientModule(argc, argv, "proxy-miniature-gpio")
     , m_debug()
     , m_initialised()
+    , m_isReadFailing(false)
     , m_initialValuesDirections()
     , m_path()
     , m_pins()
+    , m_backend()
 {
 }
 
@@ -56,6 +60,25 @@ void Gpio::setUp()
 
   m_path = kv.getValue<std::string>("proxy-miniature-gpio.systemPath");
 
+  // The character devices read or write all the pins of a chip with one
+  // ioctl, where sysfs takes one system call per pin. Sysfs is the default.
+  bool hasBackend = false;
+  std::string const backend = kv.getOptionalValue<std::string>(
+      "proxy-miniature-gpio.backend", hasBackend);
+  if (hasBackend && backend == "chardev") {
+    bool hasChipPath = false;
+    std::string const chipPath = kv.getOptionalValue<std::string>(
+        "proxy-miniature-gpio.chipPath", hasChipPath);
+    bool hasLinesPerChip = false;
+    uint32_t const linesPerChip = kv.getOptionalValue<uint32_t>(
+        "proxy-miniature-gpio.linesPerChip", hasLinesPerChip);
+    m_backend = std::unique_ptr<GpioBackend>(new ChardevGpioBackend(
+        hasChipPath ? chipPath : "/dev/gpiochip", 
+        hasLinesPerChip ? linesPerChip : 32));
+  } else {
+    m_backend = std::unique_ptr<GpioBackend>(new SysfsGpioBackend(m_path));
+  }
+
   std::string const pinsString = 
       kv.getValue<std::string>("proxy-miniature-gpio.pins");
   std::vector<std::string> pinsVector = 
@@ -80,7 +103,11 @@ void Gpio::setUp()
       uint16_t pin = std::stoi(pinsVector.at(i));
       bool value = static_cast<bool>(std::stoi(initialValuesVector.at(i)));
       std::string direction = initialDirectionsVector.at(i);
-      if (direction.compare("out") == 0 || direction.compare("in") == 0) {
+      if (m_pins.size() == 64) {
+        cerr << "[" << getName() << "] " << "At most 64 pins are supported." 
+            << std::endl;
+      } else if (direction.compare("out") == 0 
+          || direction.compare("in") == 0) {
         m_pins.push_back(pin);
         m_initialValuesDirections.push_back(std::make_pair(value, direction));
       } else {
@@ -105,9 +132,7 @@ void Gpio::setUp()
         << std::endl;
   }
 
-  OpenGpio();
-
-  m_initialised = true;
+  m_initialised = OpenGpio();
 }
 
 void Gpio::tearDown()
@@ -115,13 +140,36 @@ void Gpio::tearDown()
   CloseGpio();
 }
 
+/**
+ * Sends the value of every pin at the module frequency. If the pins could
+ * not be opened the module stops, and a failing read is reported once until
+ * the pins can be read again.
+ */
 odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode Gpio::body()
 {
+  if (!m_initialised) {
+    cerr << "[" << getName() << "] The pins could not be opened, stopping." 
+        << std::endl;
+    return odcore::data::dmcp::ModuleExitCodeMessage::SERIOUS_ERROR;
+  }
+
   while (getModuleStateAndWaitForRemainingTimeInTimeslice() == 
       odcore::data::dmcp::ModuleStateMessage::RUNNING) {
-    for (auto pin : m_pins) {
-      // std::string direction = GetDirection(pin);
-      bool value = GetValue(pin);
+    uint64_t values = 0;
+    if (!m_backend->GetValues(values)) {
+      if (!m_isReadFailing) {
+        cerr << "[" << getName() << "] Could not read the pins." << std::endl;
+        m_isReadFailing = true;
+      }
+      continue;
+    }
+    if (m_isReadFailing) {
+      cerr << "[" << getName() << "] Reading the pins again." << std::endl;
+      m_isReadFailing = false;
+    }
+    for (uint32_t i = 0; i < m_pins.size(); i++) {
+      uint16_t const pin = m_pins[i];
+      bool value = ((values >> i) & 1) == 1;
       opendlv::proxy::ToggleReading::ToggleState state;
       if (value) {
         state = opendlv::proxy::ToggleReading::On;
@@ -134,10 +182,10 @@ odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode Gpio::body()
     }
     if (m_debug) {
       std::cout << "Number of pins: " << m_pins.size() << std::endl;
-      for (auto pin : m_pins) {
-        std::cout << "[" << getName() << "] Pin: " << pin 
-            << " Direction: " << GetDirection(pin) 
-            << " Value: " << GetValue(pin) 
+      for (uint32_t i = 0; i < m_pins.size(); i++) {
+        std::cout << "[" << getName() << "] Pin: " << m_pins[i] 
+            << " Direction: " << m_initialValuesDirections[i].second 
+            << " Value: " << ((values >> i) & 1) 
             << "." << std::endl;
       }
     }
@@ -156,8 +204,13 @@ void Gpio::nextContainer(odcore::data::Container &a_container)
         a_container.getData<opendlv::proxy::ToggleRequest>();
     uint16_t pin = request.getPin();
     bool value = request.getState();
-    if (GetDirection(pin).compare("out") == 0) {
-      SetValue(pin, value);
+    int32_t const index = GetIndex(pin);
+    if (index < 0) {
+      cerr << "[" << getName() << "] The requested pin " << pin
+          << " is not configured." 
+          << std::endl;
+    } else if (m_initialValuesDirections[index].second.compare("out") == 0) {
+      SetValue(index, value);
     } else {
       cerr << "[" << getName() << "] The requested pin " << pin
           << " is read-only." 
@@ -166,124 +219,50 @@ void Gpio::nextContainer(odcore::data::Container &a_container)
   }
 }
 
-void Gpio::OpenGpio()
+/**
+ * Opens the configured pins, returns false if they could not be opened.
+ */
+bool Gpio::OpenGpio()
 {
-  std::string filename = m_path + "/export";
-  std::ofstream exportFile(filename, std::ofstream::out);
-  
-  if (exportFile.is_open()) {
-    for (auto pin : m_pins) {
-      exportFile << pin;
-      exportFile.flush();
-    }
-    Reset();
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename << "." 
-        << std::endl;
+  std::vector<bool> isOutputs;
+  std::vector<bool> initialValues;
+  for (auto pair : m_initialValuesDirections) {
+    isOutputs.push_back(pair.second.compare("out") == 0);
+    initialValues.push_back(pair.first);
+  }
+  try {
+    m_backend->Open(m_pins, isOutputs, initialValues);
+  } catch (std::exception const &exception) {
+    cerr << "[" << getName() << "] " << exception.what() << std::endl;
+    return false;
   }
-  exportFile.close();
+  return true;
 }
 
 void Gpio::CloseGpio()
 {
-  std::string filename = m_path + "/unexport";
-  std::ofstream unexportFile(filename, std::ofstream::out);
-  
-  if (unexportFile.is_open()) {
-    for (auto pin : m_pins) {
-      unexportFile << pin;
-      unexportFile.flush();
-    }
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename << "." 
-        << std::endl;
-  }
-  unexportFile.close();
+  m_backend->Close();
 }
 
-void Gpio::Reset()
+/**
+ * Returns the index of a configured pin, or -1 if it is not configured.
+ */
+int32_t Gpio::GetIndex(uint16_t const a_pin) const
 {
-  for (uint16_t i = 0; i < m_pins.size(); i++) {
-    uint16_t pin = m_pins[i];
-    bool initialValue = m_initialValuesDirections[i].first;
-    std::string initialDirection = m_initialValuesDirections[i].second;
-    SetDirection(pin, initialDirection);
-    if (initialDirection.compare("out") == 0) {
-      SetValue(pin, initialValue);
+  for (uint32_t i = 0; i < m_pins.size(); i++) {
+    if (m_pins[i] == a_pin) {
+      return static_cast<int32_t>(i);
     }
   }
+  return -1;
 }
 
-void Gpio::SetDirection(uint16_t const a_pin, std::string const a_str)
-{
-  std::string gpioDirectionFilename = m_path + "/gpio" + std::to_string(a_pin) 
-      + "/direction";
-
-  std::ofstream gpioDirectionFile(gpioDirectionFilename, std::ofstream::out);
-  if (gpioDirectionFile.is_open()) {
-    gpioDirectionFile << a_str;
-    gpioDirectionFile.flush();
-  } else {
-    cerr << "[" << getName() << "] Could not open " << gpioDirectionFilename 
-        << "." << std::endl;
-  }
-
-  gpioDirectionFile.close();
-}
-
-std::string Gpio::GetDirection(uint16_t const a_pin) const
+void Gpio::SetValue(uint32_t const a_index, bool const a_value)
 {
-  std::string gpioDirectionFilename = m_path + "/gpio" + std::to_string(a_pin) 
-      + "/direction";
-  std::string line;
-
-  std::ifstream gpioDirectionFile(gpioDirectionFilename, std::ifstream::in);
-  if (gpioDirectionFile.is_open()) {
-    std::getline(gpioDirectionFile, line);
-    std::string direction = line;
-    gpioDirectionFile.close();
-    return direction;
-  } else {
-    cerr << "[" << getName() << "] Could not open " << gpioDirectionFilename 
-        << "." << std::endl;
-    gpioDirectionFile.close();
-    return "";
-  }
-}
-
-void Gpio::SetValue(uint16_t const a_pin, bool const a_value)
-{
-  std::string gpioValueFilename = 
-      m_path + "/gpio" + std::to_string(a_pin) + "/value";
-
-  std::ofstream gpioValueFile(gpioValueFilename, std::ofstream::out);
-  if (gpioValueFile.is_open()) {
-    gpioValueFile << static_cast<uint16_t>(a_value);
-    gpioValueFile.flush();
-  } else {
-    cerr << "[" << getName() << "] Could not open " << gpioValueFilename 
-        << "." << std::endl;
-  }
-  gpioValueFile.close();
-}
-
-bool Gpio::GetValue(uint16_t const a_pin) const
-{
-  std::string gpioValueFilename = 
-      m_path + "/gpio" + std::to_string(a_pin) + "/value";
-  std::string line;
-
-  std::ifstream gpioValueFile(gpioValueFilename, std::ifstream::in);
-  if (gpioValueFile.is_open()) {
-    std::getline(gpioValueFile, line);
-    bool value = (std::stoi(line) == 1);
-    gpioValueFile.close();
-    return value;
-  } else {
-    cerr << "[" << getName() << "] Could not open " << gpioValueFilename 
+  uint64_t const mask = 1ull << a_index;
+  if (!m_backend->SetValues(mask, a_value ? mask : 0)) {
+    cerr << "[" << getName() << "] Could not write pin " << m_pins[a_index] 
         << "." << std::endl;
-    gpioValueFile.close();
-    return NULL;
   }
 }
 
@@ -0,0 +1,134 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdexcept>
+
+#include "SysfsGpioBackend.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+SysfsGpioBackend::SysfsGpioBackend(std::string const &a_path)
+    : GpioBackend()
+    , m_path(a_path)
+    , m_pins()
+    , m_valueFiles()
+{
+}
+
+SysfsGpioBackend::~SysfsGpioBackend()
+{
+  Close();
+}
+
+/**
+ * Exports the pins, sets their directions and the initial values of the
+ * outputs, and opens their values.
+ */
+void SysfsGpioBackend::Open(std::vector<uint16_t> const &a_pins, 
+    std::vector<bool> const &a_isOutputs, 
+    std::vector<bool> const &a_initialValues)
+{
+  Close();
+  SysfsAttribute exportFile;
+  if (!exportFile.Open(m_path + "/export", true)) {
+    throw std::runtime_error(std::string("Could not open ") 
+        + exportFile.GetPath() + ".");
+  }
+  for (auto pin : a_pins) {
+    exportFile.WriteInteger(pin);
+  }
+
+  m_pins = a_pins;
+  m_valueFiles.resize(m_pins.size());
+  for (uint32_t i = 0; i < m_pins.size(); i++) {
+    std::string const pinPath = m_path + "/gpio" + std::to_string(m_pins[i]);
+    SysfsAttribute directionFile;
+    if (!directionFile.Open(pinPath + "/direction", true) 
+        || !directionFile.WriteString(a_isOutputs[i] ? "out" : "in")) {
+      throw std::runtime_error(std::string("Could not set ") 
+          + directionFile.GetPath() + ".");
+    }
+    if (!m_valueFiles[i].Open(pinPath + "/value", true)) {
+      throw std::runtime_error(std::string("Could not open ") 
+          + m_valueFiles[i].GetPath() + ".");
+    }
+    if (a_isOutputs[i] 
+        && !m_valueFiles[i].WriteInteger(a_initialValues[i] ? 1 : 0)) {
+      throw std::runtime_error(std::string("Could not write ") 
+          + m_valueFiles[i].GetPath() + ".");
+    }
+  }
+}
+
+/**
+ * Closes the values and unexports the pins.
+ */
+void SysfsGpioBackend::Close()
+{
+  if (m_pins.empty()) {
+    return;
+  }
+  m_valueFiles.clear();
+  SysfsAttribute unexportFile;
+  if (unexportFile.Open(m_path + "/unexport", true)) {
+    for (auto pin : m_pins) {
+      unexportFile.WriteInteger(pin);
+    }
+  }
+  m_pins.clear();
+}
+
+/**
+ * Reads the value of every pin, and fails if the pins are not open.
+ */
+bool SysfsGpioBackend::GetValues(uint64_t &a_values)
+{
+  if (m_valueFiles.empty()) {
+    return false;
+  }
+  uint64_t values = 0;
+  for (uint32_t i = 0; i < m_valueFiles.size(); i++) {
+    int64_t value = 0;
+    if (!m_valueFiles[i].ReadInteger(value)) {
+      return false;
+    }
+    if (value == 1) {
+      values |= (1ull << i);
+    }
+  }
+  a_values = values;
+  return true;
+}
+
+bool SysfsGpioBackend::SetValues(uint64_t a_mask, uint64_t a_values)
+{
+  bool isWritten = true;
+  for (uint32_t i = 0; i < m_valueFiles.size(); i++) {
+    if ((a_mask & (1ull << i)) != 0) {
+      isWritten = m_valueFiles[i].WriteInteger((a_values >> i) & 1) 
+          && isWritten;
+    }
+  }
+  return isWritten;
+}
+
+}
+}
+}
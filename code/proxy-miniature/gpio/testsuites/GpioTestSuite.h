@@ -20,10 +20,20 @@
 #ifndef GPIO_TESTSUITE_H
 #define GPIO_TESTSUITE_H
 
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
 #include "cxxtest/TestSuite.h"
 
 // Include local header files.
+#include "../include/ChardevGpioBackend.h"
 #include "../include/Gpio.h"
+#include "../include/SysfsGpioBackend.h"
 
 using namespace std;
 using namespace odcore::data;
@@ -75,6 +85,49 @@ class GpioTest : public CxxTest::TestSuite {
     TS_ASSERT(dt != NULL);
   }
 
+  void testSysfsGpioBackend() {
+    // A fake sysfs tree, where the pins are already exported.
+    char directory[] = "/tmp/gpioXXXXXX";
+    TS_ASSERT(mkdtemp(directory) != nullptr);
+    std::string const path = directory;
+    std::ofstream(path + "/export");
+    std::ofstream(path + "/unexport");
+    std::vector<uint16_t> const pins = {20, 21, 60};
+    for (auto pin : pins) {
+      std::string const pinPath = path + "/gpio" + std::to_string(pin);
+      mkdir(pinPath.c_str(), 0755);
+      std::ofstream(pinPath + "/direction") << "in\n";
+      std::ofstream(pinPath + "/value") << "1\n";
+    }
+
+    SysfsGpioBackend backend(path);
+    uint64_t values = 0;
+    TS_ASSERT(!backend.GetValues(values));
+    backend.Open(pins, {false, true, true}, {false, false, true});
+    std::string direction;
+    std::ifstream(path + "/gpio21/direction") >> direction;
+    TS_ASSERT_EQUALS(direction, "out");
+    TS_ASSERT(backend.GetValues(values));
+    TS_ASSERT_EQUALS(values, 5u);
+    TS_ASSERT(backend.SetValues(2, 2));
+    TS_ASSERT(backend.SetValues(4, 0));
+    TS_ASSERT(backend.GetValues(values));
+    TS_ASSERT_EQUALS(values, 3u);
+    backend.Close();
+    TS_ASSERT(!backend.GetValues(values));
+
+    std::system(("rm -r " + path).c_str());
+  }
+
+  void testChardevGpioBackendWithoutChip() {
+    ChardevGpioBackend backend("/nonexistent/gpiochip", 32);
+    uint64_t values = 0;
+    TS_ASSERT_THROWS(backend.Open({20, 21, 60}, {false, true, false}, 
+        {false, false, false}), std::runtime_error);
+    TS_ASSERT_EQUALS(backend.GetBankCount(), 0u);
+    TS_ASSERT(!backend.GetValues(values));
+  }
+
   ////////////////////////////////////////////////////////////////////////////////////
   // Below this line the necessary constructor for initializing the pointer variables,
   // and the forbidden copy constructor and assignment operator are declared.
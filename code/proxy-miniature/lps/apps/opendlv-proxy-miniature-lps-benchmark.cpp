@@ -0,0 +1,149 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MarkerBuffer.h"
+#include "MarkerSearch.h"
+#include "RigidBody.h"
+
+// The search as it was done before the distance matrix, with a square root
+// for every pair, kept as the reference.
+static uint32_t SearchReference(std::vector<float> const &a_needleDistances, 
+    float a_searchMarginHalf, 
+    std::vector<opendlv::model::Cartesian3> const &a_markers)
+{
+  uint32_t const markerCount = static_cast<uint32_t>(a_markers.size());
+  uint32_t const needleMarkerCount = 
+      static_cast<uint32_t>(a_needleDistances.size());
+  uint32_t candidateCount = 0;
+  std::vector<float> foundDistances(needleMarkerCount);
+  std::vector<int32_t> foundIndices(needleMarkerCount);
+
+  for (uint32_t i = 0; i < markerCount; i++) {
+    for (uint32_t j = 0; j < needleMarkerCount; j++) {
+      foundDistances[j] = std::numeric_limits<float>::max();
+      foundIndices[j] = -1;
+      for (uint32_t k = 0; k < markerCount; k++) {
+        if (i == k) {
+          continue;
+        }
+        float const dx = a_markers[k].getX() - a_markers[i].getX();
+        float const dy = a_markers[k].getY() - a_markers[i].getY();
+        float const dz = a_markers[k].getZ() - a_markers[i].getZ();
+        float const distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (a_needleDistances[j] + a_searchMarginHalf > distance 
+            && a_needleDistances[j] - a_searchMarginHalf < distance 
+            && std::abs(distance - a_needleDistances[j]) 
+                < std::abs(foundDistances[j] - a_needleDistances[j])) {
+          foundDistances[j] = distance;
+          foundIndices[j] = static_cast<int32_t>(k);
+        }
+      }
+    }
+    bool isNeedleFound = true;
+    for (int32_t index : foundIndices) {
+      isNeedleFound = isNeedleFound && (index != -1);
+    }
+    if (isNeedleFound) {
+      candidateCount++;
+    }
+  }
+  return candidateCount;
+}
+
+int32_t main(int32_t argc, char **argv) {
+  uint32_t frameCount = 2000;
+  for (int32_t i = 1; i < argc; i++) {
+    std::string const argument(argv[i]);
+    if (argument.find("--frames=") == 0) {
+      frameCount = static_cast<uint32_t>(
+          std::stoul(argument.substr(argument.find('=') + 1)));
+    } else {
+      std::cerr << "Unknown argument: " << argument << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<opendlv::model::Cartesian3> needle;
+  needle.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+  needle.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+  float const searchMargin = 0.01f;
+
+  opendlv::proxy::miniature::MarkerSearch search;
+  search.SetBodies(std::vector<opendlv::proxy::miniature::RigidBody>{
+      opendlv::proxy::miniature::RigidBody(0, needle)}, searchMargin);
+  std::vector<float> needleDistances = {0.1f, 0.06f};
+
+  std::mt19937 randomGenerator(0);
+  std::uniform_real_distribution<float> position(-3.0f, 3.0f);
+
+  std::cout << "markers,reference-us,vectorized-us,speedup" << std::endl;
+  for (uint32_t markerCount : {4u, 8u, 16u, 32u, 64u, 128u}) {
+    // One robot plus random markers, such as reflections and other robots.
+    std::vector<opendlv::model::Cartesian3> markers;
+    markers.push_back(opendlv::model::Cartesian3(1.0f, 1.0f, 0.1f));
+    markers.push_back(opendlv::model::Cartesian3(1.1f, 1.0f, 0.1f));
+    markers.push_back(opendlv::model::Cartesian3(1.0f, 1.06f, 0.1f));
+    while (markers.size() < markerCount) {
+      markers.push_back(opendlv::model::Cartesian3(position(randomGenerator), 
+          position(randomGenerator), 0.1f));
+    }
+
+    uint32_t referenceFound = 0;
+    auto const referenceStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frameCount; i++) {
+      // The search keeps the best candidate of the body.
+      referenceFound += (SearchReference(needleDistances, 
+          0.5f * searchMargin, markers) > 0) ? 1 : 0;
+    }
+    auto const referenceEnd = std::chrono::steady_clock::now();
+
+    opendlv::proxy::miniature::MarkerBuffer buffer;
+    uint32_t vectorizedFound = 0;
+    auto const vectorizedStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frameCount; i++) {
+      buffer.Clear();
+      for (auto const &marker : markers) {
+        buffer.Add(marker.getX(), marker.getY(), marker.getZ());
+      }
+      vectorizedFound += search.Search(buffer.GetView());
+    }
+    auto const vectorizedEnd = std::chrono::steady_clock::now();
+
+    if (referenceFound != vectorizedFound) {
+      std::cerr << "Mismatch at " << markerCount << " markers: " 
+          << referenceFound << " != " << vectorizedFound << std::endl;
+      return 1;
+    }
+
+    double const referenceTime = std::chrono::duration<double, std::micro>(
+        referenceEnd - referenceStart).count() / frameCount;
+    double const vectorizedTime = std::chrono::duration<double, std::micro>(
+        vectorizedEnd - vectorizedStart).count() / frameCount;
+    std::cout << markerCount << "," << referenceTime << "," << vectorizedTime 
+        << "," << referenceTime / vectorizedTime << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_DISTANCEMATRIX_H
+#define PROXY_MINIATURE_DISTANCEMATRIX_H
+
+#include <vector>
+
+#include "MarkerView.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * The squared distances between all pairs of markers in a frame, computed
+ * in one pass with SSE or NEON where available. Row i holds the squared
+ * distances from marker i to all markers, stored contiguously so that a row
+ * can be scanned linearly.
+ */
+class DistanceMatrix {
+  public:
+    DistanceMatrix();
+    DistanceMatrix(DistanceMatrix const &) = delete;
+    DistanceMatrix &operator=(DistanceMatrix const &) = delete;
+    virtual ~DistanceMatrix();
+    void Compute(MarkerView const &);
+    uint32_t GetCount() const;
+    float const *GetRow(uint32_t) const;
+    float GetSquaredDistance(uint32_t, uint32_t) const;
+
+  private:
+    std::vector<float> m_squaredDistances;
+    uint32_t m_count;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_GEOMETRICHASH_H
+#define PROXY_MINIATURE_GEOMETRICHASH_H
+
+#include <vector>
+
+#include "RigidBody.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Hash table from an origo distance to the needle markers of all bodies
+ * that have a marker at about that distance from their origo. The table is
+ * binned by the search margin and each needle marker is stored in every bin
+ * its tolerance band overlaps, so a lookup is a single bin whatever the
+ * number of bodies.
+ */
+class GeometricHash {
+  public:
+    struct Entry {
+      Entry();
+      Entry(uint32_t, uint32_t, float);
+      uint32_t body;
+      uint32_t marker;
+      float distance;
+    };
+
+    GeometricHash();
+    GeometricHash(GeometricHash const &) = delete;
+    GeometricHash &operator=(GeometricHash const &) = delete;
+    virtual ~GeometricHash();
+    void Build(std::vector<RigidBody> const &, float);
+    float GetMaxSquaredDistance() const;
+    Entry const *Lookup(float, uint32_t &) const;
+
+  private:
+    std::vector<uint32_t> m_binStarts;
+    std::vector<Entry> m_entries;
+    float m_binWidth;
+    float m_maxSquaredDistance;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_LOCALIZER_H
+#define PROXY_MINIATURE_LOCALIZER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/io/conference/ContainerConference.h>
+
+#include <odvdopendlvdata/GeneratedHeaders_ODVDOpenDLVData.h>
+
+#include "MarkerBuffer.h"
+#include "MarkerSearch.h"
+#include "PoseFilter.h"
+#include "PoseConsensus.h"
+#include "RigidBody.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Finds the configured bodies in a frame of markers and sends their poses
+ * to the given conference. It holds no conference of its own, so it runs
+ * both in the LPS module, on the QtmFrame containers, and in the Qualisys
+ * proxy, directly on the decoded packets. The configuration is read from
+ * the keys under the given prefix, and the same prefix is used for the log.
+ */
+class Localizer {
+  public:
+    Localizer();
+    Localizer(Localizer const &) = delete;
+    Localizer &operator=(Localizer const &) = delete;
+    virtual ~Localizer();
+    void SetUp(odcore::base::KeyValueConfiguration const &, 
+        std::string const &);
+    MarkerBuffer &GetMarkers();
+    void Locate(double, bool, odcore::io::conference::ContainerConference &);
+    void Predict(double, odcore::io::conference::ContainerConference &);
+    bool IsPredicting() const;
+    void ReportStatistics() const;
+
+  private:
+    static uint64_t const REPORT_INTERVAL;
+
+    opendlv::model::Cartesian3 ReadMarker(std::string const &, 
+        std::string const &) const;
+    std::vector<int32_t> ReadMarkerIds(
+        odcore::base::KeyValueConfiguration const &, std::string const &) const;
+    std::vector<RigidBody> ReadBodies(
+        odcore::base::KeyValueConfiguration const &) const;
+    void FindState(MarkerView const &, int32_t const *, uint32_t, double, 
+        std::chrono::steady_clock::time_point const &, 
+        odcore::io::conference::ContainerConference &);
+    void SendState(uint32_t, opendlv::model::Cartesian3 const &, 
+        opendlv::model::Cartesian3 const &, 
+        odcore::io::conference::ContainerConference &) const;
+    void SendVelocity(uint32_t, opendlv::model::Cartesian3 const &, float, 
+        odcore::io::conference::ContainerConference &) const;
+
+    std::string m_prefix;
+    MarkerBuffer m_markers;
+    MarkerSearch m_search;
+    PoseConsensus m_poseConsensus;
+    uint32_t m_minInlierCount;
+    float m_maxResidual;
+    float m_consensusTimeShare;
+    double m_framePeriod;
+    double m_lastFrameTime;
+    uint64_t m_droppedCount;
+    std::vector<PoseFilter> m_poseFilters;
+    bool m_useFilter;
+    bool m_sendPredictions;
+    double m_predictionTimeout;
+    bool m_debug;
+};
+
+}
+}
+}
+
+#endif
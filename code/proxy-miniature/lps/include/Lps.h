@@ -19,41 +19,42 @@
 #ifndef PROXY_MINIATURE_LPS_H
 #define PROXY_MINIATURE_LPS_H
 
-#include <memory>
+#include <opendavinci/odcore/base/Mutex.h>
+#include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
 
-#include <opendavinci/odcore/base/module/DataTriggeredConferenceClientModule.h>
-
-#include <odvdopendlvdata/GeneratedHeaders_ODVDOpenDLVData.h>
+#include "Localizer.h"
 
 namespace opendlv {
 namespace proxy {
 namespace miniature {
 
-class Lps : public odcore::base::module::DataTriggeredConferenceClientModule {
+/**
+ * Finds the configured bodies in the Qualisys frames and sends their poses.
+ * With the filter enabled the poses are smoothed and sent with velocities,
+ * and predicted poses are sent at the module frequency in between frames.
+ * The filters run on the time of the Qualisys frames, so a prediction is
+ * made for the time of the latest frame plus the local time that has passed
+ * since it was received.
+ */
+class Lps : public odcore::base::module::TimeTriggeredConferenceClientModule {
    public:
     Lps(int32_t const &, char **);
     Lps(Lps const &) = delete;
     Lps &operator=(Lps const &) = delete;
     virtual ~Lps();
+    virtual void nextContainer(odcore::data::Container &);
 
    private:
     virtual void setUp();
     virtual void tearDown();
-    virtual void nextContainer(odcore::data::Container &);
-    
-
-    void AnalyseNeedle(std::vector<opendlv::model::Cartesian3>);
-    void Search(std::vector<opendlv::model::Cartesian3>);
-    void FindState(std::vector<opendlv::model::Cartesian3>);
-
-    std::vector<float> m_needleMarkerDistances;
-    float m_needleNormRoll;
-    float m_needleNormPitch;
-    float m_needleNormYaw;
-    float m_searchMarginHalf;
-    int16_t m_frameId;
-    bool m_debug;
+    virtual odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
 
+    odcore::base::Mutex m_mutex;
+    Localizer m_localizer;
+    bool m_hasFrame;
+    double m_lastFrameTime;
+    odcore::data::TimeStamp m_lastFrameReceived;
 };
 
 } 
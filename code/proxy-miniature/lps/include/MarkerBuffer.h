@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_MARKERBUFFER_H
+#define PROXY_MINIATURE_MARKERBUFFER_H
+
+#include <vector>
+
+#include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
+
+#include "MarkerView.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * The markers of one frame as a structure of arrays, one array per axis.
+ * The buffer is meant to be reused from frame to frame, so that the arrays
+ * only grow when a frame has more markers than any earlier frame. The
+ * stages of the search see the buffer through a MarkerView.
+ */
+class MarkerBuffer {
+  public:
+    MarkerBuffer();
+    MarkerBuffer(MarkerBuffer const &) = delete;
+    MarkerBuffer &operator=(MarkerBuffer const &) = delete;
+    virtual ~MarkerBuffer();
+    void Add(float, float, float);
+    void Add(float, float, float, int32_t);
+    void Resize(uint32_t);
+    void Clear();
+    uint32_t GetCount() const;
+    opendlv::model::Cartesian3 GetMarker(uint32_t) const;
+    float const *GetX() const;
+    float const *GetY() const;
+    float const *GetZ() const;
+    int32_t const *GetIds() const;
+    float *GetX();
+    float *GetY();
+    float *GetZ();
+    int32_t *GetIds();
+    MarkerView GetView() const;
+
+  private:
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_z;
+    std::vector<int32_t> m_ids;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_MARKERSEARCH_H
+#define PROXY_MINIATURE_MARKERSEARCH_H
+
+#include <vector>
+
+#include "DistanceMatrix.h"
+#include "GeometricHash.h"
+#include "MarkerView.h"
+#include "MarkerTracker.h"
+#include "PoseSolver.h"
+#include "RigidBody.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Finds a library of rigid bodies among the markers of a frame. Every
+ * marker is tried as the origo, and the distance from it to every other
+ * marker is looked up in a geometric hash of the needle distances of all
+ * bodies. For each needle marker the frame marker with the distance closest
+ * to the needle distance is picked, and a body whose needle markers are all
+ * found gives a candidate. The cost of a frame does not grow with the
+ * number of bodies, only with the number of matching distances.
+ *
+ * Candidates that use a frame marker twice are rejected, and of the rest
+ * only the one where the body fits best, by the residual of its pose, is
+ * kept for each body.
+ *
+ * With tracking enabled, Track follows each body found in the last frame
+ * with a MarkerTracker, and only falls back to the full search when a body
+ * that was followed, or seen within MarkerTracker::MAX_TRACK_AGE, is not
+ * found. A body absent for longer, such as a robot off the arena, is only
+ * searched for once per MAX_TRACK_AGE, so it does not cost a full search in
+ * every frame. When the frame has marker ids from labelled 3D
+ * and every body has the ids of its markers, Label picks the markers by id
+ * and needs no search at all.
+ */
+class MarkerSearch {
+  public:
+    MarkerSearch();
+    MarkerSearch(MarkerSearch const &) = delete;
+    MarkerSearch &operator=(MarkerSearch const &) = delete;
+    virtual ~MarkerSearch();
+    void SetBodies(std::vector<RigidBody> const &, float);
+    void SetTracking(bool, float);
+    uint32_t Search(MarkerView const &);
+    uint32_t Track(MarkerView const &, double);
+    uint32_t Label(MarkerView const &, double);
+    bool HasLabels() const;
+    uint64_t GetFrameCount() const;
+    uint64_t GetFallbackCount() const;
+    uint64_t GetLabelledCount() const;
+    uint32_t GetCandidateCount() const;
+    uint32_t GetCandidateBody(uint32_t) const;
+    int32_t const *GetCandidate(uint32_t) const;
+    float GetCandidateResidual(uint32_t) const;
+    std::vector<RigidBody> const &GetBodies() const;
+    DistanceMatrix const &GetDistanceMatrix() const;
+
+  private:
+    void NextStamp();
+    static bool HasReusedMarker(int32_t const *, uint32_t);
+
+    void AddCandidate(uint32_t, int32_t const *);
+    void SelectCandidates(MarkerView const &);
+    void UpdateTracker(MarkerView const &, double);
+    void SetIdIndices(MarkerView const &, bool);
+
+    std::vector<RigidBody> m_bodies;
+    std::vector<uint32_t> m_bodyOffsets;
+    float m_searchMarginHalf;
+    GeometricHash m_hash;
+    DistanceMatrix m_distanceMatrix;
+    std::vector<float> m_foundErrors;
+    std::vector<int32_t> m_foundIndices;
+    std::vector<uint32_t> m_foundStamps;
+    std::vector<uint32_t> m_foundCounts;
+    std::vector<uint32_t> m_bodyStamps;
+    std::vector<uint32_t> m_touchedBodies;
+    uint32_t m_stamp;
+    std::vector<uint32_t> m_candidateBodies;
+    std::vector<uint32_t> m_candidateOffsets;
+    std::vector<int32_t> m_candidateIndices;
+    std::vector<float> m_candidateResiduals;
+    std::vector<uint32_t> m_selectedBodies;
+    std::vector<uint32_t> m_selectedOffsets;
+    std::vector<int32_t> m_selectedIndices;
+    std::vector<int32_t> m_bestCandidates;
+    std::vector<float> m_bestResiduals;
+    PoseSolver m_poseSolver;
+    MarkerTracker m_tracker;
+    bool m_tracking;
+    float m_trackingGate;
+    std::vector<int32_t> m_trackedIndices;
+    std::vector<uint8_t> m_bodyFound;
+    std::vector<double> m_lastSeenTimes;
+    double m_lastSearchTime;
+    uint64_t m_frameCount;
+    uint64_t m_fallbackCount;
+    bool m_hasLabels;
+    std::vector<int32_t> m_idIndices;
+    uint64_t m_labelledCount;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_MARKERTRACKER_H
+#define PROXY_MINIATURE_MARKERTRACKER_H
+
+#include <vector>
+
+#include "MarkerView.h"
+#include "RigidBody.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Keeps the markers of each body found in the last frame, with their
+ * velocities, and finds them again in the next frame by predicting where
+ * they moved with a constant velocity. A marker is first looked for at the
+ * frame index it had in the last frame and only if that is outside the gate
+ * among all markers, so a body that is followed costs a few distance checks
+ * per marker.
+ */
+class MarkerTracker {
+  public:
+    MarkerTracker();
+    MarkerTracker(MarkerTracker const &) = delete;
+    MarkerTracker &operator=(MarkerTracker const &) = delete;
+    virtual ~MarkerTracker();
+    void SetBodies(std::vector<RigidBody> const &, float, float);
+    bool Track(uint32_t, MarkerView const &, double, int32_t *) const;
+    void Update(uint32_t, MarkerView const &, int32_t const *, double);
+    void Lose(uint32_t);
+    bool IsTracking(uint32_t) const;
+
+    static double const MAX_TRACK_AGE;
+
+  private:
+    int32_t FindClosest(MarkerView const &, int32_t, float, float, float) 
+        const;
+
+    std::vector<RigidBody> m_bodies;
+    std::vector<uint32_t> m_bodyOffsets;
+    std::vector<uint8_t> m_tracking;
+    std::vector<double> m_times;
+    std::vector<int32_t> m_indices;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_z;
+    std::vector<float> m_vx;
+    std::vector<float> m_vy;
+    std::vector<float> m_vz;
+    float m_searchMarginHalf;
+    float m_squaredGate;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_MARKERVIEW_H
+#define PROXY_MINIATURE_MARKERVIEW_H
+
+#include <cstdint>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * A read-only view of the markers of one frame, as one array per axis and
+ * one of marker ids, which are -1 for a marker without a label. The
+ * view does not own the arrays, it is handed between the stages of the
+ * search so that no stage copies the markers.
+ */
+class MarkerView {
+  public:
+    MarkerView();
+    MarkerView(float const *, float const *, float const *, int32_t const *, 
+        uint32_t);
+    uint32_t GetCount() const;
+    float const *GetX() const;
+    float const *GetY() const;
+    float const *GetZ() const;
+    int32_t const *GetIds() const;
+
+  private:
+    float const *m_x;
+    float const *m_y;
+    float const *m_z;
+    int32_t const *m_ids;
+    uint32_t m_count;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_POSECONSENSUS_H
+#define PROXY_MINIATURE_POSECONSENSUS_H
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "MarkerView.h"
+#include "PoseSolver.h"
+#include "RigidBody.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * RANSAC over the marker correspondences of a candidate. Poses are fitted
+ * to random triples of corresponding markers, and the pose that has the
+ * most markers within the inlier threshold is fitted again to only those
+ * markers. A ghost marker or a reflection picked for one needle marker is
+ * then left out instead of pulling the pose. The number of tries is bounded
+ * both by a count and by a deadline, so a frame never takes longer than
+ * its share of the frame period.
+ */
+class PoseConsensus {
+  public:
+    PoseConsensus();
+    PoseConsensus(PoseConsensus const &) = delete;
+    PoseConsensus &operator=(PoseConsensus const &) = delete;
+    virtual ~PoseConsensus();
+    void SetThreshold(float);
+    void SetMaxIterations(uint32_t);
+    bool Fit(RigidBody const &, MarkerView const &, int32_t const *, 
+        std::chrono::steady_clock::time_point const &);
+    PoseSolver const &GetPose() const;
+    uint32_t GetInlierCount() const;
+    uint32_t GetIterationCount() const;
+
+  private:
+    uint32_t CountInliers(RigidBody const &, MarkerView const &, 
+        int32_t const *, std::vector<uint32_t> &) const;
+
+    PoseSolver m_poseSolver;
+    std::mt19937 m_randomGenerator;
+    std::vector<uint32_t> m_inliers;
+    std::vector<uint32_t> m_bestInliers;
+    float m_threshold;
+    uint32_t m_maxIterations;
+    uint32_t m_inlierCount;
+    uint32_t m_iterationCount;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_POSEFILTER_H
+#define PROXY_MINIATURE_POSEFILTER_H
+
+#include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Constant velocity Kalman filter of the pose of one body. The position
+ * axes and the yaw are filtered separately, each with a position and a
+ * velocity state, driven by white noise acceleration. Roll and pitch are
+ * passed through from the last measurement. Between measurements the
+ * filter predicts the pose at any later time.
+ */
+class PoseFilter {
+  public:
+    PoseFilter();
+    virtual ~PoseFilter();
+    void SetNoise(float, float, float, float);
+    void Correct(opendlv::model::Cartesian3 const &, 
+        opendlv::model::Cartesian3 const &, double);
+    void Predict(double, opendlv::model::Cartesian3 &, 
+        opendlv::model::Cartesian3 &, opendlv::model::Cartesian3 &, 
+        float &) const;
+    bool IsInitialised() const;
+    double GetTime() const;
+
+  private:
+    static uint32_t const AXIS_COUNT = 4;
+    static uint32_t const YAW = 3;
+    static double const RESET_TIME;
+    static double const INITIAL_VELOCITY_VARIANCE;
+
+    void Reset(double const (&)[AXIS_COUNT], double);
+    void PredictAxis(uint32_t, double, double &, double &, double (&)[3]) 
+        const;
+
+    double m_position[AXIS_COUNT];
+    double m_velocity[AXIS_COUNT];
+    double m_covariance[AXIS_COUNT][3];
+    double m_measurementVariance[AXIS_COUNT];
+    double m_accelerationVariance[AXIS_COUNT];
+    float m_roll;
+    float m_pitch;
+    double m_time;
+    bool m_isInitialised;
+};
+
+}
+}
+}
+
+#endif
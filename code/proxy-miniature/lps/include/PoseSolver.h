@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_POSESOLVER_H
+#define PROXY_MINIATURE_POSESOLVER_H
+
+#include "MarkerView.h"
+#include "RigidBody.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Least-squares rigid registration of a body onto its matched frame
+ * markers, using the closed-form unit quaternion solution by Horn. The
+ * quaternion is the eigenvector of the largest eigenvalue of a symmetric
+ * 4x4 matrix built from the cross-covariance of the centred marker sets,
+ * found with a few Jacobi sweeps. Everything is on the stack, so a solve
+ * does not allocate.
+ */
+class PoseSolver {
+  public:
+    PoseSolver();
+    PoseSolver(PoseSolver const &) = delete;
+    PoseSolver &operator=(PoseSolver const &) = delete;
+    virtual ~PoseSolver();
+    bool Solve(RigidBody const &, MarkerView const &, int32_t const *);
+    bool SolveSubset(RigidBody const &, MarkerView const &, int32_t const *, 
+        uint32_t const *, uint32_t);
+    float GetMarkerError(RigidBody const &, MarkerView const &, 
+        int32_t const *, uint32_t) const;
+    float GetX() const;
+    float GetY() const;
+    float GetZ() const;
+    float GetRoll() const;
+    float GetPitch() const;
+    float GetYaw() const;
+    float GetResidual() const;
+
+  private:
+    static uint32_t const MAX_SWEEPS;
+
+    static void GetBodyMarker(RigidBody const &, uint32_t, double (&)[3]);
+    static void GetFrameMarker(MarkerView const &, int32_t, double (&)[3]);
+    static void FindLargestEigenvector(double (&)[4][4], double (&)[4]);
+
+    bool Fit(RigidBody const &, MarkerView const &, int32_t const *, 
+        uint32_t const *, uint32_t);
+
+    double m_rotation[3][3];
+    double m_translation[3];
+    float m_residual;
+};
+
+}
+}
+}
+
+#endif
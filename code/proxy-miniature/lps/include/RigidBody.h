@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_RIGIDBODY_H
+#define PROXY_MINIATURE_RIGIDBODY_H
+
+#include <vector>
+
+#include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * A marker constellation to track. The markers are given relative to the
+ * origo marker, which is not part of the list, and the pose of the body is
+ * published with the frame id. If the markers are labelled in QTM, the
+ * label ids of the origo and then the needle markers may also be given.
+ */
+class RigidBody {
+  public:
+    RigidBody();
+    RigidBody(int16_t, std::vector<opendlv::model::Cartesian3> const &);
+    RigidBody(int16_t, std::vector<opendlv::model::Cartesian3> const &, 
+        std::vector<int32_t> const &);
+    int16_t GetFrameId() const;
+    std::vector<opendlv::model::Cartesian3> const &GetMarkers() const;
+    uint32_t GetMarkerCount() const;
+    float GetMarkerDistance(uint32_t) const;
+    bool HasMarkerIds() const;
+    std::vector<int32_t> const &GetMarkerIds() const;
+
+  private:
+    int16_t m_frameId;
+    std::vector<opendlv::model::Cartesian3> m_markers;
+    std::vector<float> m_markerDistances;
+    std::vector<int32_t> m_markerIds;
+};
+
+}
+}
+}
+
+#endif
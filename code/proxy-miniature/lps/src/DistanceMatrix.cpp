@@ -0,0 +1,115 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include "DistanceMatrix.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+DistanceMatrix::DistanceMatrix()
+    : m_squaredDistances()
+    , m_count(0)
+{
+}
+
+DistanceMatrix::~DistanceMatrix()
+{
+}
+
+/**
+ * Fills the matrix from the markers. Four columns are computed at a time
+ * with SIMD, and the remaining columns of each row one by one. Memory is
+ * only allocated when the frame has more markers than any earlier frame.
+ */
+void DistanceMatrix::Compute(MarkerView const &a_markers)
+{
+  m_count = a_markers.GetCount();
+  if (m_squaredDistances.size() < m_count * m_count) {
+    m_squaredDistances.resize(m_count * m_count);
+  }
+
+  float const *x = a_markers.GetX();
+  float const *y = a_markers.GetY();
+  float const *z = a_markers.GetZ();
+
+  for (uint32_t i = 0; i < m_count; i++) {
+    float *row = &m_squaredDistances[i * m_count];
+    uint32_t j = 0;
+
+#if defined(__SSE__)
+    __m128 const xi = _mm_set1_ps(x[i]);
+    __m128 const yi = _mm_set1_ps(y[i]);
+    __m128 const zi = _mm_set1_ps(z[i]);
+    for (; j + 4 <= m_count; j += 4) {
+      __m128 const dx = _mm_sub_ps(_mm_loadu_ps(x + j), xi);
+      __m128 const dy = _mm_sub_ps(_mm_loadu_ps(y + j), yi);
+      __m128 const dz = _mm_sub_ps(_mm_loadu_ps(z + j), zi);
+      __m128 const squaredDistance = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), 
+          _mm_mul_ps(dz, dz));
+      _mm_storeu_ps(row + j, squaredDistance);
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t const xi = vdupq_n_f32(x[i]);
+    float32x4_t const yi = vdupq_n_f32(y[i]);
+    float32x4_t const zi = vdupq_n_f32(z[i]);
+    for (; j + 4 <= m_count; j += 4) {
+      float32x4_t const dx = vsubq_f32(vld1q_f32(x + j), xi);
+      float32x4_t const dy = vsubq_f32(vld1q_f32(y + j), yi);
+      float32x4_t const dz = vsubq_f32(vld1q_f32(z + j), zi);
+      float32x4_t squaredDistance = vmulq_f32(dx, dx);
+      squaredDistance = vmlaq_f32(squaredDistance, dy, dy);
+      squaredDistance = vmlaq_f32(squaredDistance, dz, dz);
+      vst1q_f32(row + j, squaredDistance);
+    }
+#endif
+
+    for (; j < m_count; j++) {
+      float const dx = x[j] - x[i];
+      float const dy = y[j] - y[i];
+      float const dz = z[j] - z[i];
+      row[j] = dx * dx + dy * dy + dz * dz;
+    }
+  }
+}
+
+uint32_t DistanceMatrix::GetCount() const
+{
+  return m_count;
+}
+
+float const *DistanceMatrix::GetRow(uint32_t a_index) const
+{
+  return &m_squaredDistances[a_index * m_count];
+}
+
+float DistanceMatrix::GetSquaredDistance(uint32_t a_i, uint32_t a_j) const
+{
+  return m_squaredDistances[a_i * m_count + a_j];
+}
+
+}
+}
+}
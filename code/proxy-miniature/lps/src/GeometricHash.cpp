@@ -0,0 +1,126 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include "GeometricHash.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+GeometricHash::Entry::Entry()
+    : body(0)
+    , marker(0)
+    , distance(0.0f)
+{
+}
+
+GeometricHash::Entry::Entry(uint32_t a_body, uint32_t a_marker, 
+    float a_distance)
+    : body(a_body)
+    , marker(a_marker)
+    , distance(a_distance)
+{
+}
+
+GeometricHash::GeometricHash()
+    : m_binStarts()
+    , m_entries()
+    , m_binWidth(1.0f)
+    , m_maxSquaredDistance(0.0f)
+{
+}
+
+GeometricHash::~GeometricHash()
+{
+}
+
+/**
+ * Builds the table for the given bodies, where a frame distance matches a
+ * needle distance if they differ by less than half the search margin.
+ */
+void GeometricHash::Build(std::vector<RigidBody> const &a_bodies, 
+    float a_searchMargin)
+{
+  float const searchMarginHalf = 0.5f * a_searchMargin;
+  m_binWidth = (a_searchMargin > 0.0f) ? a_searchMargin : 1.0f;
+
+  float maxDistance = 0.0f;
+  for (auto const &body : a_bodies) {
+    for (uint32_t j = 0; j < body.GetMarkerCount(); j++) {
+      float const distance = body.GetMarkerDistance(j) + searchMarginHalf;
+      maxDistance = (distance > maxDistance) ? distance : maxDistance;
+    }
+  }
+  m_maxSquaredDistance = maxDistance * maxDistance;
+
+  uint32_t const binCount = 
+      static_cast<uint32_t>(std::floor(maxDistance / m_binWidth)) + 1;
+  std::vector<std::vector<Entry>> bins(binCount);
+  for (uint32_t i = 0; i < a_bodies.size(); i++) {
+    for (uint32_t j = 0; j < a_bodies[i].GetMarkerCount(); j++) {
+      float const distance = a_bodies[i].GetMarkerDistance(j);
+      float const lower = distance - searchMarginHalf;
+      float const upper = distance + searchMarginHalf;
+      uint32_t const firstBin = (lower > 0.0f) ? 
+          static_cast<uint32_t>(std::floor(lower / m_binWidth)) : 0;
+      uint32_t const lastBin = 
+          static_cast<uint32_t>(std::floor(upper / m_binWidth));
+      for (uint32_t k = firstBin; k <= lastBin && k < binCount; k++) {
+        bins[k].push_back(Entry(i, j, distance));
+      }
+    }
+  }
+
+  m_binStarts.assign(1, 0);
+  m_entries.clear();
+  for (auto const &bin : bins) {
+    m_entries.insert(m_entries.end(), bin.begin(), bin.end());
+    m_binStarts.push_back(static_cast<uint32_t>(m_entries.size()));
+  }
+}
+
+/**
+ * Frame distances with a square at or above this can not match any needle
+ * marker.
+ */
+float GeometricHash::GetMaxSquaredDistance() const
+{
+  return m_maxSquaredDistance;
+}
+
+/**
+ * The needle markers that may match the given distance, the number of them
+ * is written to the second argument. The caller checks the exact band.
+ */
+GeometricHash::Entry const *GeometricHash::Lookup(float a_distance, 
+    uint32_t &a_count) const
+{
+  uint32_t const bin = static_cast<uint32_t>(a_distance / m_binWidth);
+  if (bin + 1 >= m_binStarts.size()) {
+    a_count = 0;
+    return nullptr;
+  }
+  a_count = m_binStarts[bin + 1] - m_binStarts[bin];
+  return m_entries.data() + m_binStarts[bin];
+}
+
+}
+}
+}
@@ -0,0 +1,418 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/strings/StringToolbox.h>
+
+#include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
+
+#include "Localizer.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+uint64_t const Localizer::REPORT_INTERVAL = 600;
+
+Localizer::Localizer()
+    : m_prefix()
+    , m_markers()
+    , m_search()
+    , m_poseConsensus()
+    , m_minInlierCount(0)
+    , m_maxResidual(0.0f)
+    , m_consensusTimeShare(0.25f)
+    , m_framePeriod(1.0 / 60.0)
+    , m_lastFrameTime(0.0)
+    , m_droppedCount(0)
+    , m_poseFilters()
+    , m_useFilter(false)
+    , m_sendPredictions(false)
+    , m_predictionTimeout(0.1)
+    , m_debug(false)
+{
+}
+
+Localizer::~Localizer()
+{
+}
+
+/**
+ * Reads the configuration from the keys '<prefix>.searchMargin' and so on.
+ */
+void Localizer::SetUp(odcore::base::KeyValueConfiguration const &a_kv, 
+    std::string const &a_prefix)
+{
+  m_prefix = a_prefix;
+  m_debug = (a_kv.getValue<int32_t>(m_prefix + ".debug") == 1);
+
+  float const searchMargin = a_kv.getValue<float>(m_prefix + ".searchMargin");
+
+  std::vector<RigidBody> const bodies = ReadBodies(a_kv);
+  m_search.SetBodies(bodies, searchMargin);
+
+  bool hasTracking = false;
+  int32_t const tracking = a_kv.getOptionalValue<int32_t>(
+      m_prefix + ".tracking", hasTracking);
+  bool hasTrackingGate = false;
+  float const trackingGate = a_kv.getOptionalValue<float>(
+      m_prefix + ".trackingGate", hasTrackingGate);
+  m_search.SetTracking(!hasTracking || tracking == 1, 
+      hasTrackingGate ? trackingGate : 0.05f);
+
+  bool hasThreshold = false;
+  float const threshold = a_kv.getOptionalValue<float>(
+      m_prefix + ".inlierThreshold", hasThreshold);
+  m_poseConsensus.SetThreshold(hasThreshold ? threshold : searchMargin);
+  bool hasMaxIterations = false;
+  uint32_t const maxIterations = a_kv.getOptionalValue<uint32_t>(
+      m_prefix + ".consensusMaxIterations", hasMaxIterations);
+  m_poseConsensus.SetMaxIterations(hasMaxIterations ? maxIterations : 32);
+  bool hasTimeShare = false;
+  float const timeShare = a_kv.getOptionalValue<float>(
+      m_prefix + ".consensusTimeShare", hasTimeShare);
+  m_consensusTimeShare = hasTimeShare ? timeShare : 0.25f;
+  bool hasMinInlierCount = false;
+  uint32_t const minInlierCount = a_kv.getOptionalValue<uint32_t>(
+      m_prefix + ".minInlierCount", hasMinInlierCount);
+  m_minInlierCount = hasMinInlierCount ? minInlierCount : 3;
+  bool hasMaxResidual = false;
+  float const maxResidual = a_kv.getOptionalValue<float>(
+      m_prefix + ".maxResidual", hasMaxResidual);
+  m_maxResidual = hasMaxResidual ? maxResidual : 0.5f * searchMargin;
+
+  bool hasFilter = false;
+  int32_t const filter = a_kv.getOptionalValue<int32_t>(
+      m_prefix + ".filter", hasFilter);
+  m_useFilter = hasFilter && filter == 1;
+  m_poseFilters.assign(bodies.size(), PoseFilter());
+  if (m_useFilter) {
+    float const positionNoise = a_kv.getValue<float>(
+        m_prefix + ".filterPositionNoise");
+    float const yawNoise = a_kv.getValue<float>(
+        m_prefix + ".filterYawNoise");
+    float const accelerationNoise = a_kv.getValue<float>(
+        m_prefix + ".filterAccelerationNoise");
+    float const yawAccelerationNoise = a_kv.getValue<float>(
+        m_prefix + ".filterYawAccelerationNoise");
+    for (auto &poseFilter : m_poseFilters) {
+      poseFilter.SetNoise(positionNoise, yawNoise, accelerationNoise, 
+          yawAccelerationNoise);
+    }
+
+    bool hasPredict = false;
+    int32_t const predict = a_kv.getOptionalValue<int32_t>(
+        m_prefix + ".predict", hasPredict);
+    m_sendPredictions = hasPredict && predict == 1;
+    bool hasPredictionTimeout = false;
+    double const predictionTimeout = a_kv.getOptionalValue<double>(
+        m_prefix + ".predictTimeout", hasPredictionTimeout);
+    if (hasPredictionTimeout) {
+      m_predictionTimeout = predictionTimeout;
+    }
+  }
+}
+
+/**
+ * Reads a marker given as 'x,y,z'.
+ */
+opendlv::model::Cartesian3 Localizer::ReadMarker(std::string const &a_name, 
+    std::string const &a_markerString) const
+{
+  std::vector<std::string> const markerStringVector = 
+      odcore::strings::StringToolbox::split(a_markerString, ',');
+  if (markerStringVector.size() != 3) {
+    std::cerr << "[" << m_prefix << "] Keyvalue configuration of " << a_name
+        << " does not contain 3 values" << std::endl; 
+  }
+  opendlv::model::Cartesian3 marker(
+      std::stof(markerStringVector.at(0)), 
+      std::stof(markerStringVector.at(1)), 
+      std::stof(markerStringVector.at(2)));
+  return marker;
+}
+
+/**
+ * Reads the optional label ids of the markers of a body, given as
+ * 'origo,needle,needle,..'. An id is the index of the label in the QTM
+ * project, starting at 0. Empty if the key is not set.
+ */
+std::vector<int32_t> Localizer::ReadMarkerIds(
+    odcore::base::KeyValueConfiguration const &a_kv, 
+    std::string const &a_key) const
+{
+  std::vector<int32_t> markerIds;
+  bool hasMarkerIds = false;
+  std::string const markerIdsString = a_kv.getOptionalValue<std::string>(
+      a_key, hasMarkerIds);
+  if (hasMarkerIds) {
+    std::vector<std::string> const markerIdStrings = 
+        odcore::strings::StringToolbox::split(markerIdsString, ',');
+    for (auto const &markerIdString : markerIdStrings) {
+      markerIds.push_back(std::stoi(markerIdString));
+    }
+  }
+  return markerIds;
+}
+
+/**
+ * Reads the bodies to track. If 'bodies' lists frame ids, each body is
+ * given by its own 'body<frameId>.markers' as 'x,y,z;x,y,z;..' relative to
+ * the origo marker, and optionally 'body<frameId>.markerIds'. Otherwise a
+ * single body is read from the forward and leftward markers, and
+ * optionally 'markerIds'.
+ */
+std::vector<RigidBody> Localizer::ReadBodies(
+    odcore::base::KeyValueConfiguration const &a_kv) const
+{
+  std::vector<RigidBody> bodies;
+
+  bool hasBodies = false;
+  std::string const bodiesString = a_kv.getOptionalValue<std::string>(
+      m_prefix + ".bodies", hasBodies);
+  if (hasBodies) {
+    std::vector<std::string> const frameIdStrings = 
+        odcore::strings::StringToolbox::split(bodiesString, ',');
+    for (auto const &frameIdString : frameIdStrings) {
+      int16_t const frameId = static_cast<int16_t>(std::stoi(frameIdString));
+      std::string const key = m_prefix + ".body" + std::to_string(frameId);
+      std::vector<std::string> const markerStrings = 
+          odcore::strings::StringToolbox::split(
+          a_kv.getValue<std::string>(key + ".markers"), ';');
+      std::vector<opendlv::model::Cartesian3> needleMarkers;
+      for (auto const &markerString : markerStrings) {
+        needleMarkers.push_back(ReadMarker(key + ".markers", markerString));
+      }
+      std::vector<int32_t> const markerIds = ReadMarkerIds(a_kv, 
+          key + ".markerIds");
+      if (!markerIds.empty() && 
+          markerIds.size() != needleMarkers.size() + 1) {
+        std::cerr << "[" << m_prefix << "] Keyvalue configuration of body" 
+            << frameId << ".markerIds does not contain " 
+            << needleMarkers.size() + 1 << " values" << std::endl;
+      }
+      bodies.push_back(RigidBody(frameId, needleMarkers, markerIds));
+    }
+    return bodies;
+  }
+
+  int16_t const frameId = a_kv.getValue<int16_t>(m_prefix + ".frameId");
+  opendlv::model::Cartesian3 const forwardMarker = ReadMarker("forwardMarker", 
+      a_kv.getValue<std::string>(m_prefix + ".forwardMarker"));
+  opendlv::model::Cartesian3 const leftwardMarker = ReadMarker(
+      "leftwardMarker", 
+      a_kv.getValue<std::string>(m_prefix + ".leftwardMarker"));
+
+  std::vector<opendlv::model::Cartesian3> needleMarkers;
+  needleMarkers.push_back(forwardMarker);
+  needleMarkers.push_back(leftwardMarker);
+  bodies.push_back(RigidBody(frameId, needleMarkers, 
+      ReadMarkerIds(a_kv, m_prefix + ".markerIds")));
+  return bodies;
+}
+
+/**
+ * The buffer to put the markers of the next frame in before Locate.
+ */
+MarkerBuffer &Localizer::GetMarkers()
+{
+  return m_markers;
+}
+
+/**
+ * Finds the bodies in the markers of the buffer, from a frame taken at the
+ * given time in seconds, and sends their poses. The consensus of all bodies
+ * shares a deadline of a part of the frame period, measured from the frame
+ * timestamps. If the markers have label ids, the bodies are found by them.
+ */
+void Localizer::Locate(double a_time, bool a_hasMarkerIds, 
+    odcore::io::conference::ContainerConference &a_conference)
+{
+  double const deltaTime = a_time - m_lastFrameTime;
+  if (deltaTime > 0.0 && deltaTime < 1.0) {
+    m_framePeriod = 0.9 * m_framePeriod + 0.1 * deltaTime;
+  }
+  m_lastFrameTime = a_time;
+
+  std::chrono::steady_clock::time_point const deadline = 
+      std::chrono::steady_clock::now() + 
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(
+      static_cast<double>(m_consensusTimeShare) * m_framePeriod));
+
+  MarkerView const markers = m_markers.GetView();
+  uint32_t const candidateCount = (a_hasMarkerIds && m_search.HasLabels()) ?
+      m_search.Label(markers, a_time) : m_search.Track(markers, a_time);
+  for (uint32_t i = 0; i < candidateCount; i++) {
+    FindState(markers, m_search.GetCandidate(i), 
+        m_search.GetCandidateBody(i), a_time, deadline, a_conference);
+  }
+
+  if (m_debug && m_search.GetFrameCount() % REPORT_INTERVAL == 0) {
+    ReportStatistics();
+  }
+}
+
+/**
+ * Sends the predicted pose of every followed body at the given time.
+ * Nothing is sent for a body that has not been seen within the prediction
+ * timeout.
+ */
+void Localizer::Predict(double a_time, 
+    odcore::io::conference::ContainerConference &a_conference)
+{
+  for (uint32_t i = 0; i < m_poseFilters.size(); i++) {
+    PoseFilter const &poseFilter = m_poseFilters[i];
+    if (!poseFilter.IsInitialised() || 
+        a_time - poseFilter.GetTime() > m_predictionTimeout) {
+      continue;
+    }
+    opendlv::model::Cartesian3 position;
+    opendlv::model::Cartesian3 angularDisplacement;
+    opendlv::model::Cartesian3 velocity;
+    float yawRate;
+    poseFilter.Predict(a_time, position, angularDisplacement, velocity, 
+        yawRate);
+    SendState(i, position, angularDisplacement, a_conference);
+  }
+}
+
+/**
+ * If predicted poses should be sent in between frames.
+ */
+bool Localizer::IsPredicting() const
+{
+  return m_sendPredictions;
+}
+
+/**
+ * Prints the share of the frames where the bodies could not be followed
+ * from the last frame and the full search was needed, the number of frames
+ * where they were found by their labels, and the number of poses that were
+ * dropped as not trusted.
+ */
+void Localizer::ReportStatistics() const
+{
+  uint64_t const frameCount = m_search.GetFrameCount();
+  uint64_t const fallbackCount = m_search.GetFallbackCount();
+  double const fallbackRate = (frameCount > 0) ? 
+      static_cast<double>(fallbackCount) / static_cast<double>(frameCount) : 
+      0.0;
+  std::cout << "[" << m_prefix << "] Full search in " << fallbackCount 
+      << " of " << frameCount << " frames, fallback rate " << fallbackRate 
+      << ", " << m_search.GetLabelledCount() << " frames labelled, " 
+      << m_droppedCount << " poses dropped" << std::endl;
+}
+
+/**
+ * Registers the body onto the candidate markers and sends its pose, along
+ * with the number of inlier markers and the residual of the fit to them as
+ * a quality score. A pose with too few inliers or a too large residual is
+ * dropped, only its quality is sent. With the filter the filtered pose and
+ * the velocity are sent instead of the measured pose.
+ */
+void Localizer::FindState(MarkerView const &a_haystackMarkers, 
+    int32_t const *a_candidate, uint32_t a_body, double a_time, 
+    std::chrono::steady_clock::time_point const &a_deadline, 
+    odcore::io::conference::ContainerConference &a_conference)
+{
+  RigidBody const &body = m_search.GetBodies()[a_body];
+  bool const isFitted = m_poseConsensus.Fit(body, a_haystackMarkers, 
+      a_candidate, a_deadline);
+  PoseSolver const &pose = m_poseConsensus.GetPose();
+  uint32_t const inlierCount = m_poseConsensus.GetInlierCount();
+  float const residual = isFitted ? pose.GetResidual() : 0.0f;
+
+  opendlv::proxy::LpsQuality quality(body.GetFrameId(), residual, 
+      body.GetMarkerCount() + 1, inlierCount);
+  odcore::data::Container qualityContainer(quality);
+  a_conference.send(qualityContainer);
+
+  if (m_debug) {
+    std::cout << "[" << m_prefix << "] Frame id " << body.GetFrameId() 
+        << " inliers " << inlierCount << " residual " << residual 
+        << std::endl;
+  }
+  if (!isFitted || inlierCount < m_minInlierCount || 
+      residual > m_maxResidual) {
+    m_droppedCount++;
+    return;
+  }
+
+  opendlv::model::Cartesian3 position(pose.GetX(), pose.GetY(), 
+      pose.GetZ());
+  opendlv::model::Cartesian3 angularDisplacement(pose.GetRoll(), 
+      pose.GetPitch(), pose.GetYaw());
+  if (m_useFilter) {
+    PoseFilter &poseFilter = m_poseFilters[a_body];
+    poseFilter.Correct(position, angularDisplacement, a_time);
+    opendlv::model::Cartesian3 velocity;
+    float yawRate;
+    poseFilter.Predict(a_time, position, angularDisplacement, velocity, 
+        yawRate);
+    SendVelocity(a_body, velocity, yawRate, a_conference);
+  }
+  SendState(a_body, position, angularDisplacement, a_conference);
+}
+
+/**
+ * Sends the pose of a body, with the position in meters.
+ */
+void Localizer::SendState(uint32_t a_body, 
+    opendlv::model::Cartesian3 const &a_position, 
+    opendlv::model::Cartesian3 const &a_angularDisplacement, 
+    odcore::io::conference::ContainerConference &a_conference) const
+{
+  // For TME290, convert to decimeters
+  float const x0Scaled = a_position.getX() * 10.0f;
+  float const y0Scaled = a_position.getY() * 10.0f;
+  float const z0Scaled = a_position.getZ() * 10.0f;
+
+  opendlv::model::Cartesian3 position(x0Scaled, y0Scaled, z0Scaled);
+  opendlv::model::State state(position, a_angularDisplacement, 
+      m_search.GetBodies()[a_body].GetFrameId());
+  if (m_debug) {
+    std::cout << state.toString() << std::endl;
+  }
+  odcore::data::Container c(state);
+  a_conference.send(c);
+}
+
+/**
+ * Sends the velocity of a body, given in meters per second and scaled to
+ * decimeters per second like the position.
+ */
+void Localizer::SendVelocity(uint32_t a_body, 
+    opendlv::model::Cartesian3 const &a_velocity, float a_yawRate, 
+    odcore::io::conference::ContainerConference &a_conference) const
+{
+  opendlv::model::Cartesian3 velocity(a_velocity.getX() * 10.0f, 
+      a_velocity.getY() * 10.0f, a_velocity.getZ() * 10.0f);
+  opendlv::proxy::LpsVelocity lpsVelocity(
+      m_search.GetBodies()[a_body].GetFrameId(), velocity, a_yawRate);
+  odcore::data::Container c(lpsVelocity);
+  a_conference.send(c);
+}
+
+}
+}
+}
@@ -0,0 +1,138 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "MarkerBuffer.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+MarkerBuffer::MarkerBuffer()
+    : m_x()
+    , m_y()
+    , m_z()
+    , m_ids()
+{
+}
+
+MarkerBuffer::~MarkerBuffer()
+{
+}
+
+void MarkerBuffer::Add(float a_x, float a_y, float a_z)
+{
+  Add(a_x, a_y, a_z, -1);
+}
+
+/**
+ * Adds a marker with the id of its label.
+ */
+void MarkerBuffer::Add(float a_x, float a_y, float a_z, int32_t a_id)
+{
+  m_x.push_back(a_x);
+  m_y.push_back(a_y);
+  m_z.push_back(a_z);
+  m_ids.push_back(a_id);
+}
+
+/**
+ * Empties the buffer but keeps the memory.
+ */
+void MarkerBuffer::Clear()
+{
+  m_x.clear();
+  m_y.clear();
+  m_z.clear();
+  m_ids.clear();
+}
+
+/**
+ * Sets the number of markers, for filling the arrays in place. New markers
+ * are unset and have the id -1.
+ */
+void MarkerBuffer::Resize(uint32_t a_count)
+{
+  m_x.resize(a_count);
+  m_y.resize(a_count);
+  m_z.resize(a_count);
+  m_ids.resize(a_count, -1);
+}
+
+uint32_t MarkerBuffer::GetCount() const
+{
+  return static_cast<uint32_t>(m_x.size());
+}
+
+opendlv::model::Cartesian3 MarkerBuffer::GetMarker(uint32_t a_index) const
+{
+  return opendlv::model::Cartesian3(m_x[a_index], m_y[a_index], 
+      m_z[a_index]);
+}
+
+float const *MarkerBuffer::GetX() const
+{
+  return m_x.data();
+}
+
+float const *MarkerBuffer::GetY() const
+{
+  return m_y.data();
+}
+
+float const *MarkerBuffer::GetZ() const
+{
+  return m_z.data();
+}
+
+int32_t const *MarkerBuffer::GetIds() const
+{
+  return m_ids.data();
+}
+
+float *MarkerBuffer::GetX()
+{
+  return m_x.data();
+}
+
+float *MarkerBuffer::GetY()
+{
+  return m_y.data();
+}
+
+float *MarkerBuffer::GetZ()
+{
+  return m_z.data();
+}
+
+int32_t *MarkerBuffer::GetIds()
+{
+  return m_ids.data();
+}
+
+/**
+ * A view of the markers, valid until the next call to Add, Resize or Clear.
+ */
+MarkerView MarkerBuffer::GetView() const
+{
+  return MarkerView(m_x.data(), m_y.data(), m_z.data(), m_ids.data(), 
+      GetCount());
+}
+
+}
+}
+}
@@ -0,0 +1,489 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "MarkerSearch.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+MarkerSearch::MarkerSearch()
+    : m_bodies()
+    , m_bodyOffsets()
+    , m_searchMarginHalf(0.0f)
+    , m_hash()
+    , m_distanceMatrix()
+    , m_foundErrors()
+    , m_foundIndices()
+    , m_foundStamps()
+    , m_foundCounts()
+    , m_bodyStamps()
+    , m_touchedBodies()
+    , m_stamp(0)
+    , m_candidateBodies()
+    , m_candidateOffsets()
+    , m_candidateIndices()
+    , m_candidateResiduals()
+    , m_selectedBodies()
+    , m_selectedOffsets()
+    , m_selectedIndices()
+    , m_bestCandidates()
+    , m_bestResiduals()
+    , m_poseSolver()
+    , m_tracker()
+    , m_tracking(false)
+    , m_trackingGate(0.0f)
+    , m_trackedIndices()
+    , m_bodyFound()
+    , m_lastSeenTimes()
+    , m_lastSearchTime(-std::numeric_limits<double>::infinity())
+    , m_frameCount(0)
+    , m_fallbackCount(0)
+    , m_hasLabels(false)
+    , m_idIndices()
+    , m_labelledCount(0)
+{
+}
+
+MarkerSearch::~MarkerSearch()
+{
+}
+
+/**
+ * Sets the bodies to search for, and the width of the band around each
+ * needle distance that a frame distance must be in.
+ */
+void MarkerSearch::SetBodies(std::vector<RigidBody> const &a_bodies, 
+    float a_searchMargin)
+{
+  m_bodies = a_bodies;
+  m_searchMarginHalf = 0.5f * a_searchMargin;
+  m_hash.Build(m_bodies, a_searchMargin);
+
+  uint32_t needleMarkerCount = 0;
+  m_bodyOffsets.clear();
+  for (auto const &body : m_bodies) {
+    m_bodyOffsets.push_back(needleMarkerCount);
+    needleMarkerCount += body.GetMarkerCount();
+  }
+
+  m_foundErrors.assign(needleMarkerCount, 0.0f);
+  m_foundIndices.assign(needleMarkerCount, -1);
+  m_foundStamps.assign(needleMarkerCount, 0);
+  m_foundCounts.assign(m_bodies.size(), 0);
+  m_bodyStamps.assign(m_bodies.size(), 0);
+  m_touchedBodies.clear();
+  m_touchedBodies.reserve(m_bodies.size());
+  m_stamp = 0;
+
+  uint32_t maxNeedleMarkerCount = 0;
+  for (auto const &body : m_bodies) {
+    if (body.GetMarkerCount() > maxNeedleMarkerCount) {
+      maxNeedleMarkerCount = body.GetMarkerCount();
+    }
+  }
+  m_trackedIndices.assign(maxNeedleMarkerCount + 1, -1);
+  m_bodyFound.assign(m_bodies.size(), 0);
+  m_lastSeenTimes.assign(m_bodies.size(),
+      -std::numeric_limits<double>::infinity());
+  m_lastSearchTime = -std::numeric_limits<double>::infinity();
+
+  int32_t maxId = -1;
+  m_hasLabels = !m_bodies.empty();
+  for (auto const &body : m_bodies) {
+    m_hasLabels = m_hasLabels && body.HasMarkerIds();
+    for (int32_t id : body.GetMarkerIds()) {
+      maxId = std::max(maxId, id);
+    }
+  }
+  m_idIndices.assign(static_cast<uint32_t>(maxId + 1), -1);
+  m_bestCandidates.assign(m_bodies.size(), -1);
+  m_bestResiduals.assign(m_bodies.size(), 0.0f);
+  m_tracker.SetBodies(m_bodies, a_searchMargin, m_trackingGate);
+}
+
+/**
+ * Enables following the bodies between frames in Track, with the largest
+ * distance in meters that a marker may be from its predicted position.
+ */
+void MarkerSearch::SetTracking(bool a_tracking, float a_gate)
+{
+  m_tracking = a_tracking;
+  m_trackingGate = a_gate;
+  m_tracker.SetBodies(m_bodies, 2.0f * m_searchMarginHalf, m_trackingGate);
+}
+
+/**
+ * Searches the frame and returns the number of candidates found. The found
+ * needle markers of each origo are stamped rather than cleared, so trying
+ * an origo costs nothing for the bodies it does not match.
+ */
+uint32_t MarkerSearch::Search(MarkerView const &a_markers)
+{
+  m_candidateBodies.clear();
+  m_candidateOffsets.clear();
+  m_candidateIndices.clear();
+  m_distanceMatrix.Compute(a_markers);
+
+  uint32_t const markerCount = a_markers.GetCount();
+  float const maxSquaredDistance = m_hash.GetMaxSquaredDistance();
+
+  for (uint32_t i = 0; i < markerCount; i++) {
+    NextStamp();
+    m_touchedBodies.clear();
+    float const *squaredDistances = m_distanceMatrix.GetRow(i);
+
+    for (uint32_t k = 0; k < markerCount; k++) {
+      float const squaredDistance = squaredDistances[k];
+      if (k == i || squaredDistance >= maxSquaredDistance) {
+        continue;
+      }
+      float const distance = std::sqrt(squaredDistance);
+      uint32_t entryCount = 0;
+      GeometricHash::Entry const *entries = m_hash.Lookup(distance, 
+          entryCount);
+
+      for (uint32_t e = 0; e < entryCount; e++) {
+        GeometricHash::Entry const &entry = entries[e];
+        float const error = std::abs(distance - entry.distance);
+        if (error >= m_searchMarginHalf) {
+          continue;
+        }
+        uint32_t const slot = m_bodyOffsets[entry.body] + entry.marker;
+        if (m_foundStamps[slot] != m_stamp) {
+          if (m_bodyStamps[entry.body] != m_stamp) {
+            m_bodyStamps[entry.body] = m_stamp;
+            m_foundCounts[entry.body] = 0;
+            m_touchedBodies.push_back(entry.body);
+          }
+          m_foundStamps[slot] = m_stamp;
+          m_foundErrors[slot] = error;
+          m_foundIndices[slot] = static_cast<int32_t>(k);
+          m_foundCounts[entry.body]++;
+        } else if (error < m_foundErrors[slot]) {
+          m_foundErrors[slot] = error;
+          m_foundIndices[slot] = static_cast<int32_t>(k);
+        }
+      }
+    }
+
+    std::sort(m_touchedBodies.begin(), m_touchedBodies.end());
+    for (uint32_t body : m_touchedBodies) {
+      uint32_t const needleMarkerCount = m_bodies[body].GetMarkerCount();
+      int32_t const *found = &m_foundIndices[m_bodyOffsets[body]];
+      if (m_foundCounts[body] == needleMarkerCount && 
+          !HasReusedMarker(found, needleMarkerCount)) {
+        m_candidateBodies.push_back(body);
+        m_candidateOffsets.push_back(
+            static_cast<uint32_t>(m_candidateIndices.size()));
+        m_candidateIndices.push_back(static_cast<int32_t>(i));
+        m_candidateIndices.insert(m_candidateIndices.end(), found, 
+            found + needleMarkerCount);
+      }
+    }
+  }
+
+  SelectCandidates(a_markers);
+  return GetCandidateCount();
+}
+
+/**
+ * Finds the bodies in the frame at the given time, in seconds. Each body
+ * that was found in the last frame is looked for near its predicted
+ * position. The frame is searched in full only if a body is not found that
+ * was followed or seen within MAX_TRACK_AGE, or, for the bodies absent for
+ * longer, if it has not been searched within MAX_TRACK_AGE. The found
+ * bodies are followed from then on.
+ */
+uint32_t MarkerSearch::Track(MarkerView const &a_markers, double a_time)
+{
+  m_frameCount++;
+  if (!m_tracking) {
+    m_fallbackCount++;
+    m_lastSearchTime = a_time;
+    return Search(a_markers);
+  }
+
+  m_candidateBodies.clear();
+  m_candidateOffsets.clear();
+  m_candidateIndices.clear();
+
+  double const maxAge = MarkerTracker::MAX_TRACK_AGE;
+  bool const isSearchDue = (a_time - m_lastSearchTime >= maxAge 
+      || a_time < m_lastSearchTime);
+  uint32_t const bodyCount = static_cast<uint32_t>(m_bodies.size());
+  bool isSearched = false;
+  for (uint32_t body = 0; body < bodyCount; body++) {
+    if (m_tracker.Track(body, a_markers, a_time, m_trackedIndices.data())) {
+      AddCandidate(body, m_trackedIndices.data());
+    } else if (m_tracker.IsTracking(body) 
+        || a_time - m_lastSeenTimes[body] <= maxAge || isSearchDue) {
+      isSearched = true;
+    }
+  }
+
+  if (isSearched) {
+    m_fallbackCount++;
+    m_lastSearchTime = a_time;
+    Search(a_markers);
+  } else {
+    SelectCandidates(a_markers);
+  }
+
+  UpdateTracker(a_markers, a_time);
+  return GetCandidateCount();
+}
+
+/**
+ * Finds the bodies in a frame of labelled markers by their ids. A body is
+ * a candidate when the ids of all its markers are in the frame, and if
+ * that is not so for every body, which happens when a label is lost in
+ * QTM, the frame is given to Track instead.
+ */
+uint32_t MarkerSearch::Label(MarkerView const &a_markers, double a_time)
+{
+  if (!m_hasLabels || a_markers.GetIds() == nullptr) {
+    return Track(a_markers, a_time);
+  }
+
+  m_candidateBodies.clear();
+  m_candidateOffsets.clear();
+  m_candidateIndices.clear();
+
+  SetIdIndices(a_markers, true);
+  uint32_t const bodyCount = static_cast<uint32_t>(m_bodies.size());
+  bool isLabelled = true;
+  for (uint32_t body = 0; body < bodyCount && isLabelled; body++) {
+    std::vector<int32_t> const &ids = m_bodies[body].GetMarkerIds();
+    uint32_t const count = static_cast<uint32_t>(ids.size());
+    for (uint32_t j = 0; j < count && isLabelled; j++) {
+      m_trackedIndices[j] = (ids[j] < 0) ? -1 : m_idIndices[ids[j]];
+      isLabelled = (m_trackedIndices[j] != -1);
+    }
+    if (isLabelled) {
+      AddCandidate(body, m_trackedIndices.data());
+    }
+  }
+  SetIdIndices(a_markers, false);
+
+  if (!isLabelled) {
+    return Track(a_markers, a_time);
+  }
+
+  m_frameCount++;
+  m_labelledCount++;
+  SelectCandidates(a_markers);
+  UpdateTracker(a_markers, a_time);
+  return GetCandidateCount();
+}
+
+/**
+ * If every body has the ids of its markers, so that Label can be used.
+ */
+bool MarkerSearch::HasLabels() const
+{
+  return m_hasLabels;
+}
+
+/**
+ * The number of frames given to Track.
+ */
+uint64_t MarkerSearch::GetFrameCount() const
+{
+  return m_frameCount;
+}
+
+/**
+ * The number of frames given to Track that needed the full search.
+ */
+uint64_t MarkerSearch::GetFallbackCount() const
+{
+  return m_fallbackCount;
+}
+
+/**
+ * The number of frames where the bodies were found by their marker ids.
+ */
+uint64_t MarkerSearch::GetLabelledCount() const
+{
+  return m_labelledCount;
+}
+
+uint32_t MarkerSearch::GetCandidateCount() const
+{
+  return static_cast<uint32_t>(m_candidateBodies.size());
+}
+
+/**
+ * The index of the body that a candidate is for.
+ */
+uint32_t MarkerSearch::GetCandidateBody(uint32_t a_index) const
+{
+  return m_candidateBodies[a_index];
+}
+
+/**
+ * The marker indices of a candidate, first the origo and then one per
+ * needle marker of the body.
+ */
+int32_t const *MarkerSearch::GetCandidate(uint32_t a_index) const
+{
+  return &m_candidateIndices[m_candidateOffsets[a_index]];
+}
+
+/**
+ * The root mean square distance in meters between the body markers, moved
+ * to the pose that fits the candidate best, and the candidate markers.
+ */
+float MarkerSearch::GetCandidateResidual(uint32_t a_index) const
+{
+  return m_candidateResiduals[a_index];
+}
+
+std::vector<RigidBody> const &MarkerSearch::GetBodies() const
+{
+  return m_bodies;
+}
+
+DistanceMatrix const &MarkerSearch::GetDistanceMatrix() const
+{
+  return m_distanceMatrix;
+}
+
+void MarkerSearch::AddCandidate(uint32_t a_body, int32_t const *a_indices)
+{
+  m_candidateBodies.push_back(a_body);
+  m_candidateOffsets.push_back(
+      static_cast<uint32_t>(m_candidateIndices.size()));
+  m_candidateIndices.insert(m_candidateIndices.end(), a_indices, 
+      a_indices + m_bodies[a_body].GetMarkerCount() + 1);
+}
+
+/**
+ * Fits the pose of every candidate and keeps the one with the smallest
+ * residual for each body, in the order of the bodies.
+ */
+void MarkerSearch::SelectCandidates(MarkerView const &a_markers)
+{
+  std::fill(m_bestCandidates.begin(), m_bestCandidates.end(), -1);
+  uint32_t const candidateCount = GetCandidateCount();
+  for (uint32_t i = 0; i < candidateCount; i++) {
+    uint32_t const body = m_candidateBodies[i];
+    if (!m_poseSolver.Solve(m_bodies[body], a_markers, GetCandidate(i))) {
+      continue;
+    }
+    float const residual = m_poseSolver.GetResidual();
+    if (m_bestCandidates[body] == -1 || residual < m_bestResiduals[body]) {
+      m_bestCandidates[body] = static_cast<int32_t>(i);
+      m_bestResiduals[body] = residual;
+    }
+  }
+
+  m_selectedBodies.clear();
+  m_selectedOffsets.clear();
+  m_selectedIndices.clear();
+  m_candidateResiduals.clear();
+  uint32_t const bodyCount = static_cast<uint32_t>(m_bodies.size());
+  for (uint32_t body = 0; body < bodyCount; body++) {
+    if (m_bestCandidates[body] == -1) {
+      continue;
+    }
+    int32_t const *candidate = 
+        GetCandidate(static_cast<uint32_t>(m_bestCandidates[body]));
+    m_selectedBodies.push_back(body);
+    m_selectedOffsets.push_back(
+        static_cast<uint32_t>(m_selectedIndices.size()));
+    m_selectedIndices.insert(m_selectedIndices.end(), candidate, 
+        candidate + m_bodies[body].GetMarkerCount() + 1);
+    m_candidateResiduals.push_back(m_bestResiduals[body]);
+  }
+  m_candidateBodies.swap(m_selectedBodies);
+  m_candidateOffsets.swap(m_selectedOffsets);
+  m_candidateIndices.swap(m_selectedIndices);
+}
+
+/**
+ * Follows the bodies of the selected candidates, and loses the rest.
+ */
+void MarkerSearch::UpdateTracker(MarkerView const &a_markers, double a_time)
+{
+  std::fill(m_bodyFound.begin(), m_bodyFound.end(), 0);
+  uint32_t const candidateCount = GetCandidateCount();
+  for (uint32_t i = 0; i < candidateCount; i++) {
+    uint32_t const body = m_candidateBodies[i];
+    m_bodyFound[body] = 1;
+    m_lastSeenTimes[body] = a_time;
+    m_tracker.Update(body, a_markers, GetCandidate(i), a_time);
+  }
+  uint32_t const bodyCount = static_cast<uint32_t>(m_bodies.size());
+  for (uint32_t body = 0; body < bodyCount; body++) {
+    if (!m_bodyFound[body]) {
+      m_tracker.Lose(body);
+    }
+  }
+}
+
+/**
+ * Sets the frame index of every id in the frame that a body uses, or
+ * resets them again, so the table never has to be cleared in full.
+ */
+void MarkerSearch::SetIdIndices(MarkerView const &a_markers, bool a_isSet)
+{
+  int32_t const *ids = a_markers.GetIds();
+  int32_t const idCount = static_cast<int32_t>(m_idIndices.size());
+  uint32_t const markerCount = a_markers.GetCount();
+  for (uint32_t i = 0; i < markerCount; i++) {
+    if (ids[i] >= 0 && ids[i] < idCount) {
+      m_idIndices[ids[i]] = a_isSet ? static_cast<int32_t>(i) : -1;
+    }
+  }
+}
+
+/**
+ * If the same frame marker was picked for two needle markers, which
+ * happens when their origo distances are within the search margin.
+ */
+bool MarkerSearch::HasReusedMarker(int32_t const *a_indices, uint32_t a_count)
+{
+  for (uint32_t j = 1; j < a_count; j++) {
+    for (uint32_t k = 0; k < j; k++) {
+      if (a_indices[j] == a_indices[k]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void MarkerSearch::NextStamp()
+{
+  m_stamp++;
+  if (m_stamp == 0) {
+    std::fill(m_foundStamps.begin(), m_foundStamps.end(), 0);
+    std::fill(m_bodyStamps.begin(), m_bodyStamps.end(), 0);
+    m_stamp = 1;
+  }
+}
+
+}
+}
+}
@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include "MarkerTracker.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+double const MarkerTracker::MAX_TRACK_AGE = 0.2;
+
+MarkerTracker::MarkerTracker()
+    : m_bodies()
+    , m_bodyOffsets()
+    , m_tracking()
+    , m_times()
+    , m_indices()
+    , m_x()
+    , m_y()
+    , m_z()
+    , m_vx()
+    , m_vy()
+    , m_vz()
+    , m_searchMarginHalf(0.0f)
+    , m_squaredGate(0.0f)
+{
+}
+
+MarkerTracker::~MarkerTracker()
+{
+}
+
+/**
+ * Sets the bodies to follow, the search margin that the origo distances
+ * of a body must be within, and the largest distance in meters between a
+ * predicted and a found marker.
+ */
+void MarkerTracker::SetBodies(std::vector<RigidBody> const &a_bodies, 
+    float a_searchMargin, float a_gate)
+{
+  m_bodies = a_bodies;
+  m_searchMarginHalf = 0.5f * a_searchMargin;
+  m_squaredGate = a_gate * a_gate;
+
+  uint32_t markerCount = 0;
+  m_bodyOffsets.clear();
+  for (auto const &body : m_bodies) {
+    m_bodyOffsets.push_back(markerCount);
+    markerCount += body.GetMarkerCount() + 1;
+  }
+
+  m_tracking.assign(m_bodies.size(), 0);
+  m_times.assign(m_bodies.size(), 0.0);
+  m_indices.assign(markerCount, -1);
+  m_x.assign(markerCount, 0.0f);
+  m_y.assign(markerCount, 0.0f);
+  m_z.assign(markerCount, 0.0f);
+  m_vx.assign(markerCount, 0.0f);
+  m_vy.assign(markerCount, 0.0f);
+  m_vz.assign(markerCount, 0.0f);
+}
+
+/**
+ * Finds the body in the frame at the given time, in seconds. On success the
+ * frame indices of the origo and the needle markers are written to the
+ * given array, in the same layout as a search candidate.
+ */
+bool MarkerTracker::Track(uint32_t a_body, MarkerView const &a_markers, 
+    double a_time, int32_t *a_indices) const
+{
+  if (!m_tracking[a_body]) {
+    return false;
+  }
+  double const deltaTime = a_time - m_times[a_body];
+  if (deltaTime < 0.0 || deltaTime > MAX_TRACK_AGE) {
+    return false;
+  }
+  float const dt = static_cast<float>(deltaTime);
+
+  RigidBody const &body = m_bodies[a_body];
+  uint32_t const markerCount = body.GetMarkerCount() + 1;
+  uint32_t const offset = m_bodyOffsets[a_body];
+  for (uint32_t j = 0; j < markerCount; j++) {
+    uint32_t const slot = offset + j;
+    int32_t const index = FindClosest(a_markers, m_indices[slot], 
+        m_x[slot] + m_vx[slot] * dt, m_y[slot] + m_vy[slot] * dt, 
+        m_z[slot] + m_vz[slot] * dt);
+    if (index == -1) {
+      return false;
+    }
+    for (uint32_t k = 0; k < j; k++) {
+      if (a_indices[k] == index) {
+        return false;
+      }
+    }
+    a_indices[j] = index;
+  }
+
+  float const x0 = a_markers.GetX()[a_indices[0]];
+  float const y0 = a_markers.GetY()[a_indices[0]];
+  float const z0 = a_markers.GetZ()[a_indices[0]];
+  for (uint32_t j = 1; j < markerCount; j++) {
+    float const dx = a_markers.GetX()[a_indices[j]] - x0;
+    float const dy = a_markers.GetY()[a_indices[j]] - y0;
+    float const dz = a_markers.GetZ()[a_indices[j]] - z0;
+    float const distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (std::abs(distance - body.GetMarkerDistance(j - 1)) >= 
+        m_searchMarginHalf) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Stores the markers of the body found at the given time. If the body was
+ * followed the marker velocities are estimated from the last frame.
+ */
+void MarkerTracker::Update(uint32_t a_body, MarkerView const &a_markers, 
+    int32_t const *a_indices, double a_time)
+{
+  double const deltaTime = a_time - m_times[a_body];
+  bool const hasVelocity = m_tracking[a_body] && deltaTime > 0.0 && 
+      deltaTime <= MAX_TRACK_AGE;
+  float const rate = hasVelocity ? static_cast<float>(1.0 / deltaTime) : 0.0f;
+
+  uint32_t const markerCount = m_bodies[a_body].GetMarkerCount() + 1;
+  uint32_t const offset = m_bodyOffsets[a_body];
+  for (uint32_t j = 0; j < markerCount; j++) {
+    uint32_t const slot = offset + j;
+    float const x = a_markers.GetX()[a_indices[j]];
+    float const y = a_markers.GetY()[a_indices[j]];
+    float const z = a_markers.GetZ()[a_indices[j]];
+    m_vx[slot] = (x - m_x[slot]) * rate;
+    m_vy[slot] = (y - m_y[slot]) * rate;
+    m_vz[slot] = (z - m_z[slot]) * rate;
+    m_x[slot] = x;
+    m_y[slot] = y;
+    m_z[slot] = z;
+    m_indices[slot] = a_indices[j];
+  }
+  m_times[a_body] = a_time;
+  m_tracking[a_body] = 1;
+}
+
+void MarkerTracker::Lose(uint32_t a_body)
+{
+  m_tracking[a_body] = 0;
+}
+
+bool MarkerTracker::IsTracking(uint32_t a_body) const
+{
+  return m_tracking[a_body];
+}
+
+/**
+ * The index of the marker closest to the predicted position and inside the
+ * gate, or -1. The marker at the index it had in the last frame is taken
+ * without a scan if it is within half the gate, which is the common case as
+ * long as the order of the markers in the frames is kept.
+ */
+int32_t MarkerTracker::FindClosest(MarkerView const &a_markers, 
+    int32_t a_hint, float a_x, float a_y, float a_z) const
+{
+  float const *x = a_markers.GetX();
+  float const *y = a_markers.GetY();
+  float const *z = a_markers.GetZ();
+  int32_t const markerCount = static_cast<int32_t>(a_markers.GetCount());
+
+  if (a_hint >= 0 && a_hint < markerCount) {
+    float const dx = x[a_hint] - a_x;
+    float const dy = y[a_hint] - a_y;
+    float const dz = z[a_hint] - a_z;
+    if (dx * dx + dy * dy + dz * dz < 0.25f * m_squaredGate) {
+      return a_hint;
+    }
+  }
+
+  int32_t closest = -1;
+  float closestSquaredDistance = m_squaredGate;
+  for (int32_t i = 0; i < markerCount; i++) {
+    float const dx = x[i] - a_x;
+    float const dy = y[i] - a_y;
+    float const dz = z[i] - a_z;
+    float const squaredDistance = dx * dx + dy * dy + dz * dz;
+    if (squaredDistance < closestSquaredDistance) {
+      closest = i;
+      closestSquaredDistance = squaredDistance;
+    }
+  }
+  return closest;
+}
+
+}
+}
+}
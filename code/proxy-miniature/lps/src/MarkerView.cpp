@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "MarkerView.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+MarkerView::MarkerView()
+    : m_x(nullptr)
+    , m_y(nullptr)
+    , m_z(nullptr)
+    , m_ids(nullptr)
+    , m_count(0)
+{
+}
+
+MarkerView::MarkerView(float const *a_x, float const *a_y, float const *a_z, 
+    int32_t const *a_ids, uint32_t a_count)
+    : m_x(a_x)
+    , m_y(a_y)
+    , m_z(a_z)
+    , m_ids(a_ids)
+    , m_count(a_count)
+{
+}
+
+uint32_t MarkerView::GetCount() const
+{
+  return m_count;
+}
+
+float const *MarkerView::GetX() const
+{
+  return m_x;
+}
+
+float const *MarkerView::GetY() const
+{
+  return m_y;
+}
+
+float const *MarkerView::GetZ() const
+{
+  return m_z;
+}
+
+int32_t const *MarkerView::GetIds() const
+{
+  return m_ids;
+}
+
+}
+}
+}
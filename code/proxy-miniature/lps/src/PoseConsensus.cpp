@@ -0,0 +1,163 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "PoseConsensus.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+PoseConsensus::PoseConsensus()
+    : m_poseSolver()
+    , m_randomGenerator(0)
+    , m_inliers()
+    , m_bestInliers()
+    , m_threshold(0.01f)
+    , m_maxIterations(32)
+    , m_inlierCount(0)
+    , m_iterationCount(0)
+{
+}
+
+PoseConsensus::~PoseConsensus()
+{
+}
+
+/**
+ * The largest distance in meters between a moved body marker and its
+ * frame marker for the marker to count as an inlier.
+ */
+void PoseConsensus::SetThreshold(float a_threshold)
+{
+  m_threshold = a_threshold;
+}
+
+void PoseConsensus::SetMaxIterations(uint32_t a_maxIterations)
+{
+  m_maxIterations = a_maxIterations;
+}
+
+/**
+ * Fits the pose of the body to the candidate markers. The first try is
+ * always made, further tries only until the deadline. Returns false if no
+ * pose was found, and otherwise the pose is fitted to the inliers of the
+ * best try.
+ */
+bool PoseConsensus::Fit(RigidBody const &a_body, MarkerView const &a_markers,
+    int32_t const *a_indices, 
+    std::chrono::steady_clock::time_point const &a_deadline)
+{
+  uint32_t const markerCount = a_body.GetMarkerCount() + 1;
+  m_inlierCount = 0;
+  m_iterationCount = 0;
+  if (markerCount < 3) {
+    return false;
+  }
+  if (m_inliers.size() < markerCount) {
+    m_inliers.resize(markerCount);
+    m_bestInliers.resize(markerCount);
+  }
+
+  // With three markers every triple is the full set.
+  if (markerCount == 3) {
+    m_iterationCount = 1;
+    if (!m_poseSolver.Solve(a_body, a_markers, a_indices)) {
+      return false;
+    }
+    m_inlierCount = CountInliers(a_body, a_markers, a_indices, m_inliers);
+    return true;
+  }
+
+  std::uniform_int_distribution<uint32_t> slotDistribution(0, 
+      markerCount - 1);
+  uint32_t bestCount = 0;
+  while (m_iterationCount < m_maxIterations && bestCount < markerCount && 
+      (m_iterationCount == 0 || 
+       std::chrono::steady_clock::now() < a_deadline)) {
+    m_iterationCount++;
+
+    uint32_t sample[3];
+    sample[0] = slotDistribution(m_randomGenerator);
+    do {
+      sample[1] = slotDistribution(m_randomGenerator);
+    } while (sample[1] == sample[0]);
+    do {
+      sample[2] = slotDistribution(m_randomGenerator);
+    } while (sample[2] == sample[0] || sample[2] == sample[1]);
+
+    if (!m_poseSolver.SolveSubset(a_body, a_markers, a_indices, sample, 3)) {
+      continue;
+    }
+    uint32_t const count = CountInliers(a_body, a_markers, a_indices, 
+        m_inliers);
+    if (count > bestCount) {
+      bestCount = count;
+      m_bestInliers.swap(m_inliers);
+    }
+  }
+
+  if (bestCount < 3 || !m_poseSolver.SolveSubset(a_body, a_markers, 
+        a_indices, m_bestInliers.data(), bestCount)) {
+    return false;
+  }
+  m_inlierCount = CountInliers(a_body, a_markers, a_indices, m_inliers);
+  return true;
+}
+
+/**
+ * The pose fitted to the inliers, where the residual is over the inliers
+ * only.
+ */
+PoseSolver const &PoseConsensus::GetPose() const
+{
+  return m_poseSolver;
+}
+
+/**
+ * The number of body markers, origo included, within the threshold of the
+ * fitted pose.
+ */
+uint32_t PoseConsensus::GetInlierCount() const
+{
+  return m_inlierCount;
+}
+
+uint32_t PoseConsensus::GetIterationCount() const
+{
+  return m_iterationCount;
+}
+
+uint32_t PoseConsensus::CountInliers(RigidBody const &a_body, 
+    MarkerView const &a_markers, int32_t const *a_indices, 
+    std::vector<uint32_t> &a_inliers) const
+{
+  uint32_t const markerCount = a_body.GetMarkerCount() + 1;
+  uint32_t count = 0;
+  for (uint32_t j = 0; j < markerCount; j++) {
+    if (m_poseSolver.GetMarkerError(a_body, a_markers, a_indices, j) < 
+        m_threshold) {
+      a_inliers[count] = j;
+      count++;
+    }
+  }
+  return count;
+}
+
+}
+}
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include "PoseFilter.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+double const PoseFilter::RESET_TIME = 1.0;
+double const PoseFilter::INITIAL_VELOCITY_VARIANCE = 1.0;
+
+PoseFilter::PoseFilter()
+    : m_position()
+    , m_velocity()
+    , m_covariance()
+    , m_measurementVariance()
+    , m_accelerationVariance()
+    , m_roll(0.0f)
+    , m_pitch(0.0f)
+    , m_time(0.0)
+    , m_isInitialised(false)
+{
+  SetNoise(0.002f, 0.01f, 2.0f, 10.0f);
+}
+
+PoseFilter::~PoseFilter()
+{
+}
+
+/**
+ * Sets the standard deviations of the measured position in meters and yaw
+ * in radians, and of the acceleration in meters per second squared and
+ * the yaw acceleration in radians per second squared.
+ */
+void PoseFilter::SetNoise(float a_positionStd, float a_yawStd, 
+    float a_accelerationStd, float a_yawAccelerationStd)
+{
+  for (uint32_t k = 0; k < YAW; k++) {
+    m_measurementVariance[k] = static_cast<double>(a_positionStd) * 
+        static_cast<double>(a_positionStd);
+    m_accelerationVariance[k] = static_cast<double>(a_accelerationStd) * 
+        static_cast<double>(a_accelerationStd);
+  }
+  m_measurementVariance[YAW] = static_cast<double>(a_yawStd) * 
+      static_cast<double>(a_yawStd);
+  m_accelerationVariance[YAW] = static_cast<double>(a_yawAccelerationStd) * 
+      static_cast<double>(a_yawAccelerationStd);
+}
+
+/**
+ * Updates the filter with a measured pose at the given time in seconds.
+ * The first measurement, or one after a long gap, restarts the filter at
+ * rest. A measurement older than the filter only updates it, without
+ * moving it back in time.
+ */
+void PoseFilter::Correct(opendlv::model::Cartesian3 const &a_position, 
+    opendlv::model::Cartesian3 const &a_angularDisplacement, double a_time)
+{
+  double const measurement[AXIS_COUNT] = {
+    static_cast<double>(a_position.getX()), 
+    static_cast<double>(a_position.getY()), 
+    static_cast<double>(a_position.getZ()), 
+    static_cast<double>(a_angularDisplacement.getZ())};
+  m_roll = a_angularDisplacement.getX();
+  m_pitch = a_angularDisplacement.getY();
+
+  if (!m_isInitialised || a_time - m_time > RESET_TIME) {
+    Reset(measurement, a_time);
+    return;
+  }
+
+  double const deltaTime = (a_time > m_time) ? a_time - m_time : 0.0;
+  for (uint32_t k = 0; k < AXIS_COUNT; k++) {
+    double position;
+    double velocity;
+    double p[3];
+    PredictAxis(k, deltaTime, position, velocity, p);
+
+    double innovation = measurement[k] - position;
+    if (k == YAW) {
+      innovation = std::atan2(std::sin(innovation), std::cos(innovation));
+    }
+    double const s = p[0] + m_measurementVariance[k];
+    double const k0 = p[0] / s;
+    double const k1 = p[1] / s;
+
+    position += k0 * innovation;
+    velocity += k1 * innovation;
+    if (k == YAW) {
+      position = std::atan2(std::sin(position), std::cos(position));
+    }
+    m_position[k] = position;
+    m_velocity[k] = velocity;
+    m_covariance[k][0] = (1.0 - k0) * p[0];
+    m_covariance[k][1] = (1.0 - k0) * p[1];
+    m_covariance[k][2] = p[2] - k1 * p[1];
+  }
+  if (a_time > m_time) {
+    m_time = a_time;
+  }
+}
+
+/**
+ * The pose, velocity, and yaw rate predicted at the given time in seconds,
+ * which is normally later than the last measurement.
+ */
+void PoseFilter::Predict(double a_time, 
+    opendlv::model::Cartesian3 &a_position, 
+    opendlv::model::Cartesian3 &a_angularDisplacement, 
+    opendlv::model::Cartesian3 &a_velocity, float &a_yawRate) const
+{
+  double const deltaTime = (a_time > m_time) ? a_time - m_time : 0.0;
+  double position[AXIS_COUNT];
+  double velocity[AXIS_COUNT];
+  for (uint32_t k = 0; k < AXIS_COUNT; k++) {
+    position[k] = m_position[k] + m_velocity[k] * deltaTime;
+    velocity[k] = m_velocity[k];
+  }
+  double const yaw = std::atan2(std::sin(position[YAW]), 
+      std::cos(position[YAW]));
+
+  a_position = opendlv::model::Cartesian3(static_cast<float>(position[0]), 
+      static_cast<float>(position[1]), static_cast<float>(position[2]));
+  a_angularDisplacement = opendlv::model::Cartesian3(m_roll, m_pitch, 
+      static_cast<float>(yaw));
+  a_velocity = opendlv::model::Cartesian3(static_cast<float>(velocity[0]), 
+      static_cast<float>(velocity[1]), static_cast<float>(velocity[2]));
+  a_yawRate = static_cast<float>(velocity[YAW]);
+}
+
+bool PoseFilter::IsInitialised() const
+{
+  return m_isInitialised;
+}
+
+/**
+ * The time in seconds of the latest measurement.
+ */
+double PoseFilter::GetTime() const
+{
+  return m_time;
+}
+
+void PoseFilter::Reset(double const (&a_measurement)[AXIS_COUNT], 
+    double a_time)
+{
+  for (uint32_t k = 0; k < AXIS_COUNT; k++) {
+    m_position[k] = a_measurement[k];
+    m_velocity[k] = 0.0;
+    m_covariance[k][0] = m_measurementVariance[k];
+    m_covariance[k][1] = 0.0;
+    m_covariance[k][2] = INITIAL_VELOCITY_VARIANCE;
+  }
+  m_time = a_time;
+  m_isInitialised = true;
+}
+
+/**
+ * Moves one axis forward in time. The covariance is given as its upper
+ * triangle, position variance, covariance, and velocity variance.
+ */
+void PoseFilter::PredictAxis(uint32_t a_axis, double a_deltaTime, 
+    double &a_position, double &a_velocity, double (&a_covariance)[3]) const
+{
+  double const dt = a_deltaTime;
+  double const q = m_accelerationVariance[a_axis];
+  double const *p = m_covariance[a_axis];
+
+  a_position = m_position[a_axis] + m_velocity[a_axis] * dt;
+  a_velocity = m_velocity[a_axis];
+  a_covariance[0] = p[0] + 2.0 * dt * p[1] + dt * dt * p[2] + 
+      0.25 * q * dt * dt * dt * dt;
+  a_covariance[1] = p[1] + dt * p[2] + 0.5 * q * dt * dt * dt;
+  a_covariance[2] = p[2] + q * dt * dt;
+}
+
+}
+}
+}
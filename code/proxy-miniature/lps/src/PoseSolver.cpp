@@ -0,0 +1,321 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include "PoseSolver.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+uint32_t const PoseSolver::MAX_SWEEPS = 16;
+
+PoseSolver::PoseSolver()
+    : m_rotation()
+    , m_translation()
+    , m_residual(0.0f)
+{
+  m_rotation[0][0] = 1.0;
+  m_rotation[1][1] = 1.0;
+  m_rotation[2][2] = 1.0;
+}
+
+PoseSolver::~PoseSolver()
+{
+}
+
+/**
+ * Finds the rotation and translation that best move the body, origo first
+ * and then the needle markers, onto the frame markers with the given
+ * indices in the same order. The residual is the root mean square distance
+ * in meters between the moved body markers and the frame markers. Returns
+ * false if the markers do not determine a pose.
+ */
+bool PoseSolver::Solve(RigidBody const &a_body, MarkerView const &a_markers,
+    int32_t const *a_indices)
+{
+  return Fit(a_body, a_markers, a_indices, nullptr, 
+      a_body.GetMarkerCount() + 1);
+}
+
+/**
+ * As Solve, but only using the given body markers, where 0 is the origo
+ * and j the needle marker j - 1. At least three are needed.
+ */
+bool PoseSolver::SolveSubset(RigidBody const &a_body, 
+    MarkerView const &a_markers, int32_t const *a_indices, 
+    uint32_t const *a_slots, uint32_t a_slotCount)
+{
+  return Fit(a_body, a_markers, a_indices, a_slots, a_slotCount);
+}
+
+/**
+ * The distance in meters between the given body marker, moved to the last
+ * solved pose, and its frame marker.
+ */
+float PoseSolver::GetMarkerError(RigidBody const &a_body, 
+    MarkerView const &a_markers, int32_t const *a_indices, uint32_t a_slot) 
+    const
+{
+  double p[3];
+  double q[3];
+  GetBodyMarker(a_body, a_slot, p);
+  GetFrameMarker(a_markers, a_indices[a_slot], q);
+  double squaredError = 0.0;
+  for (uint32_t a = 0; a < 3; a++) {
+    double const error = m_rotation[a][0] * p[0] + m_rotation[a][1] * p[1] 
+        + m_rotation[a][2] * p[2] + m_translation[a] - q[a];
+    squaredError += error * error;
+  }
+  return static_cast<float>(std::sqrt(squaredError));
+}
+
+bool PoseSolver::Fit(RigidBody const &a_body, MarkerView const &a_markers, 
+    int32_t const *a_indices, uint32_t const *a_slots, uint32_t a_slotCount)
+{
+  if (a_slotCount < 3) {
+    return false;
+  }
+
+  double bodyMean[3] = {0.0, 0.0, 0.0};
+  double frameMean[3] = {0.0, 0.0, 0.0};
+  for (uint32_t i = 0; i < a_slotCount; i++) {
+    uint32_t const slot = (a_slots == nullptr) ? i : a_slots[i];
+    double p[3];
+    double q[3];
+    GetBodyMarker(a_body, slot, p);
+    GetFrameMarker(a_markers, a_indices[slot], q);
+    for (uint32_t k = 0; k < 3; k++) {
+      bodyMean[k] += p[k];
+      frameMean[k] += q[k];
+    }
+  }
+  for (uint32_t k = 0; k < 3; k++) {
+    bodyMean[k] /= a_slotCount;
+    frameMean[k] /= a_slotCount;
+  }
+
+  double s[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+  for (uint32_t i = 0; i < a_slotCount; i++) {
+    uint32_t const slot = (a_slots == nullptr) ? i : a_slots[i];
+    double p[3];
+    double q[3];
+    GetBodyMarker(a_body, slot, p);
+    GetFrameMarker(a_markers, a_indices[slot], q);
+    for (uint32_t a = 0; a < 3; a++) {
+      for (uint32_t b = 0; b < 3; b++) {
+        s[a][b] += (p[a] - bodyMean[a]) * (q[b] - frameMean[b]);
+      }
+    }
+  }
+
+  double n[4][4] = {
+    {s[0][0] + s[1][1] + s[2][2], s[1][2] - s[2][1], s[2][0] - s[0][2], 
+      s[0][1] - s[1][0]},
+    {s[1][2] - s[2][1], s[0][0] - s[1][1] - s[2][2], s[0][1] + s[1][0], 
+      s[2][0] + s[0][2]},
+    {s[2][0] - s[0][2], s[0][1] + s[1][0], -s[0][0] + s[1][1] - s[2][2], 
+      s[1][2] + s[2][1]},
+    {s[0][1] - s[1][0], s[2][0] + s[0][2], s[1][2] + s[2][1], 
+      -s[0][0] - s[1][1] + s[2][2]}};
+
+  double quaternion[4];
+  FindLargestEigenvector(n, quaternion);
+  double const norm = std::sqrt(quaternion[0] * quaternion[0] + 
+      quaternion[1] * quaternion[1] + quaternion[2] * quaternion[2] + 
+      quaternion[3] * quaternion[3]);
+  if (!(norm > 0.0)) {
+    return false;
+  }
+  double const qw = quaternion[0] / norm;
+  double const qx = quaternion[1] / norm;
+  double const qy = quaternion[2] / norm;
+  double const qz = quaternion[3] / norm;
+
+  m_rotation[0][0] = 1.0 - 2.0 * (qy * qy + qz * qz);
+  m_rotation[0][1] = 2.0 * (qx * qy - qw * qz);
+  m_rotation[0][2] = 2.0 * (qx * qz + qw * qy);
+  m_rotation[1][0] = 2.0 * (qx * qy + qw * qz);
+  m_rotation[1][1] = 1.0 - 2.0 * (qx * qx + qz * qz);
+  m_rotation[1][2] = 2.0 * (qy * qz - qw * qx);
+  m_rotation[2][0] = 2.0 * (qx * qz - qw * qy);
+  m_rotation[2][1] = 2.0 * (qy * qz + qw * qx);
+  m_rotation[2][2] = 1.0 - 2.0 * (qx * qx + qy * qy);
+
+  for (uint32_t a = 0; a < 3; a++) {
+    m_translation[a] = frameMean[a] - (m_rotation[a][0] * bodyMean[0] + 
+        m_rotation[a][1] * bodyMean[1] + m_rotation[a][2] * bodyMean[2]);
+  }
+
+  double squaredErrorTotal = 0.0;
+  for (uint32_t i = 0; i < a_slotCount; i++) {
+    uint32_t const slot = (a_slots == nullptr) ? i : a_slots[i];
+    double const error = static_cast<double>(
+        GetMarkerError(a_body, a_markers, a_indices, slot));
+    squaredErrorTotal += error * error;
+  }
+  m_residual = static_cast<float>(std::sqrt(squaredErrorTotal / a_slotCount));
+
+  return true;
+}
+
+/**
+ * The position of the origo of the body.
+ */
+float PoseSolver::GetX() const
+{
+  return static_cast<float>(m_translation[0]);
+}
+
+float PoseSolver::GetY() const
+{
+  return static_cast<float>(m_translation[1]);
+}
+
+float PoseSolver::GetZ() const
+{
+  return static_cast<float>(m_translation[2]);
+}
+
+/**
+ * The rotation of the body as roll, pitch, and yaw, applied in the order
+ * yaw, pitch, and roll.
+ */
+float PoseSolver::GetRoll() const
+{
+  return static_cast<float>(std::atan2(m_rotation[2][1], m_rotation[2][2]));
+}
+
+float PoseSolver::GetPitch() const
+{
+  double const sinPitch = -m_rotation[2][0];
+  double const clamped = (sinPitch > 1.0) ? 1.0 : 
+      ((sinPitch < -1.0) ? -1.0 : sinPitch);
+  return static_cast<float>(std::asin(clamped));
+}
+
+float PoseSolver::GetYaw() const
+{
+  return static_cast<float>(std::atan2(m_rotation[1][0], m_rotation[0][0]));
+}
+
+float PoseSolver::GetResidual() const
+{
+  return m_residual;
+}
+
+/**
+ * Marker j of the body, where the origo is the zero vector.
+ */
+void PoseSolver::GetBodyMarker(RigidBody const &a_body, uint32_t a_slot, 
+    double (&a_p)[3])
+{
+  if (a_slot == 0) {
+    a_p[0] = 0.0;
+    a_p[1] = 0.0;
+    a_p[2] = 0.0;
+  } else {
+    opendlv::model::Cartesian3 const &marker = 
+        a_body.GetMarkers()[a_slot - 1];
+    a_p[0] = static_cast<double>(marker.getX());
+    a_p[1] = static_cast<double>(marker.getY());
+    a_p[2] = static_cast<double>(marker.getZ());
+  }
+}
+
+void PoseSolver::GetFrameMarker(MarkerView const &a_markers, int32_t a_index,
+    double (&a_q)[3])
+{
+  a_q[0] = static_cast<double>(a_markers.GetX()[a_index]);
+  a_q[1] = static_cast<double>(a_markers.GetY()[a_index]);
+  a_q[2] = static_cast<double>(a_markers.GetZ()[a_index]);
+}
+
+/**
+ * Cyclic Jacobi rotations on a symmetric 4x4 matrix until it is diagonal,
+ * giving the eigenvector of the largest eigenvalue. The matrix is
+ * overwritten.
+ */
+void PoseSolver::FindLargestEigenvector(double (&a_matrix)[4][4], 
+    double (&a_eigenvector)[4])
+{
+  double v[4][4] = {{1.0, 0.0, 0.0, 0.0}, {0.0, 1.0, 0.0, 0.0}, 
+    {0.0, 0.0, 1.0, 0.0}, {0.0, 0.0, 0.0, 1.0}};
+
+  for (uint32_t sweep = 0; sweep < MAX_SWEEPS; sweep++) {
+    double diagonal = 0.0;
+    double offDiagonal = 0.0;
+    for (uint32_t p = 0; p < 4; p++) {
+      diagonal += a_matrix[p][p] * a_matrix[p][p];
+      for (uint32_t q = p + 1; q < 4; q++) {
+        offDiagonal += a_matrix[p][q] * a_matrix[p][q];
+      }
+    }
+    if (offDiagonal <= 1e-24 * diagonal) {
+      break;
+    }
+
+    for (uint32_t p = 0; p < 3; p++) {
+      for (uint32_t q = p + 1; q < 4; q++) {
+        double const apq = a_matrix[p][q];
+        if (std::abs(apq) < 1e-300) {
+          continue;
+        }
+        double const theta = (a_matrix[q][q] - a_matrix[p][p]) / (2.0 * apq);
+        double const t = ((theta < 0.0) ? -1.0 : 1.0) / 
+            (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+        double const c = 1.0 / std::sqrt(t * t + 1.0);
+        double const s = t * c;
+
+        for (uint32_t k = 0; k < 4; k++) {
+          double const akp = a_matrix[k][p];
+          double const akq = a_matrix[k][q];
+          a_matrix[k][p] = c * akp - s * akq;
+          a_matrix[k][q] = s * akp + c * akq;
+        }
+        for (uint32_t k = 0; k < 4; k++) {
+          double const apk = a_matrix[p][k];
+          double const aqk = a_matrix[q][k];
+          a_matrix[p][k] = c * apk - s * aqk;
+          a_matrix[q][k] = s * apk + c * aqk;
+        }
+        for (uint32_t k = 0; k < 4; k++) {
+          double const vkp = v[k][p];
+          double const vkq = v[k][q];
+          v[k][p] = c * vkp - s * vkq;
+          v[k][q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+
+  uint32_t largest = 0;
+  for (uint32_t p = 1; p < 4; p++) {
+    if (a_matrix[p][p] > a_matrix[largest][largest]) {
+      largest = p;
+    }
+  }
+  for (uint32_t k = 0; k < 4; k++) {
+    a_eigenvector[k] = v[k][largest];
+  }
+}
+
+}
+}
+}
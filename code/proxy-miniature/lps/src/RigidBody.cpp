@@ -0,0 +1,96 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include "RigidBody.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+RigidBody::RigidBody()
+    : m_frameId(0)
+    , m_markers()
+    , m_markerDistances()
+    , m_markerIds()
+{
+}
+
+RigidBody::RigidBody(int16_t a_frameId, 
+    std::vector<opendlv::model::Cartesian3> const &a_markers)
+    : m_frameId(a_frameId)
+    , m_markers(a_markers)
+    , m_markerDistances()
+    , m_markerIds()
+{
+  for (auto const &marker : m_markers) {
+    float const x = marker.getX();
+    float const y = marker.getY();
+    float const z = marker.getZ();
+    m_markerDistances.push_back(std::sqrt(x * x + y * y + z * z));
+  }
+}
+
+RigidBody::RigidBody(int16_t a_frameId, 
+    std::vector<opendlv::model::Cartesian3> const &a_markers, 
+    std::vector<int32_t> const &a_markerIds)
+    : RigidBody(a_frameId, a_markers)
+{
+  m_markerIds = a_markerIds;
+}
+
+int16_t RigidBody::GetFrameId() const
+{
+  return m_frameId;
+}
+
+std::vector<opendlv::model::Cartesian3> const &RigidBody::GetMarkers() const
+{
+  return m_markers;
+}
+
+uint32_t RigidBody::GetMarkerCount() const
+{
+  return static_cast<uint32_t>(m_markers.size());
+}
+
+/**
+ * The distance from the origo marker to the given marker.
+ */
+float RigidBody::GetMarkerDistance(uint32_t a_index) const
+{
+  return m_markerDistances[a_index];
+}
+
+/**
+ * If a label id is given for the origo and every needle marker.
+ */
+bool RigidBody::HasMarkerIds() const
+{
+  return m_markerIds.size() == m_markers.size() + 1;
+}
+
+std::vector<int32_t> const &RigidBody::GetMarkerIds() const
+{
+  return m_markerIds;
+}
+
+}
+}
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LPSALLOCATION_TESTSUITE_H
+#define LPSALLOCATION_TESTSUITE_H
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "cxxtest/TestSuite.h"
+
+// Include local header files.
+#include "../include/MarkerBuffer.h"
+#include "../include/MarkerSearch.h"
+#include "../include/PoseSolver.h"
+#include "../include/RigidBody.h"
+
+// Counts all heap allocations made by this test runner.
+static uint64_t g_allocationCount = 0;
+
+void *operator new(std::size_t a_size) {
+    g_allocationCount++;
+    void *memory = std::malloc(a_size == 0 ? 1 : a_size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *a_memory) noexcept {
+    std::free(a_memory);
+}
+
+class LpsAllocationTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    // Two moving bodies and a reflection. Every tenth frame one marker of
+    // the second body is hidden, so both the tracked and the full search
+    // are run.
+    void fillFrame(opendlv::proxy::miniature::MarkerBuffer &a_markers, 
+        uint32_t a_frame) {
+        float const x = 0.005f * a_frame;
+        a_markers.Clear();
+        a_markers.Add(-2.0f, 0.5f, 0.0f);
+        a_markers.Add(1.0f + x, 1.0f, 0.0f);
+        a_markers.Add(1.1f + x, 1.0f, 0.0f);
+        a_markers.Add(1.0f + x, 1.06f, 0.0f);
+        a_markers.Add(-1.0f, -1.0f - x, 0.0f);
+        a_markers.Add(-0.8f, -1.0f - x, 0.0f);
+        if (a_frame % 10 != 0) {
+            a_markers.Add(-1.0f, -0.86f - x, 0.0f);
+        }
+    }
+
+    void testNoAllocationsPerFrame() {
+        std::vector<opendlv::model::Cartesian3> needle0;
+        needle0.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        needle0.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+        std::vector<opendlv::model::Cartesian3> needle1;
+        needle1.push_back(opendlv::model::Cartesian3(0.2f, 0.0f, 0.0f));
+        needle1.push_back(opendlv::model::Cartesian3(0.0f, 0.14f, 0.0f));
+        std::vector<opendlv::proxy::miniature::RigidBody> bodies;
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(0, needle0));
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(1, needle1));
+
+        opendlv::proxy::miniature::MarkerSearch search;
+        search.SetBodies(bodies, 0.01f);
+        search.SetTracking(true, 0.02f);
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        opendlv::proxy::miniature::PoseSolver solver;
+
+        uint32_t found = 0;
+        uint64_t allocationCount = 0;
+        for (uint32_t frame = 0; frame < 120; frame++) {
+            if (frame == 20) {
+                allocationCount = g_allocationCount;
+            }
+            fillFrame(markers, frame);
+            uint32_t const candidateCount = 
+                search.Track(markers.GetView(), frame / 60.0);
+            for (uint32_t i = 0; i < candidateCount; i++) {
+                uint32_t const body = search.GetCandidateBody(i);
+                if (solver.Solve(bodies[body], markers.GetView(), 
+                        search.GetCandidate(i))) {
+                    found++;
+                }
+            }
+        }
+        TS_ASSERT_EQUALS(g_allocationCount, allocationCount);
+        TS_ASSERT_EQUALS(found, 120u + 108u);
+        TS_ASSERT_EQUALS(search.GetFallbackCount(), 24u);
+    }
+};
+
+#endif
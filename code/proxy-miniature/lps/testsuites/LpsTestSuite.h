@@ -20,10 +20,19 @@
 #ifndef LPS_TESTSUITE_H
 #define LPS_TESTSUITE_H
 
+#include <cmath>
+
 #include "cxxtest/TestSuite.h"
 
 // Include local header files.
 #include "../include/Lps.h"
+#include "../include/DistanceMatrix.h"
+#include "../include/MarkerBuffer.h"
+#include "../include/MarkerSearch.h"
+#include "../include/PoseConsensus.h"
+#include "../include/PoseFilter.h"
+#include "../include/PoseSolver.h"
+#include "../include/RigidBody.h"
 
 class LpsTest : public CxxTest::TestSuite {
    public:
@@ -34,6 +43,392 @@ class LpsTest : public CxxTest::TestSuite {
     void testApplication() {
         TS_ASSERT(true);
     }
+
+    void testDistanceMatrix() {
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        for (uint32_t i = 0; i < 7; i++) {
+            markers.Add(0.5f * i, 1.0f - 0.25f * i, 0.1f * i);
+        }
+        opendlv::proxy::miniature::DistanceMatrix distanceMatrix;
+        distanceMatrix.Compute(markers.GetView());
+        TS_ASSERT_EQUALS(distanceMatrix.GetCount(), 7u);
+        for (uint32_t i = 0; i < 7; i++) {
+            for (uint32_t j = 0; j < 7; j++) {
+                float const dx = 0.5f * j - 0.5f * i;
+                float const dy = 0.25f * i - 0.25f * j;
+                float const dz = 0.1f * j - 0.1f * i;
+                TS_ASSERT_DELTA(distanceMatrix.GetSquaredDistance(i, j), 
+                    dx * dx + dy * dy + dz * dz, 1e-5);
+            }
+        }
+    }
+
+    void testMarkerSearch() {
+        std::vector<opendlv::model::Cartesian3> needle;
+        needle.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+        opendlv::proxy::miniature::MarkerSearch search;
+        std::vector<opendlv::proxy::miniature::RigidBody> bodies;
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(0, needle));
+        search.SetBodies(bodies, 0.01f);
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        markers.Add(2.0f, 2.0f, 0.0f);
+        markers.Add(1.0f, 1.0f, 0.0f);
+        markers.Add(1.0f, 1.06f, 0.0f);
+        markers.Add(-2.0f, 0.0f, 0.0f);
+        markers.Add(1.1f, 1.0f, 0.0f);
+
+        TS_ASSERT_EQUALS(search.Search(markers.GetView()), 1u);
+        int32_t const *candidate = search.GetCandidate(0);
+        TS_ASSERT_EQUALS(candidate[0], 1);
+        TS_ASSERT_EQUALS(candidate[1], 4);
+        TS_ASSERT_EQUALS(candidate[2], 2);
+    }
+
+    void testMarkerSearchMultipleBodies() {
+        std::vector<opendlv::model::Cartesian3> needle0;
+        needle0.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        needle0.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+        std::vector<opendlv::model::Cartesian3> needle1;
+        needle1.push_back(opendlv::model::Cartesian3(0.2f, 0.0f, 0.0f));
+        needle1.push_back(opendlv::model::Cartesian3(0.0f, 0.14f, 0.0f));
+        needle1.push_back(opendlv::model::Cartesian3(0.0f, 0.0f, 0.08f));
+        std::vector<opendlv::proxy::miniature::RigidBody> bodies;
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(3, needle0));
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(7, needle1));
+
+        opendlv::proxy::miniature::MarkerSearch search;
+        search.SetBodies(bodies, 0.01f);
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        markers.Add(-1.0f, -1.0f, 0.0f);
+        markers.Add(-1.0f, -0.86f, 0.0f);
+        markers.Add(1.0f, 1.0f, 0.0f);
+        markers.Add(1.1f, 1.0f, 0.0f);
+        markers.Add(-0.8f, -1.0f, 0.0f);
+        markers.Add(1.0f, 1.06f, 0.0f);
+        markers.Add(-1.0f, -1.0f, 0.08f);
+
+        TS_ASSERT_EQUALS(search.Search(markers.GetView()), 2u);
+
+        int32_t const *candidate0 = search.GetCandidate(0);
+        TS_ASSERT_EQUALS(search.GetCandidateBody(0), 0u);
+        TS_ASSERT_EQUALS(search.GetBodies()[0].GetFrameId(), 3);
+        TS_ASSERT_EQUALS(candidate0[0], 2);
+        TS_ASSERT_EQUALS(candidate0[1], 3);
+        TS_ASSERT_EQUALS(candidate0[2], 5);
+
+        int32_t const *candidate1 = search.GetCandidate(1);
+        TS_ASSERT_EQUALS(search.GetCandidateBody(1), 1u);
+        TS_ASSERT_EQUALS(search.GetBodies()[1].GetFrameId(), 7);
+        TS_ASSERT_EQUALS(candidate1[0], 0);
+        TS_ASSERT_EQUALS(candidate1[1], 4);
+        TS_ASSERT_EQUALS(candidate1[2], 1);
+        TS_ASSERT_EQUALS(candidate1[3], 6);
+    }
+
+    void testMarkerSearchBestCandidate() {
+        std::vector<opendlv::model::Cartesian3> needle;
+        needle.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+        std::vector<opendlv::proxy::miniature::RigidBody> bodies;
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(0, needle));
+        opendlv::proxy::miniature::MarkerSearch search;
+        search.SetBodies(bodies, 0.01f);
+
+        // A distorted copy of the body is also a candidate, but fits worse.
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        markers.Add(3.0f, 3.0f, 0.0f);
+        markers.Add(3.104f, 3.0f, 0.0f);
+        markers.Add(3.0f, 3.056f, 0.0f);
+        markers.Add(1.0f, 1.0f, 0.0f);
+        markers.Add(1.1f, 1.0f, 0.0f);
+        markers.Add(1.0f, 1.06f, 0.0f);
+
+        TS_ASSERT_EQUALS(search.Search(markers.GetView()), 1u);
+        int32_t const *candidate = search.GetCandidate(0);
+        TS_ASSERT_EQUALS(candidate[0], 3);
+        TS_ASSERT_EQUALS(candidate[1], 4);
+        TS_ASSERT_EQUALS(candidate[2], 5);
+        TS_ASSERT_DELTA(search.GetCandidateResidual(0), 0.0, 1e-4);
+
+        // Both needle markers at the same distance would pick one marker.
+        std::vector<opendlv::model::Cartesian3> symmetricNeedle;
+        symmetricNeedle.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        symmetricNeedle.push_back(opendlv::model::Cartesian3(0.0f, 0.1f, 0.0f));
+        bodies.clear();
+        bodies.push_back(
+            opendlv::proxy::miniature::RigidBody(0, symmetricNeedle));
+        search.SetBodies(bodies, 0.01f);
+        markers.Clear();
+        markers.Add(1.0f, 1.0f, 0.0f);
+        markers.Add(1.1f, 1.0f, 0.0f);
+        TS_ASSERT_EQUALS(search.Search(markers.GetView()), 0u);
+    }
+
+    void testMarkerSearchTracking() {
+        std::vector<opendlv::model::Cartesian3> needle;
+        needle.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+        std::vector<opendlv::proxy::miniature::RigidBody> bodies;
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(0, needle));
+
+        opendlv::proxy::miniature::MarkerSearch search;
+        search.SetBodies(bodies, 0.01f);
+        search.SetTracking(true, 0.02f);
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        for (uint32_t i = 0; i < 20; i++) {
+            float const x = 1.0f + 0.01f * i;
+            markers.Clear();
+            markers.Add(-2.0f, 0.5f, 0.0f);
+            if (i < 10) {
+                markers.Add(x, 1.0f, 0.0f);
+                markers.Add(x, 1.06f, 0.0f);
+                markers.Add(x + 0.1f, 1.0f, 0.0f);
+            } else {
+                markers.Add(x + 0.1f, 1.0f, 0.0f);
+                markers.Add(x, 1.06f, 0.0f);
+                markers.Add(x, 1.0f, 0.0f);
+            }
+            TS_ASSERT_EQUALS(search.Track(markers.GetView(), i / 60.0), 1u);
+            int32_t const *candidate = search.GetCandidate(0);
+            TS_ASSERT_EQUALS(candidate[0], (i < 10) ? 1 : 3);
+            TS_ASSERT_EQUALS(candidate[1], (i < 10) ? 3 : 1);
+            TS_ASSERT_EQUALS(candidate[2], 2);
+        }
+        TS_ASSERT_EQUALS(search.GetFrameCount(), 20u);
+        TS_ASSERT_EQUALS(search.GetFallbackCount(), 1u);
+
+        markers.Clear();
+        markers.Add(-2.0f, 0.5f, 0.0f);
+        TS_ASSERT_EQUALS(search.Track(markers.GetView(), 20 / 60.0), 0u);
+        TS_ASSERT_EQUALS(search.GetFallbackCount(), 2u);
+    }
+
+    void testMarkerSearchTrackingWithAbsentBody() {
+        // The second body never appears, and is only searched for once per
+        // track age instead of in every frame.
+        std::vector<opendlv::model::Cartesian3> needle;
+        needle.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+        std::vector<opendlv::model::Cartesian3> absentNeedle;
+        absentNeedle.push_back(opendlv::model::Cartesian3(0.2f, 0.0f, 0.0f));
+        absentNeedle.push_back(opendlv::model::Cartesian3(0.0f, 0.15f, 0.0f));
+        std::vector<opendlv::proxy::miniature::RigidBody> bodies;
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(0, needle));
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(1, absentNeedle));
+
+        opendlv::proxy::miniature::MarkerSearch search;
+        search.SetBodies(bodies, 0.01f);
+        search.SetTracking(true, 0.02f);
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        for (uint32_t i = 0; i < 20; i++) {
+            float const x = 1.0f + 0.01f * i;
+            markers.Clear();
+            markers.Add(-2.0f, 0.5f, 0.0f);
+            markers.Add(x, 1.0f, 0.0f);
+            markers.Add(x, 1.06f, 0.0f);
+            markers.Add(x + 0.1f, 1.0f, 0.0f);
+            TS_ASSERT_EQUALS(search.Track(markers.GetView(), i / 60.0), 1u);
+            TS_ASSERT_EQUALS(search.GetCandidateBody(0), 0u);
+            TS_ASSERT_EQUALS(search.GetCandidate(0)[0], 1);
+            TS_ASSERT_EQUALS(search.GetCandidate(0)[1], 3);
+            TS_ASSERT_EQUALS(search.GetCandidate(0)[2], 2);
+        }
+        TS_ASSERT_EQUALS(search.GetFrameCount(), 20u);
+        // The first frame, and once more after 0.2 s.
+        TS_ASSERT_EQUALS(search.GetFallbackCount(), 2u);
+    }
+
+    void testMarkerSearchLabels() {
+        // Two bodies of the same shape, told apart only by their labels.
+        std::vector<opendlv::model::Cartesian3> needle;
+        needle.push_back(opendlv::model::Cartesian3(0.1f, 0.0f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.0f, 0.06f, 0.0f));
+        std::vector<opendlv::proxy::miniature::RigidBody> bodies;
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(0, needle, 
+            std::vector<int32_t>{0, 1, 2}));
+        bodies.push_back(opendlv::proxy::miniature::RigidBody(1, needle, 
+            std::vector<int32_t>{3, 4, 5}));
+
+        opendlv::proxy::miniature::MarkerSearch search;
+        search.SetBodies(bodies, 0.01f);
+        search.SetTracking(true, 0.02f);
+        TS_ASSERT(search.HasLabels());
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        markers.Add(2.0f, 1.06f, 0.0f, 5);
+        markers.Add(1.1f, 1.0f, 0.0f, 1);
+        markers.Add(2.0f, 1.0f, 0.0f, 3);
+        markers.Add(-2.0f, 0.5f, 0.0f, 7);
+        markers.Add(1.0f, 1.0f, 0.0f, 0);
+        markers.Add(2.1f, 1.0f, 0.0f, 4);
+        markers.Add(1.0f, 1.06f, 0.0f, 2);
+        TS_ASSERT_EQUALS(search.Label(markers.GetView(), 0.0), 2u);
+        TS_ASSERT_EQUALS(search.GetCandidateBody(0), 0u);
+        TS_ASSERT_EQUALS(search.GetCandidate(0)[0], 4);
+        TS_ASSERT_EQUALS(search.GetCandidate(0)[1], 1);
+        TS_ASSERT_EQUALS(search.GetCandidate(0)[2], 6);
+        TS_ASSERT_EQUALS(search.GetCandidateBody(1), 1u);
+        TS_ASSERT_EQUALS(search.GetCandidate(1)[0], 2);
+        TS_ASSERT_EQUALS(search.GetCandidate(1)[1], 5);
+        TS_ASSERT_EQUALS(search.GetCandidate(1)[2], 0);
+        TS_ASSERT_EQUALS(search.GetLabelledCount(), 1u);
+        TS_ASSERT_EQUALS(search.GetFallbackCount(), 0u);
+
+        // A lost label gives the frame to the tracker, which follows both.
+        markers.Clear();
+        markers.Add(2.0f, 1.06f, 0.0f, 5);
+        markers.Add(1.1f, 1.0f, 0.0f, 1);
+        markers.Add(2.0f, 1.0f, 0.0f, 3);
+        markers.Add(1.0f, 1.0f, 0.0f, 0);
+        markers.Add(2.1f, 1.0f, 0.0f, -1);
+        markers.Add(1.0f, 1.06f, 0.0f, 2);
+        TS_ASSERT_EQUALS(search.Label(markers.GetView(), 1 / 60.0), 2u);
+        TS_ASSERT_EQUALS(search.GetCandidate(1)[1], 4);
+        TS_ASSERT_EQUALS(search.GetFrameCount(), 2u);
+        TS_ASSERT_EQUALS(search.GetLabelledCount(), 1u);
+        TS_ASSERT_EQUALS(search.GetFallbackCount(), 0u);
+    }
+
+    void testPoseSolver() {
+        std::vector<opendlv::model::Cartesian3> needle;
+        needle.push_back(opendlv::model::Cartesian3(0.149f, 0.0f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.0f, 0.095f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.05f, 0.03f, 0.04f));
+        opendlv::proxy::miniature::RigidBody body(0, needle);
+
+        double const yaws[3] = {0.7, 3.1, -2.5};
+        for (double const yaw : yaws) {
+            double const pitch = 0.1;
+            double const roll = -0.2;
+            double const cy = std::cos(yaw), sy = std::sin(yaw);
+            double const cp = std::cos(pitch), sp = std::sin(pitch);
+            double const cr = std::cos(roll), sr = std::sin(roll);
+            double const r[3][3] = {
+                {cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr},
+                {sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr},
+                {-sp, cp * sr, cp * cr}};
+
+            opendlv::proxy::miniature::MarkerBuffer markers;
+            markers.Add(5.0f, 5.0f, 5.0f);
+            markers.Add(1.0f, 2.0f, 0.3f);
+            for (auto const &marker : needle) {
+                double const p[3] = {marker.getX(), marker.getY(), 
+                    marker.getZ()};
+                markers.Add(
+                    static_cast<float>(1.0 + r[0][0] * p[0] + r[0][1] * p[1] 
+                        + r[0][2] * p[2]),
+                    static_cast<float>(2.0 + r[1][0] * p[0] + r[1][1] * p[1] 
+                        + r[1][2] * p[2]),
+                    static_cast<float>(0.3 + r[2][0] * p[0] + r[2][1] * p[1] 
+                        + r[2][2] * p[2]));
+            }
+            int32_t const indices[4] = {1, 2, 3, 4};
+
+            opendlv::proxy::miniature::PoseSolver solver;
+            TS_ASSERT(solver.Solve(body, markers.GetView(), indices));
+            TS_ASSERT_DELTA(solver.GetX(), 1.0, 1e-4);
+            TS_ASSERT_DELTA(solver.GetY(), 2.0, 1e-4);
+            TS_ASSERT_DELTA(solver.GetZ(), 0.3, 1e-4);
+            TS_ASSERT_DELTA(solver.GetYaw(), yaw, 1e-3);
+            TS_ASSERT_DELTA(solver.GetPitch(), pitch, 1e-3);
+            TS_ASSERT_DELTA(solver.GetRoll(), roll, 1e-3);
+            TS_ASSERT_DELTA(solver.GetResidual(), 0.0, 1e-4);
+        }
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        markers.Add(0.0f, 0.0f, 0.0f);
+        markers.Add(0.149f, 0.01f, 0.0f);
+        markers.Add(0.0f, 0.095f, 0.0f);
+        markers.Add(0.05f, 0.03f, 0.04f);
+        int32_t const indices[4] = {0, 1, 2, 3};
+        opendlv::proxy::miniature::PoseSolver solver;
+        TS_ASSERT(solver.Solve(body, markers.GetView(), indices));
+        TS_ASSERT(solver.GetResidual() > 0.001f);
+        TS_ASSERT(solver.GetResidual() < 0.01f);
+    }
+
+    void testPoseFilter() {
+        opendlv::proxy::miniature::PoseFilter filter;
+        filter.SetNoise(0.002f, 0.01f, 2.0f, 10.0f);
+        TS_ASSERT(!filter.IsInitialised());
+
+        // Moving at 0.5 m/s along x and turning at 1 rad/s through pi.
+        for (uint32_t i = 0; i <= 60; i++) {
+            double const t = i / 60.0;
+            double const yaw = 2.6 + t;
+            filter.Correct(opendlv::model::Cartesian3(
+                static_cast<float>(0.5 * t), 1.0f, 0.0f), 
+                opendlv::model::Cartesian3(0.0f, 0.0f, 
+                static_cast<float>(std::atan2(std::sin(yaw), std::cos(yaw)))),
+                t);
+        }
+        TS_ASSERT(filter.IsInitialised());
+        TS_ASSERT_DELTA(filter.GetTime(), 1.0, 1e-9);
+
+        opendlv::model::Cartesian3 position;
+        opendlv::model::Cartesian3 angularDisplacement;
+        opendlv::model::Cartesian3 velocity;
+        float yawRate = 0.0f;
+        filter.Predict(1.01, position, angularDisplacement, velocity, 
+            yawRate);
+        TS_ASSERT_DELTA(velocity.getX(), 0.5, 0.02);
+        TS_ASSERT_DELTA(velocity.getY(), 0.0, 1e-3);
+        TS_ASSERT_DELTA(yawRate, 1.0, 0.05);
+        TS_ASSERT_DELTA(position.getX(), 0.505, 2e-3);
+        TS_ASSERT_DELTA(position.getY(), 1.0, 1e-3);
+        TS_ASSERT_DELTA(angularDisplacement.getZ(), 3.61 - 2.0 * M_PI, 0.01);
+    }
+
+    void testPoseConsensus() {
+        std::vector<opendlv::model::Cartesian3> needle;
+        needle.push_back(opendlv::model::Cartesian3(0.149f, 0.0f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.0f, 0.095f, 0.0f));
+        needle.push_back(opendlv::model::Cartesian3(0.05f, 0.03f, 0.04f));
+        needle.push_back(opendlv::model::Cartesian3(-0.06f, 0.02f, 0.0f));
+        opendlv::proxy::miniature::RigidBody body(0, needle);
+
+        // The third needle marker is matched to a reflection 3 cm away.
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        markers.Add(1.0f, 2.0f, 0.0f);
+        markers.Add(1.149f, 2.0f, 0.0f);
+        markers.Add(1.0f, 2.095f, 0.0f);
+        markers.Add(1.05f, 2.06f, 0.04f);
+        markers.Add(0.94f, 2.02f, 0.0f);
+        int32_t const indices[5] = {0, 1, 2, 3, 4};
+
+        opendlv::proxy::miniature::PoseSolver solver;
+        TS_ASSERT(solver.Solve(body, markers.GetView(), indices));
+        TS_ASSERT(solver.GetResidual() > 0.005f);
+
+        opendlv::proxy::miniature::PoseConsensus consensus;
+        consensus.SetThreshold(0.005f);
+        consensus.SetMaxIterations(64);
+        TS_ASSERT(consensus.Fit(body, markers.GetView(), indices, 
+            std::chrono::steady_clock::now() + std::chrono::seconds(1)));
+        TS_ASSERT_EQUALS(consensus.GetInlierCount(), 4u);
+        TS_ASSERT(consensus.GetIterationCount() <= 64u);
+        TS_ASSERT_DELTA(consensus.GetPose().GetX(), 1.0, 1e-4);
+        TS_ASSERT_DELTA(consensus.GetPose().GetY(), 2.0, 1e-4);
+        TS_ASSERT_DELTA(consensus.GetPose().GetYaw(), 0.0, 1e-3);
+        TS_ASSERT_DELTA(consensus.GetPose().GetResidual(), 0.0, 1e-4);
+
+        // A passed deadline still gives one try, which fits as long as every
+        // marker is where the body has it.
+        markers.Clear();
+        markers.Add(1.0f, 2.0f, 0.0f);
+        markers.Add(1.149f, 2.0f, 0.0f);
+        markers.Add(1.0f, 2.095f, 0.0f);
+        markers.Add(1.05f, 2.03f, 0.04f);
+        markers.Add(0.94f, 2.02f, 0.0f);
+        TS_ASSERT(consensus.Fit(body, markers.GetView(), indices, 
+            std::chrono::steady_clock::now() - std::chrono::seconds(1)));
+        TS_ASSERT_EQUALS(consensus.GetIterationCount(), 1u);
+    }
 };
 
 #endif
@@ -28,6 +28,8 @@
 
 #include <opendavinci/odcore/base/module/DataTriggeredConferenceClientModule.h>
 
+#include "SysfsAttribute.h"
+
 namespace opendlv {
 namespace proxy {
 namespace miniature {
@@ -50,12 +52,13 @@ class Pwm : public odcore::base::module::DataTriggeredConferenceClientModule {
   void OpenPwm();
   void ClosePwm();
   void Reset();
-  void SetEnabled(uint16_t const, bool const);
-  bool GetEnabled(uint16_t const) const;
-  void SetDutyCycleNs(uint16_t const, uint32_t const);
-  uint32_t GetDutyCycleNs(uint16_t const) const;
-  void SetPeriodNs(uint16_t const, uint32_t const);
-  uint32_t GetPeriodNs(uint16_t const) const;
+  int32_t GetIndex(uint16_t const) const;
+  void SetEnabled(uint32_t const, bool const);
+  bool GetEnabled(uint32_t const) const;
+  void SetDutyCycleNs(uint32_t const, uint32_t const);
+  uint32_t GetDutyCycleNs(uint32_t const) const;
+  void SetPeriodNs(uint32_t const, uint32_t const);
+  uint32_t GetPeriodNs(uint32_t const) const;
 
   bool m_debug;
   bool m_initialised;
@@ -63,6 +66,9 @@ class Pwm : public odcore::base::module::DataTriggeredConferenceClientModule {
   std::vector<uint16_t> m_pins;
   std::vector<uint32_t> m_periodsNs;
   std::vector<uint32_t> m_dutyCyclesNs;
+  std::vector<SysfsAttribute> m_enableFiles;
+  std::vector<SysfsAttribute> m_periodFiles;
+  std::vector<SysfsAttribute> m_dutyCycleFiles;
 };
 
 }
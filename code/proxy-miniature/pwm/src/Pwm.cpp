@@ -17,7 +17,6 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
-#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -42,6 +41,9 @@ Pwm::Pwm(const int &argc, char **argv)
     , m_pins()
     , m_periodsNs()
     , m_dutyCyclesNs()
+    , m_enableFiles()
+    , m_periodFiles()
+    , m_dutyCycleFiles()
 {
 }
 
@@ -117,156 +119,149 @@ void Pwm::nextContainer(odcore::data::Container &a_container)
         a_container.getData<opendlv::proxy::PwmRequest>();
     uint16_t pin = request.getPin();
     uint32_t dutyCycleNs = request.getDutyCycleNs();
-    SetDutyCycleNs(pin, dutyCycleNs);
+    int32_t const index = GetIndex(pin);
+    if (index < 0) {
+      cerr << "[" << getName() << "] The requested pin " << pin 
+          << " is not configured." << std::endl;
+      return;
+    }
+    SetDutyCycleNs(index, dutyCycleNs);
   }
 }
 
+/**
+ * Exports the pins, and opens the enable, period and duty cycle of each of
+ * them once, so that a request is a single pwrite.
+ */
 void Pwm::OpenPwm()
 {
-  std::string filename = m_path + "/export";
-  std::ofstream exportFile(filename, std::ofstream::out);
-  
-  if (exportFile.is_open()) {
+  m_enableFiles.resize(m_pins.size());
+  m_periodFiles.resize(m_pins.size());
+  m_dutyCycleFiles.resize(m_pins.size());
+
+  SysfsAttribute exportFile;
+  if (exportFile.Open(m_path + "/export", true)) {
     for (auto pin : m_pins) {
-      exportFile << pin;
-      exportFile.flush();
+      exportFile.WriteInteger(pin);
     }
-    Reset();
   } else {
-    cerr << "[" << getName() << "] Could not open " << filename << "." 
-        << std::endl;
+    cerr << "[" << getName() << "] Could not open " << exportFile.GetPath() 
+        << "." << std::endl;
+    return;
+  }
+  for (uint32_t i = 0; i < m_pins.size(); i++) {
+    std::string const pinPath = m_path + "/pwm" + std::to_string(m_pins[i]);
+    if (!m_enableFiles[i].Open(pinPath + "/enable", true)) {
+      cerr << "[" << getName() << "] Could not open " 
+          << m_enableFiles[i].GetPath() << "." << std::endl;
+    }
+    if (!m_periodFiles[i].Open(pinPath + "/period", true)) {
+      cerr << "[" << getName() << "] Could not open " 
+          << m_periodFiles[i].GetPath() << "." << std::endl;
+    }
+    if (!m_dutyCycleFiles[i].Open(pinPath + "/duty_cycle", true)) {
+      cerr << "[" << getName() << "] Could not open " 
+          << m_dutyCycleFiles[i].GetPath() << "." << std::endl;
+    }
   }
-  exportFile.close();
+  Reset();
 }
 
 void Pwm::ClosePwm()
 {
-  std::string filename = m_path + "/unexport";
-  std::ofstream unexportFile(filename, std::ofstream::out);
-  
-  if (unexportFile.is_open()) {
-    for (auto pin : m_pins) {
-      SetEnabled(pin, 0);
-      unexportFile << pin;
-      unexportFile.flush();
+  SysfsAttribute unexportFile;
+  if (unexportFile.Open(m_path + "/unexport", true)) {
+    for (uint32_t i = 0; i < m_pins.size(); i++) {
+      SetEnabled(i, false);
+      m_enableFiles[i].Close();
+      m_periodFiles[i].Close();
+      m_dutyCycleFiles[i].Close();
+      unexportFile.WriteInteger(m_pins[i]);
     }
   } else {
-    cerr << "[" << getName() << "] Could not open " << filename << "." 
-        << std::endl;
+    cerr << "[" << getName() << "] Could not open " << unexportFile.GetPath() 
+        << "." << std::endl;
   }
-  unexportFile.close();
 }
 
 void Pwm::Reset()
 {
-  for (uint8_t i = 0; i < m_pins.size(); i++) {
-    SetEnabled(m_pins.at(i), false);
-    SetPeriodNs(m_pins.at(i), m_periodsNs.at(i));
-    SetDutyCycleNs(m_pins.at(i), m_dutyCyclesNs.at(i));
-    SetEnabled(m_pins.at(i), true);
+  for (uint32_t i = 0; i < m_pins.size(); i++) {
+    SetEnabled(i, false);
+    SetPeriodNs(i, m_periodsNs.at(i));
+    SetDutyCycleNs(i, m_dutyCyclesNs.at(i));
+    SetEnabled(i, true);
   }
 }
 
-void Pwm::SetEnabled(uint16_t const a_pin, bool const a_value)
+/**
+ * Returns the index of a configured pin, or -1 if it is not configured.
+ */
+int32_t Pwm::GetIndex(uint16_t const a_pin) const
 {
-  std::string filename = m_path + "/pwm" + std::to_string(a_pin) + "/enable";
-  std::ofstream file(filename, std::ofstream::out);
-  if (file.is_open()) {
-    file << std::to_string((static_cast<int32_t>(a_value)));
-    file.flush();
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename 
-        << "." << std::endl;
+  for (uint32_t i = 0; i < m_pins.size(); i++) {
+    if (m_pins[i] == a_pin) {
+      return static_cast<int32_t>(i);
+    }
   }
-  file.close();
+  return -1;
 }
 
-bool Pwm::GetEnabled(uint16_t const a_pin) const
+void Pwm::SetEnabled(uint32_t const a_index, bool const a_value)
 {
-  std::string filename = m_path + "/pwm" + std::to_string(a_pin) + "/enable";
-  std::string line;
-
-  std::ifstream file(filename, std::ifstream::in);
-  if (file.is_open()) {
-    std::getline(file, line);
-    bool value = (line.compare("1") == 0);
-    file.close();
-    return value;
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename 
-        << "." << std::endl;
-    file.close();
-    return NULL;
+  if (!m_enableFiles[a_index].WriteInteger(a_value ? 1 : 0)) {
+    cerr << "[" << getName() << "] Could not write " 
+        << m_enableFiles[a_index].GetPath() << "." << std::endl;
   }
 }
 
-void Pwm::SetDutyCycleNs(uint16_t const a_pin, uint32_t const a_value)
+bool Pwm::GetEnabled(uint32_t const a_index) const
 {
-  std::string filename = m_path + "/pwm" + std::to_string(a_pin) + "/duty_cycle";
-
-  std::ofstream file(filename, std::ofstream::out);
-  if (file.is_open()) {
-    file << std::to_string(a_value);
-    file.flush();
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename 
-        << "." << std::endl;
+  int64_t value = 0;
+  if (!m_enableFiles[a_index].ReadInteger(value)) {
+    cerr << "[" << getName() << "] Could not read " 
+        << m_enableFiles[a_index].GetPath() << "." << std::endl;
+    return false;
   }
-
-  file.close();
+  return (value == 1);
 }
 
-uint32_t Pwm::GetDutyCycleNs(uint16_t const a_pin) const
+void Pwm::SetDutyCycleNs(uint32_t const a_index, uint32_t const a_value)
 {
-  std::string filename = m_path + "/pwm" + std::to_string(a_pin) + "/duty_cycle";
-  std::string line;
+  if (!m_dutyCycleFiles[a_index].WriteInteger(a_value)) {
+    cerr << "[" << getName() << "] Could not write " 
+        << m_dutyCycleFiles[a_index].GetPath() << "." << std::endl;
+  }
+}
 
-  std::ifstream file(filename, std::ifstream::in);
-  if (file.is_open()) {
-    std::getline(file, line);
-    uint32_t value = std::stoi(line);
-    file.close();
-    return value;
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename 
-        << "." << std::endl;
-    file.close();
+uint32_t Pwm::GetDutyCycleNs(uint32_t const a_index) const
+{
+  int64_t value = 0;
+  if (!m_dutyCycleFiles[a_index].ReadInteger(value)) {
+    cerr << "[" << getName() << "] Could not read " 
+        << m_dutyCycleFiles[a_index].GetPath() << "." << std::endl;
     return 0;
   }
+  return static_cast<uint32_t>(value);
 }
 
-void Pwm::SetPeriodNs(uint16_t const a_pin, uint32_t const a_value)
+void Pwm::SetPeriodNs(uint32_t const a_index, uint32_t const a_value)
 {
-  std::string filename = m_path + "/pwm" + std::to_string(a_pin) + "/period";
-
-  std::ofstream file(filename, std::ofstream::out);
-  if (file.is_open()) {
-    file << std::to_string(a_value);
-    file.flush();
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename 
-        << "." << std::endl;
+  if (!m_periodFiles[a_index].WriteInteger(a_value)) {
+    cerr << "[" << getName() << "] Could not write " 
+        << m_periodFiles[a_index].GetPath() << "." << std::endl;
   }
-  file.close();
 }
 
-uint32_t Pwm::GetPeriodNs(uint16_t const a_pin) const
+uint32_t Pwm::GetPeriodNs(uint32_t const a_index) const
 {
-  std::string filename = m_path + "/pwm" + std::to_string(a_pin) + "/period";
-  std::string line;
-
-  std::ifstream file(filename, std::ifstream::in);
-  if (file.is_open()) {
-    std::getline(file, line);
-    uint32_t value = std::stoi(line);
-    file.close();
-    return value;
-  } else {
-    cerr << "[" << getName() << "] Could not open " << filename 
-        << "." << std::endl;
-    file.close();
+  int64_t value = 0;
+  if (!m_periodFiles[a_index].ReadInteger(value)) {
+    cerr << "[" << getName() << "] Could not read " 
+        << m_periodFiles[a_index].GetPath() << "." << std::endl;
     return 0;
   }
+  return static_cast<uint32_t>(value);
 }
 
 }
@@ -0,0 +1,93 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_BATCHUDPRECEIVER_H
+#define PROXY_MINIATURE_BATCHUDPRECEIVER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+
+#include <opendavinci/odcore/base/Service.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Gets each datagram received by a BatchUdpReceiver, in place in the buffer
+ * of the receiver, together with the time the kernel received it.
+ */
+class DatagramListener {
+   public:
+    virtual ~DatagramListener() {}
+    virtual void nextDatagram(uint8_t const *, uint32_t, 
+        odcore::data::TimeStamp const &) = 0;
+};
+
+/**
+ * This class receives UDP datagrams on a port, draining as many as are
+ * queued with one recvmmsg call, and timestamps each of them with the time
+ * it arrived at the kernel. It replaces the OpenDaVINCI UDPReceiver, which
+ * makes one call and one string copy for every datagram.
+ */
+class BatchUdpReceiver : public odcore::base::Service {
+   private:
+    BatchUdpReceiver(BatchUdpReceiver const &) = delete;
+    BatchUdpReceiver &operator=(BatchUdpReceiver const &) = delete;
+
+   public:
+    BatchUdpReceiver(std::string const &, uint32_t, uint32_t, int32_t);
+    virtual ~BatchUdpReceiver();
+    void SetDatagramListener(DatagramListener *);
+    uint32_t GetBatchSize() const;
+    int32_t GetReceiveBufferSize() const;
+    uint64_t GetDatagramCount() const;
+    uint64_t GetBatchCount() const;
+    uint64_t GetTruncatedCount() const;
+    uint32_t GetLargestBatch() const;
+
+    static uint32_t const MAX_DATAGRAM_SIZE;
+
+   private:
+    virtual void beforeStop();
+    virtual void run();
+    uint32_t Receive();
+
+    int m_socket;
+    uint32_t m_batchSize;
+    int32_t m_receiveBufferSize;
+    DatagramListener *m_listener;
+    std::vector<uint8_t> m_data;
+    std::vector<uint8_t> m_control;
+    std::vector<struct iovec> m_iovecs;
+    std::vector<struct mmsghdr> m_messages;
+    std::atomic<uint64_t> m_datagramCount;
+    std::atomic<uint64_t> m_batchCount;
+    std::atomic<uint64_t> m_truncatedCount;
+    std::atomic<uint32_t> m_largestBatch;
+};
+
+}
+}
+}
+
+#endif
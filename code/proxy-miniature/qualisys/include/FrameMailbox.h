@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_FRAMEMAILBOX_H
+#define PROXY_MINIATURE_FRAMEMAILBOX_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include <opendavinci/odcore/data/TimeStamp.h>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * A single slot mailbox from one writer thread to one reader thread, where
+ * the latest packet wins. The writer never waits for the reader: a packet
+ * that is not taken before the next one is posted is dropped. It is triple
+ * buffered, so that the writer and the reader each own a buffer, and the
+ * third, holding the latest packet, is handed over by swapping its index
+ * atomically.
+ */
+class FrameMailbox {
+   private:
+    FrameMailbox(FrameMailbox const &) = delete;
+    FrameMailbox &operator=(FrameMailbox const &) = delete;
+
+   public:
+    FrameMailbox(uint32_t);
+    virtual ~FrameMailbox();
+    void Post(uint8_t const *, uint32_t, odcore::data::TimeStamp const &);
+    bool Take(uint32_t);
+    uint8_t const *GetData() const;
+    uint32_t GetSize() const;
+    odcore::data::TimeStamp const &GetArrival() const;
+    uint64_t GetPostedCount() const;
+    uint64_t GetDroppedCount() const;
+    uint64_t GetTakenCount() const;
+
+   private:
+    static uint32_t const SLOT_MASK;
+    static uint32_t const FRESH;
+
+    uint32_t m_capacity;
+    std::vector<uint8_t> m_data;
+    std::vector<uint32_t> m_sizes;
+    std::vector<odcore::data::TimeStamp> m_arrivals;
+    uint32_t m_writeSlot;
+    uint32_t m_readSlot;
+    std::atomic<uint32_t> m_readySlot;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<uint64_t> m_postedCount;
+    std::atomic<uint64_t> m_droppedCount;
+    std::atomic<uint64_t> m_takenCount;
+};
+
+}
+}
+}
+
+#endif
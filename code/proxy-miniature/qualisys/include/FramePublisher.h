@@ -0,0 +1,68 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_FRAMEPUBLISHER_H
+#define PROXY_MINIATURE_FRAMEPUBLISHER_H
+
+#include <opendavinci/odcore/base/Service.h>
+#include <opendavinci/odcore/io/PacketListener.h>
+#include <opendavinci/generated/odcore/data/Packet.h>
+
+#include "BatchUdpReceiver.h"
+#include "FrameMailbox.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * This class decouples the receiving of packets from their decoding and
+ * sending. The receive thread only posts each packet to a mailbox, and the
+ * thread of this service gives the latest one to the listener. When the
+ * listener is slower than the packets arrive, packets are skipped instead
+ * of queuing up in the socket, so the frames sent stay fresh.
+ */
+class FramePublisher : public odcore::base::Service, 
+    public odcore::io::PacketListener, public DatagramListener {
+   private:
+    FramePublisher(FramePublisher const &) = delete;
+    FramePublisher &operator=(FramePublisher const &) = delete;
+
+   public:
+    FramePublisher(DatagramListener &);
+    virtual ~FramePublisher();
+    uint64_t GetReceivedCount() const;
+    uint64_t GetDroppedCount() const;
+    uint64_t GetPublishedCount() const;
+
+   private:
+    virtual void nextPacket(odcore::data::Packet const &);
+    virtual void nextDatagram(uint8_t const *, uint32_t, 
+        odcore::data::TimeStamp const &);
+    virtual void beforeStop();
+    virtual void run();
+
+    DatagramListener &m_listener;
+    FrameMailbox m_mailbox;
+};
+
+}
+}
+}
+
+#endif
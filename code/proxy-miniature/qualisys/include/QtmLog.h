@@ -0,0 +1,95 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_QTMLOG_H
+#define PROXY_MINIATURE_QTMLOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * A log of raw QTM RT packets, as written by the QtmRecorder, mapped read
+ * only into memory. The packets are stored in segment files, each a file
+ * header followed by records of a record header and the packet, padded to
+ * eight bytes. A sidecar index file has a file header followed by an entry
+ * for every packet, giving its segment, offset, size and arrival time in
+ * microseconds, so the packets are found without scanning the segments.
+ * The files are in the byte order of the host.
+ */
+class QtmLog {
+   public:
+    struct fileHeader {
+      char magic[4];
+      uint32_t version;
+      uint32_t segment;
+      uint32_t reserved;
+    };
+
+    struct recordHeader {
+      int64_t arrival;
+      uint32_t size;
+      uint32_t reserved;
+    };
+
+    struct indexEntry {
+      int64_t arrival;
+      uint64_t offset;
+      uint32_t segment;
+      uint32_t size;
+    };
+
+    QtmLog(std::string const &);
+    QtmLog(QtmLog const &) = delete;
+    QtmLog &operator=(QtmLog const &) = delete;
+    virtual ~QtmLog();
+    uint32_t GetCount() const;
+    uint32_t GetSegmentCount() const;
+    uint8_t const *GetData(uint32_t) const;
+    uint32_t GetSize(uint32_t) const;
+    int64_t GetArrival(uint32_t) const;
+
+    static std::string GetIndexFilename(std::string const &);
+    static std::string GetSegmentFilename(std::string const &, uint32_t);
+
+    static char const SEGMENT_MAGIC[4];
+    static char const INDEX_MAGIC[4];
+    static uint32_t const VERSION;
+    static uint32_t const ALIGNMENT;
+
+   private:
+    static void *Map(std::string const &, size_t &);
+    indexEntry const *GetEntry(uint32_t) const;
+    void Unmap();
+
+    void *m_index;
+    size_t m_indexSize;
+    uint32_t m_count;
+    std::vector<void *> m_segments;
+    std::vector<size_t> m_segmentSizes;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_QTMPACKET_H
+#define PROXY_MINIATURE_QTMPACKET_H
+
+#include <cstdint>
+#include <vector>
+
+#include "MarkerBuffer.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * A view of a QTM RT data packet, read in place from the received bytes.
+ * Parse checks the packet header and the size of every component once, so
+ * the fields and the marker arrays are loaded afterwards without any more
+ * range checks. Nothing is copied or allocated, the bytes must outlive the
+ * view. The markers are read from the 3D components, with or without labels
+ * and residuals, and the rigid bodies solved by QTM from the 6D components.
+ */
+class QtmPacket {
+  public:
+    QtmPacket();
+    QtmPacket(QtmPacket const &) = delete;
+    QtmPacket &operator=(QtmPacket const &) = delete;
+    virtual ~QtmPacket();
+    void SetBigEndian(bool);
+    bool Parse(uint8_t const *, uint32_t);
+    uint32_t GetSize() const;
+    int32_t GetType() const;
+    int64_t GetTimestamp() const;
+    int32_t GetFrameNumber() const;
+    uint32_t GetComponentCount() const;
+    int32_t GetComponentType(uint32_t) const;
+    bool Read3d(uint32_t, MarkerBuffer &, float &) const;
+    uint32_t GetBodyCount(uint32_t) const;
+    bool ReadBody(uint32_t, uint32_t, opendlv::model::Cartesian3 &, 
+        opendlv::model::Cartesian3 &, float &) const;
+
+    static bool Is3d(int32_t);
+    static bool IsLabelled(int32_t);
+    static bool Is6d(int32_t);
+
+    static int32_t const TYPE_ERROR;
+    static int32_t const TYPE_COMMAND;
+    static int32_t const TYPE_XML;
+    static int32_t const TYPE_DATA;
+    static int32_t const TYPE_EVENT;
+    static int32_t const COMPONENT_3D;
+    static int32_t const COMPONENT_3D_NO_LABELS;
+    static int32_t const COMPONENT_6D;
+    static int32_t const COMPONENT_6D_EULER;
+    static int32_t const COMPONENT_3D_RESIDUAL;
+    static int32_t const COMPONENT_3D_NO_LABELS_RESIDUAL;
+    static int32_t const COMPONENT_6D_RESIDUAL;
+    static int32_t const COMPONENT_6D_EULER_RESIDUAL;
+
+  private:
+    static uint32_t const MAX_COMPONENT_COUNT;
+    static uint32_t const HEADER_SIZE;
+    static uint32_t const DATA_HEADER_SIZE;
+    static uint32_t const COMPONENT_HEADER_SIZE;
+    static float const MILLIMETER;
+    static float const DEGREE;
+
+    static uint32_t GetItemSize(int32_t);
+
+    template <typename T, bool SWAP>
+    static T Load(uint8_t const *);
+    template <typename T>
+    T Load(uint32_t) const;
+    template <uint32_t STRIDE>
+    static uint32_t ConvertMarkers(uint8_t const *, uint32_t, float *, float *, 
+        float *);
+    template <bool SWAP, uint32_t STRIDE, bool LABELLED>
+    static void LoadMarkers(uint8_t const *, uint32_t, MarkerBuffer &);
+    template <bool SWAP>
+    static void LoadMarkers(int32_t, uint8_t const *, uint32_t, 
+        MarkerBuffer &);
+
+    uint8_t const *m_bytes;
+    uint32_t m_size;
+    bool m_swap;
+    int32_t m_type;
+    uint32_t m_componentCount;
+    std::vector<uint32_t> m_componentOffsets;
+    std::vector<uint32_t> m_componentSizes;
+};
+
+}
+}
+}
+
+#endif
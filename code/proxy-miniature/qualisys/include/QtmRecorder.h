@@ -0,0 +1,85 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_QTMRECORDER_H
+#define PROXY_MINIATURE_QTMRECORDER_H
+
+#include <string>
+#include <vector>
+
+#include <opendavinci/odcore/io/PacketListener.h>
+#include <opendavinci/generated/odcore/data/Packet.h>
+
+#include "BatchUdpReceiver.h"
+#include "QtmLog.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * This class records the raw QTM RT packets, with the time they arrived, to
+ * a QtmLog, and passes them on to a listener. Each segment file is
+ * allocated at its full size and mapped into memory up front, so recording
+ * a packet is a copy into the mapping and no system call. The index entries
+ * are written in blocks. A full segment is cut to the size used and the
+ * next one is started.
+ */
+class QtmRecorder : public odcore::io::PacketListener, 
+    public DatagramListener {
+   private:
+    QtmRecorder(QtmRecorder const &) = delete;
+    QtmRecorder &operator=(QtmRecorder const &) = delete;
+
+   public:
+    QtmRecorder(std::string const &, uint32_t, DatagramListener *);
+    virtual ~QtmRecorder();
+    uint32_t GetSegmentSize() const;
+    uint32_t GetSegmentCount() const;
+    uint64_t GetRecordedCount() const;
+    uint64_t GetRecordedBytes() const;
+
+    static uint32_t const INDEX_BLOCK_SIZE;
+
+   private:
+    virtual void nextPacket(odcore::data::Packet const &);
+    virtual void nextDatagram(uint8_t const *, uint32_t, 
+        odcore::data::TimeStamp const &);
+    void Record(uint8_t const *, uint32_t, int64_t);
+    void OpenSegment();
+    void CloseSegment();
+    void WriteIndex();
+
+    std::string m_prefix;
+    uint32_t m_segmentSize;
+    DatagramListener *m_listener;
+    int m_indexFile;
+    std::vector<QtmLog::indexEntry> m_indexBlock;
+    int m_segmentFile;
+    uint8_t *m_segment;
+    uint32_t m_segmentCount;
+    uint32_t m_segmentUsed;
+    uint64_t m_recordedCount;
+    uint64_t m_recordedBytes;
+};
+
+}
+}
+}
+
+#endif
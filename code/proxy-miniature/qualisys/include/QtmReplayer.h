@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_QTMREPLAYER_H
+#define PROXY_MINIATURE_QTMREPLAYER_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <opendavinci/odcore/base/Service.h>
+
+#include "BatchUdpReceiver.h"
+#include "QtmLog.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * This class replays a QtmLog to a listener, such as the packet decoder, in
+ * place of the receiver. Each packet is given with the arrival time it was
+ * recorded with, so that the replay decodes to the same frames and poses
+ * every time. The packets are given either at their recorded pace or as
+ * fast as the listener takes them, which measures the throughput of the
+ * decoding and the LPS.
+ */
+class QtmReplayer : public odcore::base::Service {
+   private:
+    QtmReplayer(QtmReplayer const &) = delete;
+    QtmReplayer &operator=(QtmReplayer const &) = delete;
+
+   public:
+    QtmReplayer(std::string const &, bool, DatagramListener &);
+    virtual ~QtmReplayer();
+    uint32_t GetCount() const;
+    uint32_t GetReplayedCount() const;
+    double GetDuration() const;
+    bool IsDone() const;
+
+   private:
+    virtual void beforeStop();
+    virtual void run();
+    bool WaitUntil(std::chrono::steady_clock::time_point const &);
+
+    QtmLog m_log;
+    bool m_isRealTime;
+    DatagramListener &m_listener;
+    std::atomic<uint32_t> m_replayedCount;
+    std::atomic<int64_t> m_duration;
+    std::atomic<bool> m_isDone;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_QTMSTREAMSETTINGS_H
+#define PROXY_MINIATURE_QTMSTREAMSETTINGS_H
+
+#include <string>
+#include <vector>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * The rate and the components to stream QTM frames with. The rate is given
+ * as one of all frames, every n:th frame of the cameras, or a frequency, in
+ * that order of precedence.
+ */
+class QtmStreamSettings {
+   public:
+    QtmStreamSettings(uint32_t, uint32_t, bool, uint32_t, std::string const &);
+    QtmStreamSettings(QtmStreamSettings const &) = default;
+    QtmStreamSettings &operator=(QtmStreamSettings const &) = default;
+    virtual ~QtmStreamSettings();
+    std::string GetCommand() const;
+    std::vector<std::string> GetUnknownComponents() const;
+    float GetRate(float) const;
+
+    static std::vector<std::string> const COMPONENTS;
+
+   private:
+    uint32_t m_frequency;
+    uint32_t m_frequencyDivisor;
+    bool m_allFrames;
+    uint32_t m_port;
+    std::vector<std::string> m_components;
+};
+
+}
+}
+}
+
+#endif
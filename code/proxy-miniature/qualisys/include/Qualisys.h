@@ -25,8 +25,14 @@
 #include <opendavinci/odcore/io/tcp/TCPConnection.h>
 #include <opendavinci/odcore/io/udp/UDPReceiver.h>
 
+#include "BatchUdpReceiver.h"
+#include "FramePublisher.h"
+#include "Localizer.h"
+#include "QtmRecorder.h"
+#include "QtmReplayer.h"
 #include "QualisysStringDecoder.h"
 #include "QualisysPacketDecoder.h"
+#include "StreamMonitor.h"
 
 namespace opendlv {
 namespace proxy {
@@ -49,8 +55,14 @@ class Qualisys : public odcore::base::module::DataTriggeredConferenceClientModul
 
     std::shared_ptr<odcore::io::tcp::TCPConnection> m_qualisysTCP;
     std::shared_ptr<odcore::io::udp::UDPReceiver> m_qualisysUDP;
+    std::unique_ptr<BatchUdpReceiver> m_batchReceiver;
     std::unique_ptr<QualisysStringDecoder> m_qualisysStringDecoder;
+    std::unique_ptr<Localizer> m_localizer;
     std::unique_ptr<QualisysPacketDecoder> m_qualisysPacketListener;
+    std::unique_ptr<FramePublisher> m_framePublisher;
+    std::unique_ptr<StreamMonitor> m_streamMonitor;
+    std::unique_ptr<QtmRecorder> m_recorder;
+    std::unique_ptr<QtmReplayer> m_replayer;
 
 };
 
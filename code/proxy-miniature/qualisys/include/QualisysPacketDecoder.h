@@ -17,33 +17,60 @@
  */
 
 #ifndef PROXY_MINIATURE_QUALISYSPACKETDECODER_H
-#define PROXY_MINIATURE_QUALISYSSTRINGDECODER_H
+#define PROXY_MINIATURE_QUALISYSPACKETDECODER_H
+
+#include <vector>
 
 #include <opendavinci/odcore/io/conference/ContainerConference.h>
 #include <opendavinci/odcore/io/PacketListener.h>
 #include <opendavinci/generated/odcore/data/Packet.h>
 
+#include "BatchUdpReceiver.h"
+#include "Localizer.h"
+#include "MarkerBuffer.h"
+#include "QtmPacket.h"
+#include "StreamStatistics.h"
+
 namespace opendlv {
 namespace proxy {
 namespace miniature {
 /**
- * This class decodes udp packets from the Qualisys unit.
+ * This class decodes udp packets from the Qualisys unit. The markers of each
+ * frame are sent as a QtmFrame, or, if a localizer is given, the poses it
+ * finds in them are sent instead. Rigid bodies solved by QTM are sent as
+ * State. It takes packets both from the OpenDaVINCI UDPReceiver and from the
+ * BatchUdpReceiver. The time taken to decode each frame and its quality
+ * are added to the statistics of the stream, if given.
  */
-class QualisysPacketDecoder : public odcore::io::PacketListener {
+class QualisysPacketDecoder : public odcore::io::PacketListener, 
+    public DatagramListener {
    private:
     QualisysPacketDecoder(QualisysPacketDecoder const &) = delete;
     QualisysPacketDecoder &operator=(QualisysPacketDecoder const &) = delete;
 
    public:
-    QualisysPacketDecoder(odcore::io::conference::ContainerConference &, bool);
+    QualisysPacketDecoder(odcore::io::conference::ContainerConference &, bool, 
+        Localizer *);
     virtual ~QualisysPacketDecoder();
-
+    void SetBodyFrameIds(std::vector<int16_t> const &);
+    void SetBigEndian(bool);
+    void SetStatistics(StreamStatistics *);
 
    private:
     virtual void nextPacket(odcore::data::Packet const &);
+    virtual void nextDatagram(uint8_t const *, uint32_t, 
+        odcore::data::TimeStamp const &);
+    bool Decode(uint8_t const *, uint32_t, odcore::data::TimeStamp const &, 
+        float &);
+    void SendBodies(uint32_t);
 
     odcore::io::conference::ContainerConference &m_conference;
     bool m_debug;
+    Localizer *m_localizer;
+    QtmPacket m_packet;
+    MarkerBuffer m_markers;
+    std::vector<int16_t> m_bodyFrameIds;
+    StreamStatistics *m_statistics;
 };
 
 }
@@ -19,8 +19,10 @@
 #ifndef PROXY_MINIATURE_QUALISYSSTRINGDECODER_H
 #define PROXY_MINIATURE_QUALISYSSTRINGDECODER_H
 
-#include <sstream>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <opendavinci/odcore/io/StringListener.h>
 #include <opendavinci/odcore/io/conference/ContainerConference.h>
@@ -29,7 +31,10 @@ namespace opendlv {
 namespace proxy {
 namespace miniature {
 /**
- * This class decodes data from the Qualisys unit.
+ * This class decodes the replies of the Qualisys unit on the TCP control
+ * connection. The stream is split into packets, which may arrive split or
+ * joined, and the replies confirming the protocol version, the byte order
+ * and the camera frequency are kept, as well as any errors.
  */
 class QualisysStringDecoder : public odcore::io::StringListener {
    private:
@@ -41,8 +46,23 @@ class QualisysStringDecoder : public odcore::io::StringListener {
     virtual ~QualisysStringDecoder();
 
     virtual void nextString(const std::string &s);
+    bool WaitForByteOrder(uint32_t);
+    bool WaitForCameraFrequency(uint32_t);
+    std::string GetVersion() const;
+    std::string GetByteOrder() const;
+    float GetCameraFrequency() const;
+    std::vector<std::string> GetErrors() const;
 
-   // private:
+   private:
+    void Decode(int32_t, std::string const &);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::string m_pending;
+    std::string m_version;
+    std::string m_byteOrder;
+    float m_cameraFrequency;
+    std::vector<std::string> m_errors;
 };
 
 }
@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_STREAMMONITOR_H
+#define PROXY_MINIATURE_STREAMMONITOR_H
+
+#include <opendavinci/odcore/io/conference/ContainerConference.h>
+#include <opendavinci/odcore/io/PacketListener.h>
+#include <opendavinci/generated/odcore/data/Packet.h>
+
+#include "BatchUdpReceiver.h"
+#include "FramePublisher.h"
+#include "QtmPacket.h"
+#include "StreamStatistics.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * This class measures the QTM stream where the packets are received, before
+ * any of them are skipped by a FramePublisher, and passes them on to a
+ * listener. Only the header of each packet is read, for its frame number.
+ * The statistics are sent as QtmStreamStatistics once per period, with the
+ * packets the publisher skipped counted apart from the frames lost by QTM.
+ */
+class StreamMonitor : public odcore::io::PacketListener, 
+    public DatagramListener {
+   private:
+    StreamMonitor(StreamMonitor const &) = delete;
+    StreamMonitor &operator=(StreamMonitor const &) = delete;
+
+   public:
+    StreamMonitor(odcore::io::conference::ContainerConference &, bool, 
+        double, DatagramListener &, FramePublisher const *);
+    virtual ~StreamMonitor();
+    void SetBigEndian(bool);
+    StreamStatistics &GetStatistics();
+
+   private:
+    virtual void nextPacket(odcore::data::Packet const &);
+    virtual void nextDatagram(uint8_t const *, uint32_t, 
+        odcore::data::TimeStamp const &);
+
+    odcore::io::conference::ContainerConference &m_conference;
+    bool m_debug;
+    double m_period;
+    DatagramListener &m_listener;
+    FramePublisher const *m_publisher;
+    uint64_t m_droppedCount;
+    QtmPacket m_packet;
+    StreamStatistics m_statistics;
+};
+
+}
+}
+}
+
+#endif
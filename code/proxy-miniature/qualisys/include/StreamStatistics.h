@@ -0,0 +1,86 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_STREAMSTATISTICS_H
+#define PROXY_MINIATURE_STREAMSTATISTICS_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Statistics of the QTM stream over a window of time. Lost frames are found
+ * from gaps in the frame numbers, in steps of the smallest difference seen,
+ * which is the frequency divisor of the stream. The time between the
+ * arrivals of packets is kept as mean, standard deviation, maximum and a
+ * histogram, with the bins edged by INTERVAL_BIN_EDGES in seconds. The
+ * packets are added as they are received, and the decode time and quality
+ * of the frames that are decoded are added from the decoding thread.
+ */
+class StreamStatistics {
+   public:
+    StreamStatistics();
+    StreamStatistics(StreamStatistics const &) = delete;
+    StreamStatistics &operator=(StreamStatistics const &) = delete;
+    virtual ~StreamStatistics();
+    void Add(int32_t, int64_t, uint32_t);
+    void AddMalformed(int64_t, uint32_t);
+    void AddDecoded(float, float);
+    bool IsDue(int64_t, double) const;
+    opendlv::proxy::QtmStreamStatistics Report(int64_t, uint32_t);
+
+    static std::vector<float> const INTERVAL_BIN_EDGES;
+
+   private:
+    void Start(int64_t);
+    void Reset(int64_t);
+
+    bool m_hasWindow;
+    int64_t m_windowStart;
+    bool m_hasLastFrame;
+    int32_t m_lastFrameNumber;
+    int64_t m_lastArrival;
+    int32_t m_frameStep;
+    uint32_t m_packetCount;
+    uint32_t m_malformedCount;
+    uint32_t m_lostFrameCount;
+    uint32_t m_reorderedCount;
+    uint64_t m_byteCount;
+    uint32_t m_intervalCount;
+    double m_intervalSum;
+    double m_intervalSquareSum;
+    float m_maxInterval;
+    std::vector<uint32_t> m_intervalHistogram;
+    std::mutex m_decodeMutex;
+    uint32_t m_decodedCount;
+    double m_decodeTimeSum;
+    float m_maxDecodeTime;
+    double m_qualitySum;
+};
+
+}
+}
+}
+
+#endif
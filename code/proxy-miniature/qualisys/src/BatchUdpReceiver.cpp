@@ -0,0 +1,260 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "BatchUdpReceiver.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+// The largest datagram of the QTM RT protocol over UDP.
+uint32_t const BatchUdpReceiver::MAX_DATAGRAM_SIZE = 65536;
+
+/**
+ * Binds a socket to the port, and joins the group if the address is a
+ * multicast address. Each call to recvmmsg drains up to a batch size of
+ * datagrams. A receive buffer size of 0 keeps the default of the kernel.
+ * Throws std::runtime_error on errors.
+ */
+BatchUdpReceiver::BatchUdpReceiver(std::string const &a_address, 
+    uint32_t a_port, uint32_t a_batchSize, int32_t a_receiveBufferSize)
+    : Service()
+    , m_socket(-1)
+    , m_batchSize((a_batchSize > 0) ? a_batchSize : 1)
+    , m_receiveBufferSize(0)
+    , m_listener(nullptr)
+    , m_data(m_batchSize * MAX_DATAGRAM_SIZE)
+    , m_control(m_batchSize * CMSG_SPACE(sizeof(struct timespec)))
+    , m_iovecs(m_batchSize)
+    , m_messages(m_batchSize)
+    , m_datagramCount(0)
+    , m_batchCount(0)
+    , m_truncatedCount(0)
+    , m_largestBatch(0)
+{
+  m_socket = socket(AF_INET, SOCK_DGRAM, 0);
+  if (m_socket < 0) {
+    throw std::runtime_error(std::string("Could not create socket: ") 
+        + std::strerror(errno));
+  }
+
+  int const enable = 1;
+  setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  if (setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMPNS, &enable, 
+      sizeof(enable)) < 0) {
+    std::string const error = std::strerror(errno);
+    close(m_socket);
+    throw std::runtime_error(
+        std::string("Could not enable receive timestamps: ") + error);
+  }
+
+  // The kernel doubles the size given, and caps it at net.core.rmem_max.
+  if (a_receiveBufferSize > 0) {
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &a_receiveBufferSize, 
+        sizeof(a_receiveBufferSize));
+  }
+  socklen_t length = sizeof(m_receiveBufferSize);
+  getsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &m_receiveBufferSize, &length);
+
+  struct sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(static_cast<uint16_t>(a_port));
+  if (bind(m_socket, reinterpret_cast<struct sockaddr *>(&address), 
+      sizeof(address)) < 0) {
+    std::string const error = std::strerror(errno);
+    close(m_socket);
+    throw std::runtime_error(std::string("Could not bind to port ") 
+        + std::to_string(a_port) + ": " + error);
+  }
+
+  struct in_addr group;
+  if (inet_pton(AF_INET, a_address.c_str(), &group) == 1 
+      && IN_MULTICAST(ntohl(group.s_addr))) {
+    struct ip_mreq request;
+    request.imr_multiaddr = group;
+    request.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, 
+        sizeof(request)) < 0) {
+      std::string const error = std::strerror(errno);
+      close(m_socket);
+      throw std::runtime_error(std::string("Could not join ") + a_address 
+          + ": " + error);
+    }
+  }
+
+  // Every message of the batch points at its own slice of the data and
+  // control buffers, which are allocated once here.
+  for (uint32_t i = 0; i < m_batchSize; i++) {
+    m_iovecs[i].iov_base = &m_data[i * MAX_DATAGRAM_SIZE];
+    m_iovecs[i].iov_len = MAX_DATAGRAM_SIZE;
+    std::memset(&m_messages[i], 0, sizeof(m_messages[i]));
+    m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+    m_messages[i].msg_hdr.msg_iovlen = 1;
+    m_messages[i].msg_hdr.msg_control = 
+        &m_control[i * CMSG_SPACE(sizeof(struct timespec))];
+  }
+}
+
+BatchUdpReceiver::~BatchUdpReceiver()
+{
+  if (m_socket >= 0) {
+    close(m_socket);
+  }
+}
+
+/**
+ * Sets the listener to give the datagrams to. It must be set before the
+ * receiver is started.
+ */
+void BatchUdpReceiver::SetDatagramListener(DatagramListener *a_listener)
+{
+  m_listener = a_listener;
+}
+
+uint32_t BatchUdpReceiver::GetBatchSize() const
+{
+  return m_batchSize;
+}
+
+/**
+ * Returns the receive buffer size of the socket as set by the kernel.
+ */
+int32_t BatchUdpReceiver::GetReceiveBufferSize() const
+{
+  return m_receiveBufferSize;
+}
+
+uint64_t BatchUdpReceiver::GetDatagramCount() const
+{
+  return m_datagramCount;
+}
+
+uint64_t BatchUdpReceiver::GetBatchCount() const
+{
+  return m_batchCount;
+}
+
+/**
+ * Returns the number of datagrams dropped because they were larger than
+ * MAX_DATAGRAM_SIZE.
+ */
+uint64_t BatchUdpReceiver::GetTruncatedCount() const
+{
+  return m_truncatedCount;
+}
+
+uint32_t BatchUdpReceiver::GetLargestBatch() const
+{
+  return m_largestBatch;
+}
+
+void BatchUdpReceiver::beforeStop()
+{
+}
+
+/**
+ * Waits for datagrams with a timeout, so that the service notices when it is
+ * stopped, and drains the socket once it is readable.
+ */
+void BatchUdpReceiver::run()
+{
+  serviceReady();
+  struct pollfd descriptor;
+  descriptor.fd = m_socket;
+  descriptor.events = POLLIN;
+  while (isRunning()) {
+    descriptor.revents = 0;
+    int const ready = poll(&descriptor, 1, 100);
+    if (ready < 0 && errno != EINTR) {
+      std::cerr << "[BatchUdpReceiver] Could not poll: " 
+          << std::strerror(errno) << std::endl;
+      break;
+    }
+    if (ready > 0) {
+      while (Receive() == m_batchSize) {
+      }
+    }
+  }
+}
+
+/**
+ * Receives up to a batch of datagrams without blocking, and gives each to
+ * the listener. Returns the number received.
+ */
+uint32_t BatchUdpReceiver::Receive()
+{
+  for (uint32_t i = 0; i < m_batchSize; i++) {
+    m_messages[i].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(struct timespec));
+    m_messages[i].msg_hdr.msg_flags = 0;
+  }
+  int const count = recvmmsg(m_socket, m_messages.data(), m_batchSize, 
+      MSG_DONTWAIT, nullptr);
+  if (count <= 0) {
+    return 0;
+  }
+
+  uint32_t const received = static_cast<uint32_t>(count);
+  m_datagramCount += received;
+  m_batchCount++;
+  if (received > m_largestBatch) {
+    m_largestBatch = received;
+  }
+
+  for (uint32_t i = 0; i < received; i++) {
+    struct msghdr &header = m_messages[i].msg_hdr;
+    if ((header.msg_flags & MSG_TRUNC) != 0) {
+      m_truncatedCount++;
+      continue;
+    }
+
+    // Falls back to the time now if the kernel gave no timestamp.
+    odcore::data::TimeStamp arrival;
+    for (struct cmsghdr *message = CMSG_FIRSTHDR(&header); message != nullptr;
+        message = CMSG_NXTHDR(&header, message)) {
+      if (message->cmsg_level == SOL_SOCKET 
+          && message->cmsg_type == SCM_TIMESTAMPNS) {
+        struct timespec time;
+        std::memcpy(&time, CMSG_DATA(message), sizeof(time));
+        arrival = odcore::data::TimeStamp(static_cast<int32_t>(time.tv_sec), 
+            static_cast<int32_t>(time.tv_nsec / 1000));
+      }
+    }
+
+    if (m_listener != nullptr) {
+      m_listener->nextDatagram(static_cast<uint8_t const *>(
+          m_iovecs[i].iov_base), m_messages[i].msg_len, arrival);
+    }
+  }
+  return received;
+}
+
+}
+}
+}
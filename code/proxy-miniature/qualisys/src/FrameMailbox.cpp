@@ -0,0 +1,146 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <chrono>
+#include <cstring>
+
+#include "FrameMailbox.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+uint32_t const FrameMailbox::SLOT_MASK = 0x3;
+uint32_t const FrameMailbox::FRESH = 0x4;
+
+/**
+ * Allocates the three buffers, each holding a packet of up to the given
+ * capacity in bytes.
+ */
+FrameMailbox::FrameMailbox(uint32_t a_capacity)
+    : m_capacity(a_capacity)
+    , m_data(3 * a_capacity)
+    , m_sizes(3, 0)
+    , m_arrivals(3)
+    , m_writeSlot(0)
+    , m_readSlot(1)
+    , m_readySlot(2)
+    , m_mutex()
+    , m_condition()
+    , m_postedCount(0)
+    , m_droppedCount(0)
+    , m_takenCount(0)
+{
+}
+
+FrameMailbox::~FrameMailbox()
+{
+}
+
+/**
+ * Copies the packet into the buffer of the writer, and makes it the latest.
+ * If the previous latest packet was not taken, it is dropped. Packets
+ * larger than the capacity are dropped.
+ */
+void FrameMailbox::Post(uint8_t const *a_data, uint32_t a_size, 
+    odcore::data::TimeStamp const &a_arrival)
+{
+  m_postedCount++;
+  if (a_size > m_capacity) {
+    m_droppedCount++;
+    return;
+  }
+
+  std::memcpy(&m_data[m_writeSlot * m_capacity], a_data, a_size);
+  m_sizes[m_writeSlot] = a_size;
+  m_arrivals[m_writeSlot] = a_arrival;
+
+  uint32_t const previous = m_readySlot.exchange(m_writeSlot | FRESH);
+  m_writeSlot = previous & SLOT_MASK;
+  if ((previous & FRESH) != 0) {
+    m_droppedCount++;
+  }
+
+  // The lock orders the post against a reader that is about to wait, so
+  // that the wake up is not lost.
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+  }
+  m_condition.notify_one();
+}
+
+/**
+ * Takes the latest packet, if one was posted since the last one taken,
+ * waiting for up to the given time in milliseconds. Returns false if there
+ * was none. The packet is then read by GetData, GetSize and GetArrival, and
+ * stays valid until the next call.
+ */
+bool FrameMailbox::Take(uint32_t a_timeout)
+{
+  if ((m_readySlot.load() & FRESH) == 0) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool const isFresh = m_condition.wait_for(lock, 
+        std::chrono::milliseconds(a_timeout), 
+        [this]() { return (m_readySlot.load() & FRESH) != 0; });
+    if (!isFresh) {
+      return false;
+    }
+  }
+
+  m_readSlot = m_readySlot.exchange(m_readSlot) & SLOT_MASK;
+  m_takenCount++;
+  return true;
+}
+
+uint8_t const *FrameMailbox::GetData() const
+{
+  return &m_data[m_readSlot * m_capacity];
+}
+
+uint32_t FrameMailbox::GetSize() const
+{
+  return m_sizes[m_readSlot];
+}
+
+odcore::data::TimeStamp const &FrameMailbox::GetArrival() const
+{
+  return m_arrivals[m_readSlot];
+}
+
+uint64_t FrameMailbox::GetPostedCount() const
+{
+  return m_postedCount;
+}
+
+/**
+ * Returns the number of packets that were replaced by a newer one before
+ * they were taken, or that did not fit.
+ */
+uint64_t FrameMailbox::GetDroppedCount() const
+{
+  return m_droppedCount;
+}
+
+uint64_t FrameMailbox::GetTakenCount() const
+{
+  return m_takenCount;
+}
+
+}
+}
+}
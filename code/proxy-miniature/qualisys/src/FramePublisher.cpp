@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <string>
+
+#include "FramePublisher.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+FramePublisher::FramePublisher(DatagramListener &a_listener)
+    : Service()
+    , PacketListener()
+    , DatagramListener()
+    , m_listener(a_listener)
+    , m_mailbox(BatchUdpReceiver::MAX_DATAGRAM_SIZE)
+{
+}
+
+FramePublisher::~FramePublisher()
+{
+}
+
+uint64_t FramePublisher::GetReceivedCount() const
+{
+  return m_mailbox.GetPostedCount();
+}
+
+/**
+ * Returns the number of packets skipped because a newer one arrived before
+ * they were published.
+ */
+uint64_t FramePublisher::GetDroppedCount() const
+{
+  return m_mailbox.GetDroppedCount();
+}
+
+uint64_t FramePublisher::GetPublishedCount() const
+{
+  return m_mailbox.GetTakenCount();
+}
+
+/**
+ * Posts a packet from the OpenDaVINCI receiver, stamped with the time now.
+ */
+void FramePublisher::nextPacket(odcore::data::Packet const &a_packet)
+{
+  odcore::data::TimeStamp now;
+  std::string const data = a_packet.getData();
+  m_mailbox.Post(reinterpret_cast<uint8_t const *>(data.data()), 
+      static_cast<uint32_t>(data.size()), now);
+}
+
+void FramePublisher::nextDatagram(uint8_t const *a_data, uint32_t a_size, 
+    odcore::data::TimeStamp const &a_arrival)
+{
+  m_mailbox.Post(a_data, a_size, a_arrival);
+}
+
+void FramePublisher::beforeStop()
+{
+}
+
+/**
+ * Gives the latest packet to the listener whenever there is a new one. The
+ * wait times out, so that the service notices when it is stopped.
+ */
+void FramePublisher::run()
+{
+  serviceReady();
+  while (isRunning()) {
+    if (m_mailbox.Take(100)) {
+      m_listener.nextDatagram(m_mailbox.GetData(), m_mailbox.GetSize(), 
+          m_mailbox.GetArrival());
+    }
+  }
+}
+
+}
+}
+}
@@ -0,0 +1,198 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "QtmLog.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+char const QtmLog::SEGMENT_MAGIC[4] = {'Q', 'T', 'M', 'L'};
+char const QtmLog::INDEX_MAGIC[4] = {'Q', 'T', 'M', 'I'};
+// Increase when the layout of the files changes.
+uint32_t const QtmLog::VERSION = 1;
+// Keeps the record headers aligned when read in place.
+uint32_t const QtmLog::ALIGNMENT = 8;
+
+/**
+ * Maps the index and every segment it refers to, and checks that every
+ * entry lies within its segment. Throws std::runtime_error on errors.
+ */
+QtmLog::QtmLog(std::string const &a_prefix)
+    : m_index(nullptr)
+    , m_indexSize(0)
+    , m_count(0)
+    , m_segments()
+    , m_segmentSizes()
+{
+  m_index = Map(GetIndexFilename(a_prefix), m_indexSize);
+  fileHeader header;
+  std::memcpy(&header, m_index, sizeof(header));
+  if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 
+      || header.version != VERSION) {
+    Unmap();
+    throw std::runtime_error(std::string("Not a QTM log index of version ") 
+        + std::to_string(VERSION) + ": " + GetIndexFilename(a_prefix));
+  }
+  // An index cut short by a crash ends at its last whole entry.
+  m_count = static_cast<uint32_t>(
+      (m_indexSize - sizeof(fileHeader)) / sizeof(indexEntry));
+
+  for (uint32_t i = 0; i < m_count; i++) {
+    indexEntry const *entry = GetEntry(i);
+    try {
+      while (entry->segment >= m_segments.size()) {
+        size_t size = 0;
+        m_segments.push_back(Map(GetSegmentFilename(a_prefix, 
+            static_cast<uint32_t>(m_segments.size())), size));
+        m_segmentSizes.push_back(size);
+      }
+    } catch (std::exception const &) {
+      Unmap();
+      throw;
+    }
+    // Compared without adding, so that a corrupt offset cannot wrap around.
+    uint64_t const segmentSize = m_segmentSizes[entry->segment];
+    if (entry->offset < sizeof(fileHeader) + sizeof(recordHeader) 
+        || entry->offset > segmentSize 
+        || entry->size > segmentSize - entry->offset) {
+      Unmap();
+      throw std::runtime_error(std::string("QTM log entry ") 
+          + std::to_string(i) + " is outside of its segment.");
+    }
+  }
+}
+
+QtmLog::~QtmLog()
+{
+  Unmap();
+}
+
+uint32_t QtmLog::GetCount() const
+{
+  return m_count;
+}
+
+uint32_t QtmLog::GetSegmentCount() const
+{
+  return static_cast<uint32_t>(m_segments.size());
+}
+
+/**
+ * Returns the bytes of a packet, in place in the mapped segment.
+ */
+uint8_t const *QtmLog::GetData(uint32_t a_index) const
+{
+  indexEntry const *entry = GetEntry(a_index);
+  return static_cast<uint8_t const *>(m_segments[entry->segment]) 
+      + entry->offset;
+}
+
+uint32_t QtmLog::GetSize(uint32_t a_index) const
+{
+  indexEntry const *entry = GetEntry(a_index);
+  return entry->size;
+}
+
+/**
+ * Returns the time in microseconds the packet arrived when recorded.
+ */
+int64_t QtmLog::GetArrival(uint32_t a_index) const
+{
+  indexEntry const *entry = GetEntry(a_index);
+  return entry->arrival;
+}
+
+std::string QtmLog::GetIndexFilename(std::string const &a_prefix)
+{
+  return a_prefix + ".qtmidx";
+}
+
+std::string QtmLog::GetSegmentFilename(std::string const &a_prefix, 
+    uint32_t a_segment)
+{
+  char number[16];
+  std::snprintf(number, sizeof(number), "%04u", a_segment);
+  return a_prefix + "." + number + ".qtmlog";
+}
+
+/**
+ * Returns an entry in place in the mapped index. The entries follow the
+ * header, which keeps them aligned.
+ */
+QtmLog::indexEntry const *QtmLog::GetEntry(uint32_t a_index) const
+{
+  return reinterpret_cast<indexEntry const *>(
+      static_cast<uint8_t const *>(m_index) + sizeof(fileHeader)) + a_index;
+}
+
+/**
+ * Maps a whole file read only, and gives its size. Files shorter than a
+ * file header are refused. Throws std::runtime_error on errors.
+ */
+void *QtmLog::Map(std::string const &a_filename, size_t &a_size)
+{
+  int fd = open(a_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("Could not open ") + a_filename 
+        + ": " + std::strerror(errno));
+  }
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0 
+      || static_cast<size_t>(fileStatus.st_size) < sizeof(fileHeader)) {
+    close(fd);
+    throw std::runtime_error(std::string("Too short to be a QTM log: ") 
+        + a_filename);
+  }
+  a_size = static_cast<size_t>(fileStatus.st_size);
+  void *memory = mmap(nullptr, a_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error(std::string("Could not map ") + a_filename 
+        + ": " + std::strerror(errno));
+  }
+  return memory;
+}
+
+void QtmLog::Unmap()
+{
+  for (uint32_t i = 0; i < m_segments.size(); i++) {
+    munmap(m_segments[i], m_segmentSizes[i]);
+  }
+  m_segments.clear();
+  m_segmentSizes.clear();
+  if (m_index != nullptr) {
+    munmap(m_index, m_indexSize);
+    m_index = nullptr;
+  }
+  m_count = 0;
+}
+
+}
+}
+}
@@ -0,0 +1,486 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include "QtmPacket.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+int32_t const QtmPacket::TYPE_ERROR = 0;
+int32_t const QtmPacket::TYPE_COMMAND = 1;
+int32_t const QtmPacket::TYPE_XML = 2;
+int32_t const QtmPacket::TYPE_DATA = 3;
+int32_t const QtmPacket::TYPE_EVENT = 6;
+int32_t const QtmPacket::COMPONENT_3D = 1;
+int32_t const QtmPacket::COMPONENT_3D_NO_LABELS = 2;
+int32_t const QtmPacket::COMPONENT_6D = 5;
+int32_t const QtmPacket::COMPONENT_6D_EULER = 6;
+int32_t const QtmPacket::COMPONENT_3D_RESIDUAL = 9;
+int32_t const QtmPacket::COMPONENT_3D_NO_LABELS_RESIDUAL = 10;
+int32_t const QtmPacket::COMPONENT_6D_RESIDUAL = 11;
+int32_t const QtmPacket::COMPONENT_6D_EULER_RESIDUAL = 12;
+uint32_t const QtmPacket::MAX_COMPONENT_COUNT = 16;
+uint32_t const QtmPacket::HEADER_SIZE = 8;
+uint32_t const QtmPacket::DATA_HEADER_SIZE = 16;
+uint32_t const QtmPacket::COMPONENT_HEADER_SIZE = 8;
+float const QtmPacket::MILLIMETER = 1e-3f;
+float const QtmPacket::DEGREE = 3.14159265f / 180.0f;
+
+QtmPacket::QtmPacket()
+    : m_bytes(nullptr)
+    , m_size(0)
+    , m_swap(false)
+    , m_type(0)
+    , m_componentCount(0)
+    , m_componentOffsets(MAX_COMPONENT_COUNT, 0)
+    , m_componentSizes(MAX_COMPONENT_COUNT, 0)
+{
+}
+
+QtmPacket::~QtmPacket()
+{
+}
+
+/**
+ * Sets the byte order of the packets, which is little endian unless the
+ * client asked QTM for big endian.
+ */
+void QtmPacket::SetBigEndian(bool a_isBigEndian)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  m_swap = !a_isBigEndian;
+#else
+  m_swap = a_isBigEndian;
+#endif
+}
+
+/**
+ * Checks the packet and finds its components. Returns false if the packet
+ * is shorter than its header says, or if it is a data packet with a
+ * component that does not fit in it. Only the header is read of packets
+ * of other types.
+ */
+bool QtmPacket::Parse(uint8_t const *a_bytes, uint32_t a_size)
+{
+  m_bytes = a_bytes;
+  m_size = a_size;
+  m_type = 0;
+  m_componentCount = 0;
+  if (m_size < HEADER_SIZE) {
+    return false;
+  }
+  uint32_t const packetSize = static_cast<uint32_t>(Load<int32_t>(0));
+  if (packetSize < HEADER_SIZE || packetSize > m_size) {
+    return false;
+  }
+  m_size = packetSize;
+  m_type = Load<int32_t>(4);
+  if (m_type != TYPE_DATA) {
+    return true;
+  }
+  if (m_size < HEADER_SIZE + DATA_HEADER_SIZE) {
+    return false;
+  }
+
+  uint32_t const componentCount = 
+      static_cast<uint32_t>(Load<int32_t>(HEADER_SIZE + 12));
+  if (componentCount > MAX_COMPONENT_COUNT) {
+    return false;
+  }
+  uint32_t offset = HEADER_SIZE + DATA_HEADER_SIZE;
+  for (uint32_t i = 0; i < componentCount; i++) {
+    if (m_size - offset < COMPONENT_HEADER_SIZE) {
+      return false;
+    }
+    uint32_t const componentSize = 
+        static_cast<uint32_t>(Load<int32_t>(offset));
+    if (componentSize < COMPONENT_HEADER_SIZE || 
+        componentSize > m_size - offset) {
+      return false;
+    }
+    m_componentOffsets[i] = offset;
+    m_componentSizes[i] = componentSize;
+    offset += componentSize;
+  }
+  m_componentCount = componentCount;
+  return true;
+}
+
+/**
+ * The size of the packet in bytes, as given in its header.
+ */
+uint32_t QtmPacket::GetSize() const
+{
+  return m_size;
+}
+
+int32_t QtmPacket::GetType() const
+{
+  return m_type;
+}
+
+/**
+ * The time of the frame in microseconds, counted by QTM. This and the
+ * frame number are only read from a data packet.
+ */
+int64_t QtmPacket::GetTimestamp() const
+{
+  return Load<int64_t>(HEADER_SIZE);
+}
+
+int32_t QtmPacket::GetFrameNumber() const
+{
+  return Load<int32_t>(HEADER_SIZE + 8);
+}
+
+uint32_t QtmPacket::GetComponentCount() const
+{
+  return m_componentCount;
+}
+
+int32_t QtmPacket::GetComponentType(uint32_t a_component) const
+{
+  return Load<int32_t>(m_componentOffsets[a_component] + 4);
+}
+
+/**
+ * Reads a 3D component into the buffer with the positions in meters, and
+ * sets the quality from the 2D drop and out of sync rates. Markers that are
+ * not seen, which have NaN coordinates, are left out, and the residuals are
+ * not read. The id of a labelled marker is the index of its label, and -1
+ * without labels. Returns false if the component is of another type or its
+ * markers do not fit in it.
+ */
+bool QtmPacket::Read3d(uint32_t a_component, MarkerBuffer &a_markers, 
+    float &a_quality) const
+{
+  int32_t const type = GetComponentType(a_component);
+  if (!Is3d(type)) {
+    return false;
+  }
+  uint32_t const offset = m_componentOffsets[a_component];
+  uint32_t const size = m_componentSizes[a_component];
+  if (size < COMPONENT_HEADER_SIZE + 8) {
+    return false;
+  }
+  uint32_t const markerCount = static_cast<uint32_t>(
+      Load<int32_t>(offset + COMPONENT_HEADER_SIZE));
+  int16_t const qualityDrop = Load<int16_t>(offset + COMPONENT_HEADER_SIZE + 4);
+  int16_t const qualitySync = Load<int16_t>(offset + COMPONENT_HEADER_SIZE + 6);
+  a_quality = static_cast<float>(qualityDrop + qualitySync) / 2000.0f;
+
+  if (markerCount > (size - COMPONENT_HEADER_SIZE - 8) / GetItemSize(type)) {
+    return false;
+  }
+  uint8_t const *markers = m_bytes + offset + COMPONENT_HEADER_SIZE + 8;
+  if (m_swap) {
+    LoadMarkers<true>(type, markers, markerCount, a_markers);
+  } else {
+    LoadMarkers<false>(type, markers, markerCount, a_markers);
+  }
+  return true;
+}
+
+/**
+ * The number of rigid bodies in a 6D component, in the order of the bodies
+ * of the QTM project. Zero if the component is of another type or its
+ * bodies do not fit in it.
+ */
+uint32_t QtmPacket::GetBodyCount(uint32_t a_component) const
+{
+  int32_t const type = GetComponentType(a_component);
+  uint32_t const size = m_componentSizes[a_component];
+  if (!Is6d(type) || size < COMPONENT_HEADER_SIZE + 8) {
+    return 0;
+  }
+  uint32_t const bodyCount = static_cast<uint32_t>(
+      Load<int32_t>(m_componentOffsets[a_component] + COMPONENT_HEADER_SIZE));
+  if (bodyCount > (size - COMPONENT_HEADER_SIZE - 8) / GetItemSize(type)) {
+    return 0;
+  }
+  return bodyCount;
+}
+
+/**
+ * Reads the pose of a rigid body from a 6D component, with the position in
+ * meters and the roll, pitch and yaw in radians. The rotation matrix, which
+ * QTM gives column by column, is turned into angles in the same Z-Y-X order
+ * as the poses of the LPS. Euler angles are taken as roll, pitch and yaw, so
+ * the QTM project must use that definition. The residual is in meters, and
+ * zero for components without it. Returns false if the body was not seen.
+ */
+bool QtmPacket::ReadBody(uint32_t a_component, uint32_t a_body, 
+    opendlv::model::Cartesian3 &a_position, 
+    opendlv::model::Cartesian3 &a_angularDisplacement, 
+    float &a_residual) const
+{
+  if (a_body >= GetBodyCount(a_component)) {
+    return false;
+  }
+  int32_t const type = GetComponentType(a_component);
+  uint32_t const offset = m_componentOffsets[a_component] + 
+      COMPONENT_HEADER_SIZE + 8 + a_body * GetItemSize(type);
+  float const x = Load<float>(offset);
+  float const y = Load<float>(offset + 4);
+  float const z = Load<float>(offset + 8);
+  if (std::isnan(x) || std::isnan(y) || std::isnan(z)) {
+    return false;
+  }
+  a_position = opendlv::model::Cartesian3(x * MILLIMETER, y * MILLIMETER, 
+      z * MILLIMETER);
+
+  uint32_t residualOffset = 0;
+  if (type == COMPONENT_6D || type == COMPONENT_6D_RESIDUAL) {
+    float r[9];
+    for (uint32_t i = 0; i < 9; i++) {
+      r[i] = Load<float>(offset + 12 + 4 * i);
+    }
+    float const sinPitch = std::max(-1.0f, std::min(1.0f, -r[2]));
+    a_angularDisplacement = opendlv::model::Cartesian3(std::atan2(r[5], r[8]), 
+        std::asin(sinPitch), std::atan2(r[1], r[0]));
+    residualOffset = offset + 48;
+  } else {
+    a_angularDisplacement = opendlv::model::Cartesian3(
+        Load<float>(offset + 12) * DEGREE, Load<float>(offset + 16) * DEGREE, 
+        Load<float>(offset + 20) * DEGREE);
+    residualOffset = offset + 24;
+  }
+  bool const hasResidual = (type == COMPONENT_6D_RESIDUAL || 
+      type == COMPONENT_6D_EULER_RESIDUAL);
+  a_residual = hasResidual ? Load<float>(residualOffset) * MILLIMETER : 0.0f;
+  return true;
+}
+
+bool QtmPacket::Is3d(int32_t a_type)
+{
+  return a_type == COMPONENT_3D || a_type == COMPONENT_3D_NO_LABELS || 
+      a_type == COMPONENT_3D_RESIDUAL || 
+      a_type == COMPONENT_3D_NO_LABELS_RESIDUAL;
+}
+
+bool QtmPacket::IsLabelled(int32_t a_type)
+{
+  return a_type == COMPONENT_3D || a_type == COMPONENT_3D_RESIDUAL;
+}
+
+bool QtmPacket::Is6d(int32_t a_type)
+{
+  return a_type == COMPONENT_6D || a_type == COMPONENT_6D_EULER || 
+      a_type == COMPONENT_6D_RESIDUAL || a_type == COMPONENT_6D_EULER_RESIDUAL;
+}
+
+/**
+ * The size in bytes of one marker or body of a component type. A marker
+ * is three coordinates, with an id without labels and then a residual. A
+ * body is a position and a rotation matrix or three Euler angles, and then
+ * a residual.
+ */
+uint32_t QtmPacket::GetItemSize(int32_t a_type)
+{
+  uint32_t const residualSize = (a_type == COMPONENT_3D_RESIDUAL || 
+      a_type == COMPONENT_3D_NO_LABELS_RESIDUAL || 
+      a_type == COMPONENT_6D_RESIDUAL || 
+      a_type == COMPONENT_6D_EULER_RESIDUAL) ? 4 : 0;
+  if (Is3d(a_type)) {
+    return (IsLabelled(a_type) ? 12 : 16) + residualSize;
+  }
+  if (a_type == COMPONENT_6D || a_type == COMPONENT_6D_RESIDUAL) {
+    return 48 + residualSize;
+  }
+  return 24 + residualSize;
+}
+
+/**
+ * Loads a value of the packet byte order from possibly unaligned bytes.
+ */
+template <typename T, bool SWAP>
+T QtmPacket::Load(uint8_t const *a_bytes)
+{
+  T value;
+  if (!SWAP) {
+    std::memcpy(&value, a_bytes, sizeof(T));
+    return value;
+  }
+  uint8_t bytes[sizeof(T)];
+  for (uint32_t i = 0; i < sizeof(T); i++) {
+    bytes[i] = a_bytes[sizeof(T) - 1 - i];
+  }
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+/**
+ * Loads a value at an offset that Parse has checked.
+ */
+template <typename T>
+T QtmPacket::Load(uint32_t a_offset) const
+{
+  return m_swap ? Load<T, true>(m_bytes + a_offset) : 
+      Load<T, false>(m_bytes + a_offset);
+}
+
+/**
+ * Converts the markers from millimeters four at a time with SIMD, reading
+ * the array in place, and returns the number converted. Only markers of 12
+ * and 16 bytes are converted this way. On SSE the
+ * coordinates are gathered by shuffles, and on NEON by the interleaved
+ * loads. The id field of unlabelled markers is loaded but not used.
+ */
+template <uint32_t STRIDE>
+uint32_t QtmPacket::ConvertMarkers(uint8_t const *a_bytes, uint32_t a_count, 
+    float *a_x, float *a_y, float *a_z)
+{
+  uint32_t j = 0;
+  if (STRIDE != 12 && STRIDE != 16) {
+    return j;
+  }
+#if defined(__SSE__)
+  __m128 const scale = _mm_set1_ps(MILLIMETER);
+  for (; j + 4 <= a_count; j += 4) {
+    float const *words = static_cast<float const *>(
+        static_cast<void const *>(a_bytes + j * STRIDE));
+    __m128 x;
+    __m128 y;
+    __m128 z;
+    if (STRIDE == 12) {
+      __m128 const a = _mm_loadu_ps(words);
+      __m128 const b = _mm_loadu_ps(words + 4);
+      __m128 const c = _mm_loadu_ps(words + 8);
+      x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), 
+          _MM_SHUFFLE(2, 0, 3, 0));
+      y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), 
+          _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), 
+          _MM_SHUFFLE(2, 0, 2, 0));
+      z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), 
+          _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), 
+          _MM_SHUFFLE(2, 0, 2, 0));
+    } else {
+      x = _mm_loadu_ps(words);
+      y = _mm_loadu_ps(words + 4);
+      z = _mm_loadu_ps(words + 8);
+      __m128 ids = _mm_loadu_ps(words + 12);
+      _MM_TRANSPOSE4_PS(x, y, z, ids);
+    }
+    _mm_storeu_ps(a_x + j, _mm_mul_ps(x, scale));
+    _mm_storeu_ps(a_y + j, _mm_mul_ps(y, scale));
+    _mm_storeu_ps(a_z + j, _mm_mul_ps(z, scale));
+  }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  for (; j + 4 <= a_count; j += 4) {
+    float const *words = static_cast<float const *>(
+        static_cast<void const *>(a_bytes + j * STRIDE));
+    float32x4_t x;
+    float32x4_t y;
+    float32x4_t z;
+    if (STRIDE == 12) {
+      float32x4x3_t const markers = vld3q_f32(words);
+      x = markers.val[0];
+      y = markers.val[1];
+      z = markers.val[2];
+    } else {
+      float32x4x4_t const markers = vld4q_f32(words);
+      x = markers.val[0];
+      y = markers.val[1];
+      z = markers.val[2];
+    }
+    vst1q_f32(a_x + j, vmulq_n_f32(x, MILLIMETER));
+    vst1q_f32(a_y + j, vmulq_n_f32(y, MILLIMETER));
+    vst1q_f32(a_z + j, vmulq_n_f32(z, MILLIMETER));
+  }
+#else
+  (void) a_bytes;
+  (void) a_count;
+  (void) a_x;
+  (void) a_y;
+  (void) a_z;
+#endif
+  return j;
+}
+
+/**
+ * Converts all markers from millimeters and then drops the unseen markers
+ * in place. Packets in the byte order of the host are converted with SIMD,
+ * the rest one marker at a time.
+ */
+template <bool SWAP, uint32_t STRIDE, bool LABELLED>
+void QtmPacket::LoadMarkers(uint8_t const *a_bytes, uint32_t a_count, 
+    MarkerBuffer &a_markers)
+{
+  a_markers.Resize(a_count);
+  float *x = a_markers.GetX();
+  float *y = a_markers.GetY();
+  float *z = a_markers.GetZ();
+  int32_t *ids = a_markers.GetIds();
+
+  uint32_t j = SWAP ? 0 : ConvertMarkers<STRIDE>(a_bytes, a_count, x, y, z);
+  for (; j < a_count; j++) {
+    uint8_t const *marker = a_bytes + j * STRIDE;
+    x[j] = Load<float, SWAP>(marker) * MILLIMETER;
+    y[j] = Load<float, SWAP>(marker + 4) * MILLIMETER;
+    z[j] = Load<float, SWAP>(marker + 8) * MILLIMETER;
+  }
+  for (j = 0; j < a_count; j++) {
+    ids[j] = LABELLED ? static_cast<int32_t>(j) : -1;
+  }
+
+  uint32_t seenCount = 0;
+  for (j = 0; j < a_count; j++) {
+    if (std::isnan(x[j]) || std::isnan(y[j]) || std::isnan(z[j])) {
+      continue;
+    }
+    x[seenCount] = x[j];
+    y[seenCount] = y[j];
+    z[seenCount] = z[j];
+    ids[seenCount] = ids[j];
+    seenCount++;
+  }
+  a_markers.Resize(seenCount);
+}
+
+/**
+ * Loads the markers of a 3D component type.
+ */
+template <bool SWAP>
+void QtmPacket::LoadMarkers(int32_t a_type, uint8_t const *a_bytes, 
+    uint32_t a_count, MarkerBuffer &a_markers)
+{
+  if (a_type == COMPONENT_3D) {
+    LoadMarkers<SWAP, 12, true>(a_bytes, a_count, a_markers);
+  } else if (a_type == COMPONENT_3D_NO_LABELS) {
+    LoadMarkers<SWAP, 16, false>(a_bytes, a_count, a_markers);
+  } else if (a_type == COMPONENT_3D_RESIDUAL) {
+    LoadMarkers<SWAP, 16, true>(a_bytes, a_count, a_markers);
+  } else {
+    LoadMarkers<SWAP, 20, false>(a_bytes, a_count, a_markers);
+  }
+}
+
+}
+}
+}
@@ -0,0 +1,266 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "QtmRecorder.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+// Index entries are written 256 at a time, 6 kB per write.
+uint32_t const QtmRecorder::INDEX_BLOCK_SIZE = 256;
+
+/**
+ * Creates the index, replacing any earlier log with the same prefix, and
+ * the first segment. The segments are at least large enough for the
+ * largest packet. Throws std::runtime_error on errors.
+ */
+QtmRecorder::QtmRecorder(std::string const &a_prefix, uint32_t a_segmentSize, 
+    DatagramListener *a_listener)
+    : PacketListener()
+    , DatagramListener()
+    , m_prefix(a_prefix)
+    , m_segmentSize(std::max(a_segmentSize, 
+        static_cast<uint32_t>(sizeof(QtmLog::fileHeader) 
+          + sizeof(QtmLog::recordHeader)) 
+        + BatchUdpReceiver::MAX_DATAGRAM_SIZE))
+    , m_listener(a_listener)
+    , m_indexFile(-1)
+    , m_indexBlock()
+    , m_segmentFile(-1)
+    , m_segment(nullptr)
+    , m_segmentCount(0)
+    , m_segmentUsed(0)
+    , m_recordedCount(0)
+    , m_recordedBytes(0)
+{
+  std::string const indexFilename = QtmLog::GetIndexFilename(m_prefix);
+  m_indexFile = open(indexFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 
+      0644);
+  if (m_indexFile < 0) {
+    throw std::runtime_error(std::string("Could not create ") 
+        + indexFilename + ": " + std::strerror(errno));
+  }
+  QtmLog::fileHeader header;
+  std::memcpy(header.magic, QtmLog::INDEX_MAGIC, sizeof(header.magic));
+  header.version = QtmLog::VERSION;
+  header.segment = 0;
+  header.reserved = 0;
+  if (write(m_indexFile, &header, sizeof(header)) 
+      != static_cast<ssize_t>(sizeof(header))) {
+    std::string const error = std::strerror(errno);
+    close(m_indexFile);
+    throw std::runtime_error(std::string("Could not write ") + indexFilename 
+        + ": " + error);
+  }
+  m_indexBlock.reserve(INDEX_BLOCK_SIZE);
+  try {
+    OpenSegment();
+  } catch (std::exception const &) {
+    close(m_indexFile);
+    throw;
+  }
+}
+
+QtmRecorder::~QtmRecorder()
+{
+  CloseSegment();
+  WriteIndex();
+  close(m_indexFile);
+}
+
+uint32_t QtmRecorder::GetSegmentSize() const
+{
+  return m_segmentSize;
+}
+
+uint32_t QtmRecorder::GetSegmentCount() const
+{
+  return m_segmentCount;
+}
+
+uint64_t QtmRecorder::GetRecordedCount() const
+{
+  return m_recordedCount;
+}
+
+uint64_t QtmRecorder::GetRecordedBytes() const
+{
+  return m_recordedBytes;
+}
+
+/**
+ * Records a packet from the OpenDaVINCI receiver, stamped with the time now.
+ */
+void QtmRecorder::nextPacket(odcore::data::Packet const &a_packet)
+{
+  odcore::data::TimeStamp now;
+  std::string const data = a_packet.getData();
+  nextDatagram(reinterpret_cast<uint8_t const *>(data.data()), 
+      static_cast<uint32_t>(data.size()), now);
+}
+
+void QtmRecorder::nextDatagram(uint8_t const *a_data, uint32_t a_size, 
+    odcore::data::TimeStamp const &a_arrival)
+{
+  Record(a_data, a_size, a_arrival.toMicroseconds());
+  if (m_listener != nullptr) {
+    m_listener->nextDatagram(a_data, a_size, a_arrival);
+  }
+}
+
+/**
+ * Copies a packet into the mapped segment, after its record header, and
+ * adds its index entry. If the segment cannot be replaced when full,
+ * recording stops and the packets are only passed on.
+ */
+void QtmRecorder::Record(uint8_t const *a_data, uint32_t a_size, 
+    int64_t a_arrival)
+{
+  if (m_segment == nullptr || a_size > BatchUdpReceiver::MAX_DATAGRAM_SIZE) {
+    return;
+  }
+  uint32_t const recordSize = static_cast<uint32_t>(
+      sizeof(QtmLog::recordHeader)) + a_size;
+  if (m_segmentUsed + recordSize > m_segmentSize) {
+    CloseSegment();
+    try {
+      OpenSegment();
+    } catch (std::exception const &exception) {
+      std::cerr << "[QtmRecorder] Stopped recording: " << exception.what() 
+          << std::endl;
+    }
+  }
+  if (m_segment == nullptr) {
+    return;
+  }
+
+  QtmLog::recordHeader header;
+  header.arrival = a_arrival;
+  header.size = a_size;
+  header.reserved = 0;
+  std::memcpy(m_segment + m_segmentUsed, &header, sizeof(header));
+  std::memcpy(m_segment + m_segmentUsed + sizeof(header), a_data, a_size);
+
+  QtmLog::indexEntry entry;
+  entry.arrival = a_arrival;
+  entry.offset = m_segmentUsed + sizeof(header);
+  entry.segment = m_segmentCount - 1;
+  entry.size = a_size;
+  m_indexBlock.push_back(entry);
+  if (m_indexBlock.size() == INDEX_BLOCK_SIZE) {
+    WriteIndex();
+  }
+
+  // The padding keeps the next record header aligned in the mapping.
+  m_segmentUsed = std::min(m_segmentSize, 
+      (m_segmentUsed + recordSize + QtmLog::ALIGNMENT - 1) 
+      & ~(QtmLog::ALIGNMENT - 1));
+  m_recordedCount++;
+  m_recordedBytes += a_size;
+}
+
+/**
+ * Creates the next segment at its full size and maps it. The blocks are
+ * allocated by posix_fallocate where the file system supports it, so that
+ * writing to the mapping never faults on a full disk later.
+ */
+void QtmRecorder::OpenSegment()
+{
+  std::string const filename = 
+      QtmLog::GetSegmentFilename(m_prefix, m_segmentCount);
+  m_segmentFile = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_segmentFile < 0) {
+    throw std::runtime_error(std::string("Could not create ") + filename 
+        + ": " + std::strerror(errno));
+  }
+  if (posix_fallocate(m_segmentFile, 0, m_segmentSize) != 0 
+      && ftruncate(m_segmentFile, m_segmentSize) != 0) {
+    std::string const error = std::strerror(errno);
+    close(m_segmentFile);
+    m_segmentFile = -1;
+    throw std::runtime_error(std::string("Could not allocate ") + filename 
+        + ": " + error);
+  }
+  void *memory = mmap(nullptr, m_segmentSize, PROT_READ | PROT_WRITE, 
+      MAP_SHARED, m_segmentFile, 0);
+  if (memory == MAP_FAILED) {
+    std::string const error = std::strerror(errno);
+    close(m_segmentFile);
+    m_segmentFile = -1;
+    throw std::runtime_error(std::string("Could not map ") + filename 
+        + ": " + error);
+  }
+  m_segment = static_cast<uint8_t *>(memory);
+
+  QtmLog::fileHeader header;
+  std::memcpy(header.magic, QtmLog::SEGMENT_MAGIC, sizeof(header.magic));
+  header.version = QtmLog::VERSION;
+  header.segment = m_segmentCount;
+  header.reserved = 0;
+  std::memcpy(m_segment, &header, sizeof(header));
+  m_segmentUsed = sizeof(header);
+  m_segmentCount++;
+}
+
+/**
+ * Unmaps the segment, which leaves writing it back to the kernel, and cuts
+ * the file to the records in it.
+ */
+void QtmRecorder::CloseSegment()
+{
+  if (m_segment == nullptr) {
+    return;
+  }
+  munmap(m_segment, m_segmentSize);
+  m_segment = nullptr;
+  if (ftruncate(m_segmentFile, m_segmentUsed) != 0) {
+    std::cerr << "[QtmRecorder] Could not cut segment: " 
+        << std::strerror(errno) << std::endl;
+  }
+  close(m_segmentFile);
+  m_segmentFile = -1;
+}
+
+void QtmRecorder::WriteIndex()
+{
+  if (m_indexBlock.empty()) {
+    return;
+  }
+  size_t const size = m_indexBlock.size() * sizeof(QtmLog::indexEntry);
+  if (write(m_indexFile, m_indexBlock.data(), size) 
+      != static_cast<ssize_t>(size)) {
+    std::cerr << "[QtmRecorder] Could not write index: " 
+        << std::strerror(errno) << std::endl;
+  }
+  m_indexBlock.clear();
+}
+
+}
+}
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "QtmReplayer.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Maps the log with the given prefix. Throws std::runtime_error on errors.
+ */
+QtmReplayer::QtmReplayer(std::string const &a_prefix, bool a_isRealTime, 
+    DatagramListener &a_listener)
+    : Service()
+    , m_log(a_prefix)
+    , m_isRealTime(a_isRealTime)
+    , m_listener(a_listener)
+    , m_replayedCount(0)
+    , m_duration(0)
+    , m_isDone(false)
+{
+}
+
+QtmReplayer::~QtmReplayer()
+{
+}
+
+uint32_t QtmReplayer::GetCount() const
+{
+  return m_log.GetCount();
+}
+
+uint32_t QtmReplayer::GetReplayedCount() const
+{
+  return m_replayedCount.load();
+}
+
+/**
+ * Returns the time in seconds taken by the replay so far.
+ */
+double QtmReplayer::GetDuration() const
+{
+  return static_cast<double>(m_duration.load()) / 1e6;
+}
+
+bool QtmReplayer::IsDone() const
+{
+  return m_isDone.load();
+}
+
+void QtmReplayer::beforeStop()
+{
+}
+
+/**
+ * Gives every packet of the log to the listener, in the order recorded. In
+ * real time each packet waits for its time relative to the first packet,
+ * so a slow listener delays the packets but does not change their pace.
+ */
+void QtmReplayer::run()
+{
+  serviceReady();
+  std::chrono::steady_clock::time_point const start = 
+      std::chrono::steady_clock::now();
+  uint32_t const count = m_log.GetCount();
+  for (uint32_t i = 0; i < count && isRunning(); i++) {
+    int64_t const arrival = m_log.GetArrival(i);
+    if (m_isRealTime && !WaitUntil(start 
+        + std::chrono::microseconds(arrival - m_log.GetArrival(0)))) {
+      break;
+    }
+    odcore::data::TimeStamp const timeStamp(
+        static_cast<int32_t>(arrival / 1000000), 
+        static_cast<int32_t>(arrival % 1000000));
+    m_listener.nextDatagram(m_log.GetData(i), m_log.GetSize(i), timeStamp);
+    m_replayedCount++;
+    m_duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+  }
+  m_isDone = true;
+}
+
+/**
+ * Sleeps until the given time, waking every 100 ms to notice if the service
+ * is stopped. Returns false if it was.
+ */
+bool QtmReplayer::WaitUntil(
+    std::chrono::steady_clock::time_point const &a_time)
+{
+  while (isRunning()) {
+    std::chrono::steady_clock::time_point const now = 
+        std::chrono::steady_clock::now();
+    if (now >= a_time) {
+      return true;
+    }
+    std::this_thread::sleep_until(
+        std::min(a_time, now + std::chrono::milliseconds(100)));
+  }
+  return false;
+}
+
+}
+}
+}
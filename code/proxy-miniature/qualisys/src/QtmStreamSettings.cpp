@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "QtmStreamSettings.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+// The components of the QTM RT protocol.
+std::vector<std::string> const QtmStreamSettings::COMPONENTS = {"2D", 
+    "2DLin", "3D", "3DRes", "3DNoLabels", "3DNoLabelsRes", "Analog", 
+    "AnalogSingle", "Force", "ForceSingle", "6D", "6DRes", "6DEuler", 
+    "6DEulerRes", "Image", "GazeVector", "Timecode", "Skeleton"};
+
+/**
+ * Sets the rate as a frequency in Hz, a divisor of the camera frequency, or
+ * all frames, where a divisor of 0 is not used. The components are given
+ * separated by spaces, as in the StreamFrames command.
+ */
+QtmStreamSettings::QtmStreamSettings(uint32_t a_frequency, 
+    uint32_t a_frequencyDivisor, bool a_allFrames, uint32_t a_port, 
+    std::string const &a_components)
+    : m_frequency(a_frequency)
+    , m_frequencyDivisor(a_frequencyDivisor)
+    , m_allFrames(a_allFrames)
+    , m_port(a_port)
+    , m_components()
+{
+  std::istringstream stream(a_components);
+  std::string component;
+  while (stream >> component) {
+    m_components.push_back(component);
+  }
+}
+
+QtmStreamSettings::~QtmStreamSettings()
+{
+}
+
+std::string QtmStreamSettings::GetCommand() const
+{
+  std::string command = "StreamFrames ";
+  if (m_allFrames) {
+    command += "AllFrames";
+  } else if (m_frequencyDivisor > 0) {
+    command += "FrequencyDivisor:" + std::to_string(m_frequencyDivisor);
+  } else {
+    command += "Frequency:" + std::to_string(m_frequency);
+  }
+  command += " UDP:" + std::to_string(m_port);
+  for (auto const &component : m_components) {
+    command += " " + component;
+  }
+  return command;
+}
+
+/**
+ * Returns the components not in the QTM RT protocol, which QTM will refuse.
+ */
+std::vector<std::string> QtmStreamSettings::GetUnknownComponents() const
+{
+  std::vector<std::string> unknown;
+  for (auto const &component : m_components) {
+    if (std::find(COMPONENTS.begin(), COMPONENTS.end(), component) 
+        == COMPONENTS.end()) {
+      unknown.push_back(component);
+    }
+  }
+  return unknown;
+}
+
+/**
+ * Returns the rate in Hz the frames are streamed with, for the given
+ * frequency of the cameras. QTM never streams faster than the cameras.
+ */
+float QtmStreamSettings::GetRate(float a_cameraFrequency) const
+{
+  if (m_allFrames) {
+    return a_cameraFrequency;
+  }
+  if (m_frequencyDivisor > 0) {
+    return a_cameraFrequency / static_cast<float>(m_frequencyDivisor);
+  }
+  return std::min(static_cast<float>(m_frequency), a_cameraFrequency);
+}
+
+}
+}
+}
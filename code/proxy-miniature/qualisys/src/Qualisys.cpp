@@ -17,14 +17,17 @@
  */
 
 #include <iostream>
+#include <stdexcept>
 
 #include <opendavinci/odcore/base/KeyValueConfiguration.h>
 #include <opendavinci/odcore/data/Container.h>
 #include <opendavinci/odcore/io/tcp/TCPFactory.h>
 #include <opendavinci/odcore/io/udp/UDPFactory.h>
+#include <opendavinci/odcore/strings/StringToolbox.h>
 
 #include "Qualisys.h"
 #include "Buffer.h"
+#include "QtmStreamSettings.h"
 
 namespace opendlv {
 namespace proxy {
@@ -35,8 +38,14 @@ Qualisys::Qualisys(const int &argc, char **argv)
           argc, argv, "proxy-miniature-qualisys")
     , m_qualisysTCP()
     , m_qualisysUDP()
+    , m_batchReceiver()
     , m_qualisysStringDecoder()
+    , m_localizer()
     , m_qualisysPacketListener()
+    , m_framePublisher()
+    , m_streamMonitor()
+    , m_recorder()
+    , m_replayer()
 {
 }
 
@@ -57,12 +66,162 @@ void Qualisys::setUp()
       kv.getValue<std::string>("proxy-miniature-qualisys.client-ip");
   uint32_t const CLIENT_PORT = 
       kv.getValue<uint32_t>("proxy-miniature-qualisys.client-port");
+  bool hasLabelled = false;
+  int32_t const LABELLED = kv.getOptionalValue<int32_t>(
+      "proxy-miniature-qualisys.labelled", hasLabelled);
+  bool hasRigidBodies = false;
+  std::string const RIGID_BODIES = kv.getOptionalValue<std::string>(
+      "proxy-miniature-qualisys.rigidBodies", hasRigidBodies);
+  bool hasBatchSize = false;
+  uint32_t const BATCH_SIZE = kv.getOptionalValue<uint32_t>(
+      "proxy-miniature-qualisys.batchSize", hasBatchSize);
+  bool hasReceiveBufferSize = false;
+  int32_t const RECEIVE_BUFFER_SIZE = kv.getOptionalValue<int32_t>(
+      "proxy-miniature-qualisys.receiveBufferSize", hasReceiveBufferSize);
+  bool hasLatestFrameOnly = false;
+  int32_t const LATEST_FRAME_ONLY = kv.getOptionalValue<int32_t>(
+      "proxy-miniature-qualisys.latestFrameOnly", hasLatestFrameOnly);
+  bool hasFrequency = false;
+  uint32_t const FREQUENCY = kv.getOptionalValue<uint32_t>(
+      "proxy-miniature-qualisys.frequency", hasFrequency);
+  bool hasFrequencyDivisor = false;
+  uint32_t const FREQUENCY_DIVISOR = kv.getOptionalValue<uint32_t>(
+      "proxy-miniature-qualisys.frequencyDivisor", hasFrequencyDivisor);
+  bool hasAllFrames = false;
+  int32_t const ALL_FRAMES = kv.getOptionalValue<int32_t>(
+      "proxy-miniature-qualisys.allFrames", hasAllFrames);
+  bool hasComponents = false;
+  std::string const COMPONENTS = kv.getOptionalValue<std::string>(
+      "proxy-miniature-qualisys.components", hasComponents);
+  bool hasFusion = false;
+  int32_t const FUSION = kv.getOptionalValue<int32_t>(
+      "proxy-miniature-qualisys.fusion", hasFusion);
+  bool hasRecord = false;
+  std::string const RECORD = kv.getOptionalValue<std::string>(
+      "proxy-miniature-qualisys.record", hasRecord);
+  bool hasRecordSegmentSize = false;
+  uint32_t const RECORD_SEGMENT_SIZE = kv.getOptionalValue<uint32_t>(
+      "proxy-miniature-qualisys.recordSegmentSize", hasRecordSegmentSize);
+  bool hasReplay = false;
+  std::string const REPLAY = kv.getOptionalValue<std::string>(
+      "proxy-miniature-qualisys.replay", hasReplay);
+  bool hasReplayRealTime = false;
+  int32_t const REPLAY_REAL_TIME = kv.getOptionalValue<int32_t>(
+      "proxy-miniature-qualisys.replayRealTime", hasReplayRealTime);
+  bool hasStatisticsPeriod = false;
+  double const STATISTICS_PERIOD = kv.getOptionalValue<double>(
+      "proxy-miniature-qualisys.statisticsPeriod", hasStatisticsPeriod);
+
+  // Labelled 3D gives the markers in the order of the labels of the QTM
+  // project, which the LPS can map to the body markers without searching.
+  // The rigid bodies of the QTM project are solved by QTM and streamed as
+  // one of the 6D components, such as 6D or 6DRes. Components given
+  // explicitly replace both.
+  std::string components = 
+      (hasLabelled && LABELLED == 1) ? "3D" : "3DNoLabels";
+  if (hasRigidBodies) {
+    components += " " + RIGID_BODIES;
+  }
+  if (hasComponents) {
+    components = COMPONENTS;
+  }
+  QtmStreamSettings const stream(hasFrequency ? FREQUENCY : 60, 
+      hasFrequencyDivisor ? FREQUENCY_DIVISOR : 0, 
+      hasAllFrames && ALL_FRAMES == 1, CLIENT_PORT, components);
+  for (auto const &component : stream.GetUnknownComponents()) {
+    std::cerr << "[" << getName() << "] Unknown QTM component: " << component 
+        << std::endl;
+  }
+
+  // In fusion mode the LPS runs here on the decoded markers, configured by
+  // the proxy-miniature-qualisys.lps keys, and the frames are not sent.
+  if (hasFusion && FUSION == 1) {
+    m_localizer = std::unique_ptr<Localizer>(new Localizer());
+    m_localizer->SetUp(kv, getName() + ".lps");
+  }
 
   m_qualisysStringDecoder = 
       std::unique_ptr<QualisysStringDecoder>(new QualisysStringDecoder());
   m_qualisysPacketListener = 
       std::unique_ptr<QualisysPacketDecoder>(new QualisysPacketDecoder(
-          getConference(), DEBUG));
+          getConference(), DEBUG, m_localizer.get()));
+  if (hasRigidBodies) {
+    bool hasBodyFrameIds = false;
+    std::string const bodyFrameIdsString = kv.getOptionalValue<std::string>(
+        "proxy-miniature-qualisys.bodyFrameIds", hasBodyFrameIds);
+    std::vector<int16_t> bodyFrameIds;
+    if (hasBodyFrameIds) {
+      for (auto const &frameId : 
+          odcore::strings::StringToolbox::split(bodyFrameIdsString, ',')) {
+        bodyFrameIds.push_back(static_cast<int16_t>(std::stoi(frameId)));
+      }
+    }
+    m_qualisysPacketListener->SetBodyFrameIds(bodyFrameIds);
+  }
+
+  // Unless turned off, the packets are decoded and sent on a thread of their
+  // own, which always takes the latest packet received. A slow send then
+  // skips frames instead of delaying all the frames after it.
+  DatagramListener *datagramListener = m_qualisysPacketListener.get();
+  odcore::io::PacketListener *packetListener = 
+      m_qualisysPacketListener.get();
+  if (!hasLatestFrameOnly || LATEST_FRAME_ONLY == 1) {
+    m_framePublisher = std::unique_ptr<FramePublisher>(
+        new FramePublisher(*m_qualisysPacketListener));
+    m_framePublisher->start();
+    datagramListener = m_framePublisher.get();
+    packetListener = m_framePublisher.get();
+  }
+
+  // The stream is measured as it is received, before the publisher skips
+  // any packets, so that frames lost by QTM and frames skipped here are
+  // told apart.
+  double const statisticsPeriod = 
+      hasStatisticsPeriod ? STATISTICS_PERIOD : 1.0;
+  if (statisticsPeriod > 0.0) {
+    m_streamMonitor = std::unique_ptr<StreamMonitor>(new StreamMonitor(
+        getConference(), DEBUG, statisticsPeriod, *datagramListener, 
+        m_framePublisher.get()));
+    m_qualisysPacketListener->SetStatistics(
+        &m_streamMonitor->GetStatistics());
+    datagramListener = m_streamMonitor.get();
+    packetListener = m_streamMonitor.get();
+  }
+
+  // A replay takes the place of QTM, and gives the recorded packets to the
+  // same listeners as the receiver would.
+  if (hasReplay && !REPLAY.empty()) {
+    try {
+      m_replayer = std::unique_ptr<QtmReplayer>(new QtmReplayer(REPLAY, 
+          !hasReplayRealTime || REPLAY_REAL_TIME == 1, *datagramListener));
+      m_replayer->start();
+      std::cout << "[" << getName() << "] Replaying " 
+          << m_replayer->GetCount() << " packets from " << REPLAY << "." 
+          << std::endl;
+    } catch (std::exception const &exception) {
+      std::cerr << "[" << getName() << "] Could not replay: " 
+          << exception.what() << std::endl;
+    }
+    return;
+  }
+
+  // The raw packets are recorded before they are decoded, with the same
+  // arrival time as the decoder gets.
+  if (hasRecord && !RECORD.empty()) {
+    try {
+      m_recorder = std::unique_ptr<QtmRecorder>(new QtmRecorder(RECORD, 
+          hasRecordSegmentSize ? RECORD_SEGMENT_SIZE : 64 * 1024 * 1024, 
+          datagramListener));
+      datagramListener = m_recorder.get();
+      packetListener = m_recorder.get();
+      std::cout << "[" << getName() << "] Recording to " << RECORD 
+          << " in segments of " << m_recorder->GetSegmentSize() << " bytes." 
+          << std::endl;
+    } catch (std::exception const &exception) {
+      std::cerr << "[" << getName() << "] Could not record: " 
+          << exception.what() << std::endl;
+    }
+  }
 
   try {
     m_qualisysTCP = 
@@ -76,26 +235,72 @@ void Qualisys::setUp()
     std::cerr << "[" << getName() << "] Could not TCP connect to Qualisys: " 
         << exception << std::endl;
   }
+  // With a batch size the packets are received by recvmmsg, a batch per
+  // call, and stamped with the time they arrived at the kernel.
   try {
-    m_qualisysUDP = std::shared_ptr<odcore::io::udp::UDPReceiver>(
-        odcore::io::udp::UDPFactory::createUDPReceiver(
-            CLIENT_IP, CLIENT_PORT));
-    m_qualisysUDP->setPacketListener(m_qualisysPacketListener.get());
-    m_qualisysUDP->start();
+    if (hasBatchSize && BATCH_SIZE > 0) {
+      m_batchReceiver = std::unique_ptr<BatchUdpReceiver>(
+          new BatchUdpReceiver(CLIENT_IP, CLIENT_PORT, BATCH_SIZE, 
+              hasReceiveBufferSize ? RECEIVE_BUFFER_SIZE : 0));
+      m_batchReceiver->SetDatagramListener(datagramListener);
+      m_batchReceiver->start();
+      std::cout << "[" << getName() << "] Receiving batches of up to " 
+          << m_batchReceiver->GetBatchSize() << " packets, receive buffer " 
+          << m_batchReceiver->GetReceiveBufferSize() << " bytes." << std::endl;
+    } else {
+      m_qualisysUDP = std::shared_ptr<odcore::io::udp::UDPReceiver>(
+          odcore::io::udp::UDPFactory::createUDPReceiver(
+              CLIENT_IP, CLIENT_PORT));
+      m_qualisysUDP->setPacketListener(packetListener);
+      m_qualisysUDP->start();
+    }
   } catch (std::string &exception) {
     std::cerr << "[" << getName() << "] Could not open UDP socket: " 
         << exception << std::endl;
+  } catch (std::exception const &exception) {
+    std::cerr << "[" << getName() << "] Could not open UDP socket: " 
+        << exception.what() << std::endl;
   }
 
-
-  uint8_t freq = 60;
-
   TcpSendMsg("Version 1.12");
   TcpSendMsg("ByteOrder");
+
+  // The packets are read in the byte order of the port connected to, which
+  // has to be known before QTM starts streaming.
+  if (m_qualisysStringDecoder->WaitForByteOrder(2000)) {
+    bool const isBigEndian = 
+        (m_qualisysStringDecoder->GetByteOrder() == "big");
+    m_qualisysPacketListener->SetBigEndian(isBigEndian);
+    if (m_streamMonitor.get() != NULL) {
+      m_streamMonitor->SetBigEndian(isBigEndian);
+    }
+  } else {
+    std::cerr << "[" << getName() << "] QTM did not reply with its byte " 
+        << "order, assuming little endian." << std::endl;
+  }
+
   TcpSendMsg("GetState");
-  TcpSendMsg("StreamFrames Frequency:" + std::to_string(freq) + " UDP:" 
-      + std::to_string(CLIENT_PORT) + " 3DNoLabels");
+  TcpSendMsg(stream.GetCommand());
+  TcpSendMsg("GetParameters General");
 
+  // QTM only replies to StreamFrames if it refuses it, and replies to the
+  // commands in order, so no error before the parameters means it streams.
+  if (m_qualisysStringDecoder->WaitForCameraFrequency(2000)) {
+    float const cameraFrequency = 
+        m_qualisysStringDecoder->GetCameraFrequency();
+    std::cout << "[" << getName() << "] QTM RT protocol " 
+        << m_qualisysStringDecoder->GetVersion() << ", " 
+        << m_qualisysStringDecoder->GetByteOrder() << " endian, cameras at " 
+        << cameraFrequency << " Hz, streaming at " 
+        << stream.GetRate(cameraFrequency) << " Hz." << std::endl;
+  } else {
+    std::cerr << "[" << getName() << "] QTM did not reply with its parameters." 
+        << std::endl;
+  }
+  for (auto const &error : m_qualisysStringDecoder->GetErrors()) {
+    std::cerr << "[" << getName() << "] QTM refused a command: " << error 
+        << std::endl;
+  }
 }
 
 void Qualisys::tearDown() 
@@ -109,6 +314,42 @@ void Qualisys::tearDown()
     m_qualisysUDP->stop();
     m_qualisysUDP->setPacketListener(NULL);
   }
+  if (m_batchReceiver.get() != NULL) {
+    m_batchReceiver->stop();
+    std::cout << "[" << getName() << "] Received " 
+        << m_batchReceiver->GetDatagramCount() << " packets in " 
+        << m_batchReceiver->GetBatchCount() << " batches, at most " 
+        << m_batchReceiver->GetLargestBatch() << " per batch, " 
+        << m_batchReceiver->GetTruncatedCount() << " truncated." << std::endl;
+  }
+  if (m_replayer.get() != NULL) {
+    m_replayer->stop();
+    double const duration = m_replayer->GetDuration();
+    std::cout << "[" << getName() << "] Replayed " 
+        << m_replayer->GetReplayedCount() << " of " 
+        << m_replayer->GetCount() << " packets in " << duration 
+        << " s, " << ((duration > 0.0) ? 
+            m_replayer->GetReplayedCount() / duration : 0.0) 
+        << " packets per second." << std::endl;
+  }
+  if (m_recorder.get() != NULL) {
+    std::cout << "[" << getName() << "] Recorded " 
+        << m_recorder->GetRecordedCount() << " packets, " 
+        << m_recorder->GetRecordedBytes() << " bytes in " 
+        << m_recorder->GetSegmentCount() << " segments." << std::endl;
+    m_recorder.reset();
+  }
+  if (m_framePublisher.get() != NULL) {
+    m_framePublisher->stop();
+    std::cout << "[" << getName() << "] Published " 
+        << m_framePublisher->GetPublishedCount() << " of " 
+        << m_framePublisher->GetReceivedCount() << " packets, dropped " 
+        << m_framePublisher->GetDroppedCount() << " for newer ones." 
+        << std::endl;
+  }
+  if (m_localizer.get() != NULL) {
+    m_localizer->ReportStatistics();
+  }
 }
 
 void Qualisys::nextContainer(odcore::data::Container &)
@@ -127,6 +368,9 @@ void Qualisys::TcpSendMsg(std::string const a_msg) const
   buffer.AppendStringRaw(a_msg);
   buffer.AppendByte(0);
   std::cout << "Sent: " << a_msg << std::endl;
+  if (m_qualisysTCP.get() == NULL) {
+    return;
+  }
   std::vector<unsigned char> bytes = buffer.GetData();
   std::string bytesString(bytes.begin(),bytes.end());
   m_qualisysTCP->send(bytesString);
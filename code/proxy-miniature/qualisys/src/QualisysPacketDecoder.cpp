@@ -19,9 +19,9 @@
 #include <iostream>
 
 #include <bitset>
+#include <chrono>
 #include <limits.h>
 
-#include "Buffer.h"
 #include "QualisysPacketDecoder.h"
 
 #include <opendavinci/odcore/data/Container.h>
@@ -36,113 +36,227 @@ namespace miniature {
 
 QualisysPacketDecoder::QualisysPacketDecoder(
       odcore::io::conference::ContainerConference &a_conference, 
-      bool a_debug) 
+      bool a_debug, Localizer *a_localizer) 
     : m_conference(a_conference)
     , m_debug(a_debug)
+    , m_localizer(a_localizer)
+    , m_packet()
+    , m_markers()
+    , m_bodyFrameIds()
+    , m_statistics(nullptr)
 {}
 
 QualisysPacketDecoder::~QualisysPacketDecoder() {}
 
+/**
+ * Sets the frame id to send the pose of each rigid body of the QTM project
+ * with, in the order of the project. Bodies after the last given frame id
+ * are sent with their index.
+ */
+void QualisysPacketDecoder::SetBodyFrameIds(
+    std::vector<int16_t> const &a_bodyFrameIds)
+{
+  m_bodyFrameIds = a_bodyFrameIds;
+}
+
+/**
+ * Sets the byte order of the packets, as QTM replied to ByteOrder. Set it
+ * before the stream starts, as it is not locked.
+ */
+void QualisysPacketDecoder::SetBigEndian(bool a_isBigEndian)
+{
+  m_packet.SetBigEndian(a_isBigEndian);
+}
+
+/**
+ * Sets the stream statistics to add the decode time and quality of each
+ * frame to, or none with nullptr.
+ */
+void QualisysPacketDecoder::SetStatistics(StreamStatistics *a_statistics)
+{
+  m_statistics = a_statistics;
+}
+
 void QualisysPacketDecoder::nextPacket(odcore::data::Packet const &a_packet)
 {
-  std::string const dataString = a_packet.getData();
-  Buffer buffer;
-  buffer.AppendStringRaw(dataString);
+  // The packet gives its data by value, which is the only copy made. The
+  // fields and markers are read in place from it. The OpenDaVINCI receiver
+  // gives no arrival time, so the frame is stamped with the time now.
+  odcore::data::TimeStamp now;
+  std::string const data = a_packet.getData();
+  nextDatagram(reinterpret_cast<uint8_t const *>(data.data()), 
+      static_cast<uint32_t>(data.size()), now);
+}
+
+/**
+ * Decodes a packet and adds the time it took, including the time to send,
+ * and its quality to the stream statistics.
+ */
+void QualisysPacketDecoder::nextDatagram(uint8_t const *a_data, 
+    uint32_t a_size, odcore::data::TimeStamp const &a_arrival)
+{
+  std::chrono::steady_clock::time_point const start = 
+      std::chrono::steady_clock::now();
+  float quality = 0.0f;
+  bool const isDecoded = Decode(a_data, a_size, a_arrival, quality);
+  if (isDecoded && m_statistics != nullptr) {
+    float const decodeTime = std::chrono::duration<float>(
+        std::chrono::steady_clock::now() - start).count();
+    m_statistics->AddDecoded(decodeTime, quality);
+  }
+}
+
+/**
+ * Decodes a packet, read in place, that arrived at the given time. The frame
+ * is stamped with the arrival time, which with the BatchUdpReceiver is the
+ * time the kernel received it. Returns false if the packet is not a well
+ * formed data packet, and gives the quality of the markers otherwise.
+ */
+bool QualisysPacketDecoder::Decode(uint8_t const *a_data, uint32_t a_size, 
+    odcore::data::TimeStamp const &a_arrival, float &a_quality)
+{
   if (m_debug) {
-    auto data = buffer.GetData();
     std::cout << "Raw: " << std::endl;
-    for(std::size_t i = 0; i < data.size(); i++) {
-      std::cout << std::bitset<CHAR_BIT>(data[i]) << " ";
+    for(std::size_t i = 0; i < a_size; i++) {
+      std::cout << std::bitset<CHAR_BIT>(a_data[i]) << " ";
     }
     std::cout << std::endl;
   }
 
-  std::shared_ptr<Buffer::Iterator> it = buffer.GetIterator();
-
-  int32_t const packetLength = it->ReadInteger32();
-  int32_t const packetType = it->ReadInteger32();
+  if (!m_packet.Parse(a_data, a_size)) {
+    std::cout 
+        << "Unexpected answer from QTM RT server: Malformed packet of " 
+        << a_size << " bytes." 
+        << std::endl;
+    return false;
+  }
 
+  int32_t const packetType = m_packet.GetType();
   if (m_debug) {
     std::cout 
-        << "Received packet with length: " << packetLength 
+        << "Received packet with length: " << m_packet.GetSize() 
         << " of type: " << packetType << std::endl;
   }
 
-  if (packetType != 3) {
+  if (packetType != QtmPacket::TYPE_DATA) {
     std::cout 
         << "Unexpected answer from QTM RT server: Unrecognized packet type."
         << std::endl;
-    return;
+    return false;
   }
 
-  double const sensorTimestampMicroseconds = 
-      ((int64_t) it->ReadInteger64() / 1e6);
-  int32_t const frameNumber = it->ReadInteger32();
-  int32_t const componentCount = it->ReadInteger32();
-
+  int32_t const frameNumber = m_packet.GetFrameNumber();
+  uint32_t const componentCount = m_packet.GetComponentCount();
   if (m_debug) {
     std::cout 
-        << "Time count in microseconds: " << sensorTimestampMicroseconds 
+        << "Time count in microseconds: " << m_packet.GetTimestamp() 
         << " Frame: " << frameNumber 
         << " componentCount: " << componentCount
         << std::endl;
   }
 
-  if (componentCount != 1) {
-    std::cout 
-        << "Unexpected answer from QTM RT server: More than one component."
-        << " Got: " << componentCount
-        << " Expecting: 1"
-        << std::endl;
-    return;
+  // The markers are taken from the first 3D component. Labelled 3D has the
+  // markers in the order of the labels in the QTM project, and a marker that
+  // is not seen has NaN coordinates. With the localizer the markers go
+  // straight into its buffer, and only the poses are sent. The rigid bodies
+  // of 6D components are sent as they are.
+  MarkerBuffer &markers = 
+      (m_localizer != nullptr) ? m_localizer->GetMarkers() : m_markers;
+  bool hasMarkers = false;
+  bool isLabelled = false;
+  for (uint32_t i = 0; i < componentCount; i++) {
+    int32_t const componentType = m_packet.GetComponentType(i);
+    if (QtmPacket::Is6d(componentType)) {
+      SendBodies(i);
+      continue;
+    }
+    if (!QtmPacket::Is3d(componentType)) {
+      if (m_debug) {
+        std::cout << "Skipped component type: " << componentType << std::endl;
+      }
+      continue;
+    }
+    if (hasMarkers) {
+      continue;
+    }
+    if (!m_packet.Read3d(i, markers, a_quality)) {
+      std::cout 
+          << "Unexpected answer from QTM RT server: Malformed 3D component."
+          << std::endl;
+      continue;
+    }
+    hasMarkers = true;
+    isLabelled = QtmPacket::IsLabelled(componentType);
+    if (m_debug) {
+      std::cout 
+          << "componentType: " << componentType 
+          << " markerCount: " << markers.GetCount() 
+          << " quality: " << a_quality
+          << std::endl;
+      for (uint32_t j = 0; j < markers.GetCount(); j++) {
+        std::cout << "ID: " << markers.GetIds()[j] << "|" 
+            << markers.GetMarker(j).toString() << std::endl;
+      }
+    }
   }
-
-  int32_t const componentSize = it->ReadInteger32();
-  int32_t const componentType = it->ReadInteger32();
-  int32_t const markerCount = it->ReadInteger32();
-  int16_t const qualityDrop = it->ReadInteger16();
-  int16_t const qualitySync = it->ReadInteger16();
-  float const quality = ((float) (qualityDrop + qualitySync)) / 2000.0f;
-  if (m_debug) {
-    std::cout 
-        << "componentSize (bytes): " << componentSize 
-        << " componentType: " << componentType 
-        << " markerCount: " << markerCount 
-        << " qualityDrop: " << qualityDrop
-        << " qualitySync: " << qualitySync
-        << " quality: " << quality
-        << std::endl;
-    
+  if (!hasMarkers) {
+    return true;
   }
-  if (componentType != 2) {
-    std::cout 
-        << "Unexpected answer from QTM RT server: Unrecognized component type."
-        << " Got: " << componentType
-        << " Expecting: 2" 
-        << std::endl;
-    return;
+
+  if (m_localizer != nullptr) {
+    m_localizer->Locate(
+        static_cast<double>(a_arrival.toMicroseconds()) / 1e6, 
+        isLabelled, m_conference);
+    return true;
   }
 
-  std::vector<opendlv::model::Cartesian3> markers;
-  for (int32_t j = 0; j < markerCount; j++)
-  {
-    float const x = it->ReadFloat32()/1e3f;
-    float const y = it->ReadFloat32()/1e3f;
-    float const z = it->ReadFloat32()/1e3f;
-    int32_t const id = it->ReadInteger32();
-    opendlv::model::Cartesian3 marker(x,y,z);
-    if (m_debug) {
-      std::cout << "ID: " << id << "|" << marker.toString() << std::endl;
+  std::vector<opendlv::model::Cartesian3> markerList;
+  std::vector<int32_t> markerIds;
+  for (uint32_t j = 0; j < markers.GetCount(); j++) {
+    markerList.push_back(markers.GetMarker(j));
+    if (isLabelled) {
+      markerIds.push_back(markers.GetIds()[j]);
     }
-    markers.push_back(marker);
   }
-  odcore::data::TimeStamp now;
-  opendlv::proxy::QtmFrame frame(markers, now, quality, frameNumber);
+  opendlv::proxy::QtmFrame frame(markerList, a_arrival, a_quality, frameNumber, 
+      markerIds);
   if (m_debug) {
     std::cout << "Sent: " << frame.toString() << std::endl;
   }
   odcore::data::Container c(frame);
   m_conference.send(c);
+  return true;
+}
+
+
+/**
+ * Sends the pose of every rigid body seen in a 6D component, with the
+ * position in decimeters like the LPS.
+ */
+void QualisysPacketDecoder::SendBodies(uint32_t a_component)
+{
+  uint32_t const bodyCount = m_packet.GetBodyCount(a_component);
+  for (uint32_t i = 0; i < bodyCount; i++) {
+    opendlv::model::Cartesian3 position;
+    opendlv::model::Cartesian3 angularDisplacement;
+    float residual = 0.0f;
+    if (!m_packet.ReadBody(a_component, i, position, angularDisplacement, 
+        residual)) {
+      continue;
+    }
+    int16_t const frameId = (i < m_bodyFrameIds.size()) ? 
+        m_bodyFrameIds[i] : static_cast<int16_t>(i);
+    // For TME290, convert to decimeters
+    opendlv::model::Cartesian3 positionScaled(position.getX() * 10.0f, 
+        position.getY() * 10.0f, position.getZ() * 10.0f);
+    opendlv::model::State state(positionScaled, angularDisplacement, frameId);
+    if (m_debug) {
+      std::cout << "Body " << i << " residual " << residual << " " 
+          << state.toString() << std::endl;
+    }
+    odcore::data::Container c(state);
+    m_conference.send(c);
+  }
 }
 
 }
@@ -16,27 +16,164 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
+#include "QtmPacket.h"
 #include "QualisysStringDecoder.h"
 
 namespace opendlv {
 namespace proxy {
 namespace miniature {
 
-QualisysStringDecoder::QualisysStringDecoder() {}
+QualisysStringDecoder::QualisysStringDecoder() 
+    : m_mutex()
+    , m_condition()
+    , m_pending()
+    , m_version()
+    , m_byteOrder()
+    , m_cameraFrequency(0.0f)
+    , m_errors()
+{}
 
 QualisysStringDecoder::~QualisysStringDecoder() {}
 
+/**
+ * Splits the received bytes into QTM RT packets, keeping a packet that is
+ * not complete until the rest of it arrives. The headers are little endian,
+ * unless the type only makes sense big endian.
+ */
 void QualisysStringDecoder::nextString(std::string const &a_string) {
-  std::istringstream ss(a_string);
-  std::string msg;
-  std::cout << "[Qualisys] ";
-  while (getline(ss, msg)) {
-    std::cout << msg;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pending += a_string;
+
+  uint32_t const headerSize = 8;
+  while (m_pending.size() >= headerSize) {
+    uint8_t header[8];
+    std::memcpy(header, m_pending.data(), headerSize);
+    uint32_t size = 0;
+    uint32_t type = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+      size |= static_cast<uint32_t>(header[i]) << (8 * i);
+      type |= static_cast<uint32_t>(header[4 + i]) << (8 * i);
+    }
+    if (type > 16) {
+      size = 0;
+      type = 0;
+      for (uint32_t i = 0; i < 4; i++) {
+        size = (size << 8) | header[i];
+        type = (type << 8) | header[4 + i];
+      }
+    }
+    if (size < headerSize || type > 16) {
+      std::cout << "[Qualisys] Unexpected reply, dropped " << m_pending.size() 
+          << " bytes." << std::endl;
+      m_pending.clear();
+      break;
+    }
+    if (m_pending.size() < size) {
+      break;
+    }
+
+    // Strings end with a null character.
+    std::string payload = m_pending.substr(headerSize, size - headerSize);
+    std::size_t const end = payload.find('\0');
+    if (end != std::string::npos) {
+      payload.resize(end);
+    }
+    Decode(static_cast<int32_t>(type), payload);
+    m_pending.erase(0, size);
   }
-  std::cout << std::endl;
+  m_condition.notify_all();
+}
+
+/**
+ * Waits for up to the given time in milliseconds for the reply to
+ * ByteOrder. Returns false if it did not arrive.
+ */
+bool QualisysStringDecoder::WaitForByteOrder(uint32_t a_timeout)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_condition.wait_for(lock, std::chrono::milliseconds(a_timeout), 
+      [this]() { return !m_byteOrder.empty(); });
+}
+
+/**
+ * Waits for up to the given time in milliseconds for the reply to
+ * GetParameters General. Returns false if it did not arrive.
+ */
+bool QualisysStringDecoder::WaitForCameraFrequency(uint32_t a_timeout)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_condition.wait_for(lock, std::chrono::milliseconds(a_timeout), 
+      [this]() { return m_cameraFrequency > 0.0f; });
+}
+
+/**
+ * Returns the protocol version QTM accepted, or an empty string.
+ */
+std::string QualisysStringDecoder::GetVersion() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_version;
+}
+
+/**
+ * Returns the byte order reported by QTM, big or little, or an empty string.
+ */
+std::string QualisysStringDecoder::GetByteOrder() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_byteOrder;
+}
 
+/**
+ * Returns the frequency of the cameras in Hz, or 0 if not known yet.
+ */
+float QualisysStringDecoder::GetCameraFrequency() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cameraFrequency;
+}
+
+std::vector<std::string> QualisysStringDecoder::GetErrors() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_errors;
+}
+
+void QualisysStringDecoder::Decode(int32_t a_type, 
+    std::string const &a_payload)
+{
+  if (a_type == QtmPacket::TYPE_ERROR) {
+    std::cout << "[Qualisys] Error: " << a_payload << std::endl;
+    m_errors.push_back(a_payload);
+  } else if (a_type == QtmPacket::TYPE_COMMAND) {
+    std::cout << "[Qualisys] " << a_payload << std::endl;
+    std::string const versionReply = "Version is set to ";
+    std::string const byteOrderReply = "Byte order is ";
+    if (a_payload.compare(0, versionReply.size(), versionReply) == 0) {
+      m_version = a_payload.substr(versionReply.size());
+    } else if (a_payload.compare(0, byteOrderReply.size(), byteOrderReply) 
+        == 0) {
+      m_byteOrder = a_payload.substr(byteOrderReply.size(), 
+          a_payload.find(' ', byteOrderReply.size()) - byteOrderReply.size());
+    }
+  } else if (a_type == QtmPacket::TYPE_XML) {
+    std::string const open = "<Frequency>";
+    std::size_t const general = a_payload.find("<General>");
+    std::size_t const start = a_payload.find(open, 
+        (general != std::string::npos) ? general : 0);
+    if (start != std::string::npos) {
+      m_cameraFrequency = 
+          std::strtof(a_payload.c_str() + start + open.size(), nullptr);
+    }
+  } else if (a_type == QtmPacket::TYPE_EVENT) {
+    int32_t const event = a_payload.empty() ? -1 : a_payload[0];
+    std::cout << "[Qualisys] Event: " << event << std::endl;
+  }
 }
 
 }
@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <iostream>
+#include <string>
+
+#include <opendavinci/odcore/data/Container.h>
+
+#include "StreamMonitor.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * Measures the stream over windows of the given period in seconds. The
+ * publisher, if any, is asked for the packets it skipped.
+ */
+StreamMonitor::StreamMonitor(
+      odcore::io::conference::ContainerConference &a_conference, 
+      bool a_debug, double a_period, DatagramListener &a_listener, 
+      FramePublisher const *a_publisher)
+    : PacketListener()
+    , DatagramListener()
+    , m_conference(a_conference)
+    , m_debug(a_debug)
+    , m_period(a_period)
+    , m_listener(a_listener)
+    , m_publisher(a_publisher)
+    , m_droppedCount(0)
+    , m_packet()
+    , m_statistics()
+{
+}
+
+StreamMonitor::~StreamMonitor()
+{
+}
+
+/**
+ * Sets the byte order of the packets, before the stream starts.
+ */
+void StreamMonitor::SetBigEndian(bool a_isBigEndian)
+{
+  m_packet.SetBigEndian(a_isBigEndian);
+}
+
+/**
+ * The statistics, to which the decoder adds the decode time and quality of
+ * the frames it decodes.
+ */
+StreamStatistics &StreamMonitor::GetStatistics()
+{
+  return m_statistics;
+}
+
+/**
+ * Measures a packet from the OpenDaVINCI receiver, stamped with the time
+ * now.
+ */
+void StreamMonitor::nextPacket(odcore::data::Packet const &a_packet)
+{
+  odcore::data::TimeStamp now;
+  std::string const data = a_packet.getData();
+  nextDatagram(reinterpret_cast<uint8_t const *>(data.data()), 
+      static_cast<uint32_t>(data.size()), now);
+}
+
+/**
+ * Adds a packet to the statistics, passes it on, and sends the statistics
+ * when their period has passed.
+ */
+void StreamMonitor::nextDatagram(uint8_t const *a_data, uint32_t a_size, 
+    odcore::data::TimeStamp const &a_arrival)
+{
+  int64_t const arrival = a_arrival.toMicroseconds();
+  if (m_packet.Parse(a_data, a_size) 
+      && m_packet.GetType() == QtmPacket::TYPE_DATA) {
+    m_statistics.Add(m_packet.GetFrameNumber(), arrival, a_size);
+  } else {
+    m_statistics.AddMalformed(arrival, a_size);
+  }
+
+  m_listener.nextDatagram(a_data, a_size, a_arrival);
+
+  if (m_statistics.IsDue(arrival, m_period)) {
+    uint64_t const droppedCount = (m_publisher != nullptr) ? 
+        m_publisher->GetDroppedCount() : 0;
+    opendlv::proxy::QtmStreamStatistics statistics = m_statistics.Report(
+        arrival, static_cast<uint32_t>(droppedCount - m_droppedCount));
+    m_droppedCount = droppedCount;
+    if (m_debug) {
+      std::cout << "Sent: " << statistics.toString() << std::endl;
+    }
+    odcore::data::Container c(statistics);
+    m_conference.send(c);
+  }
+}
+
+}
+}
+}
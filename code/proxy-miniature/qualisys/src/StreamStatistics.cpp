@@ -0,0 +1,217 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "StreamStatistics.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+// From well within the period of a 1 kHz stream to a stream that stalls.
+std::vector<float> const StreamStatistics::INTERVAL_BIN_EDGES = {0.0005f, 
+    0.001f, 0.002f, 0.005f, 0.01f, 0.02f, 0.05f};
+
+StreamStatistics::StreamStatistics()
+    : m_hasWindow(false)
+    , m_windowStart(0)
+    , m_hasLastFrame(false)
+    , m_lastFrameNumber(0)
+    , m_lastArrival(0)
+    , m_frameStep(0)
+    , m_packetCount(0)
+    , m_malformedCount(0)
+    , m_lostFrameCount(0)
+    , m_reorderedCount(0)
+    , m_byteCount(0)
+    , m_intervalCount(0)
+    , m_intervalSum(0.0)
+    , m_intervalSquareSum(0.0)
+    , m_maxInterval(0.0f)
+    , m_intervalHistogram(INTERVAL_BIN_EDGES.size() + 1, 0)
+    , m_decodeMutex()
+    , m_decodedCount(0)
+    , m_decodeTimeSum(0.0)
+    , m_maxDecodeTime(0.0f)
+    , m_qualitySum(0.0)
+{
+}
+
+StreamStatistics::~StreamStatistics()
+{
+}
+
+/**
+ * Adds a received data packet with its frame number, arrival time in
+ * microseconds and size in bytes. A frame number that is not after the last
+ * one is counted as reordered, and does not count towards the gaps.
+ */
+void StreamStatistics::Add(int32_t a_frameNumber, int64_t a_arrival, 
+    uint32_t a_size)
+{
+  Start(a_arrival);
+  m_packetCount++;
+  m_byteCount += a_size;
+
+  if (!m_hasLastFrame) {
+    m_hasLastFrame = true;
+    m_lastFrameNumber = a_frameNumber;
+    m_lastArrival = a_arrival;
+    return;
+  }
+
+  float const interval = static_cast<float>(a_arrival - m_lastArrival) / 1e6f;
+  m_lastArrival = a_arrival;
+  m_intervalCount++;
+  m_intervalSum += static_cast<double>(interval);
+  m_intervalSquareSum += static_cast<double>(interval * interval);
+  m_maxInterval = std::max(m_maxInterval, interval);
+  uint32_t const bin = static_cast<uint32_t>(std::upper_bound(
+      INTERVAL_BIN_EDGES.begin(), INTERVAL_BIN_EDGES.end(), interval) 
+      - INTERVAL_BIN_EDGES.begin());
+  m_intervalHistogram[bin]++;
+
+  int32_t const step = a_frameNumber - m_lastFrameNumber;
+  if (step <= 0) {
+    m_reorderedCount++;
+    return;
+  }
+  m_lastFrameNumber = a_frameNumber;
+  if (m_frameStep == 0 || step < m_frameStep) {
+    m_frameStep = step;
+  }
+  int32_t const missing = (step + m_frameStep / 2) / m_frameStep - 1;
+  m_lostFrameCount += static_cast<uint32_t>(std::max(missing, 0));
+}
+
+/**
+ * Adds a packet that could not be decoded.
+ */
+void StreamStatistics::AddMalformed(int64_t a_arrival, uint32_t a_size)
+{
+  Start(a_arrival);
+  m_malformedCount++;
+  m_byteCount += a_size;
+}
+
+/**
+ * Adds the time taken to decode and send a frame in seconds, and its
+ * quality. Called from the thread that decodes, which may not be the one
+ * that receives.
+ */
+void StreamStatistics::AddDecoded(float a_decodeTime, float a_quality)
+{
+  std::lock_guard<std::mutex> lock(m_decodeMutex);
+  m_decodedCount++;
+  m_decodeTimeSum += static_cast<double>(a_decodeTime);
+  m_maxDecodeTime = std::max(m_maxDecodeTime, a_decodeTime);
+  m_qualitySum += static_cast<double>(a_quality);
+}
+
+/**
+ * Whether the window has lasted the given period in seconds at the given
+ * time in microseconds.
+ */
+bool StreamStatistics::IsDue(int64_t a_time, double a_period) const
+{
+  return m_hasWindow 
+      && static_cast<double>(a_time - m_windowStart) >= a_period * 1e6;
+}
+
+/**
+ * Returns the statistics of the window up to the given time in
+ * microseconds, with the given number of packets that were received but
+ * skipped before decoding, and starts the next window.
+ */
+opendlv::proxy::QtmStreamStatistics StreamStatistics::Report(int64_t a_time, 
+    uint32_t a_droppedCount)
+{
+  float const period = 
+      static_cast<float>(std::max<int64_t>(a_time - m_windowStart, 1)) / 1e6f;
+  opendlv::proxy::QtmStreamStatistics statistics;
+  statistics.setTimestamp(odcore::data::TimeStamp(
+      static_cast<int32_t>(a_time / 1000000), 
+      static_cast<int32_t>(a_time % 1000000)));
+  statistics.setPeriod(period);
+  statistics.setPacketCount(m_packetCount);
+  statistics.setMalformedCount(m_malformedCount);
+  statistics.setLostFrameCount(m_lostFrameCount);
+  statistics.setReorderedCount(m_reorderedCount);
+  statistics.setDroppedCount(a_droppedCount);
+  statistics.setPacketRate(static_cast<float>(m_packetCount) / period);
+  statistics.setByteRate(static_cast<float>(m_byteCount) / period);
+  if (m_intervalCount > 0) {
+    double const count = static_cast<double>(m_intervalCount);
+    double const mean = m_intervalSum / count;
+    double const variance = m_intervalSquareSum / count - mean * mean;
+    statistics.setMeanInterval(static_cast<float>(mean));
+    statistics.setIntervalJitter(
+        static_cast<float>(std::sqrt(std::max(variance, 0.0))));
+    statistics.setMaxInterval(m_maxInterval);
+  }
+  statistics.setListOfIntervalHistogram(m_intervalHistogram);
+  {
+    std::lock_guard<std::mutex> lock(m_decodeMutex);
+    if (m_decodedCount > 0) {
+      double const count = static_cast<double>(m_decodedCount);
+      statistics.setMeanDecodeTime(
+          static_cast<float>(m_decodeTimeSum / count));
+      statistics.setMaxDecodeTime(m_maxDecodeTime);
+      statistics.setMeanQuality(static_cast<float>(m_qualitySum / count));
+    }
+    m_decodedCount = 0;
+    m_decodeTimeSum = 0.0;
+    m_maxDecodeTime = 0.0f;
+    m_qualitySum = 0.0;
+  }
+  Reset(a_time);
+  return statistics;
+}
+
+void StreamStatistics::Start(int64_t a_time)
+{
+  if (!m_hasWindow) {
+    m_hasWindow = true;
+    m_windowStart = a_time;
+  }
+}
+
+/**
+ * Clears the counts for the next window. The last frame is kept, so that a
+ * gap over the end of a window is counted in the next.
+ */
+void StreamStatistics::Reset(int64_t a_time)
+{
+  m_windowStart = a_time;
+  m_packetCount = 0;
+  m_malformedCount = 0;
+  m_lostFrameCount = 0;
+  m_reorderedCount = 0;
+  m_byteCount = 0;
+  m_intervalCount = 0;
+  m_intervalSum = 0.0;
+  m_intervalSquareSum = 0.0;
+  m_maxInterval = 0.0f;
+  std::fill(m_intervalHistogram.begin(), m_intervalHistogram.end(), 0);
+}
+
+}
+}
+}
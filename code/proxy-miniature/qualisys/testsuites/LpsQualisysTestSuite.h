@@ -20,11 +20,65 @@
 #ifndef QUALISYS_TESTSUITE_H
 #define QUALISYS_TESTSUITE_H
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "cxxtest/TestSuite.h"
 
 // Include local header files.
+#include "../include/BatchUdpReceiver.h"
+#include "../include/Buffer.h"
+#include "../include/FrameMailbox.h"
+#include "../include/FramePublisher.h"
+#include "../include/QtmLog.h"
+#include "../include/QtmPacket.h"
+#include "../include/QtmRecorder.h"
+#include "../include/QtmReplayer.h"
+#include "../include/QtmStreamSettings.h"
+#include "../include/QualisysStringDecoder.h"
+#include "../include/StreamStatistics.h"
 #include "../include/Qualisys.h"
 
+// Keeps the first byte, size and arrival time of each datagram.
+class DatagramRecorder : public opendlv::proxy::miniature::DatagramListener {
+   public:
+    DatagramRecorder() : m_first(), m_sizes(), m_arrivals() {}
+
+    virtual void nextDatagram(uint8_t const *a_data, uint32_t a_size, 
+        odcore::data::TimeStamp const &a_arrival) {
+        m_first.push_back(a_data[0]);
+        m_sizes.push_back(a_size);
+        m_arrivals.push_back(a_arrival.toMicroseconds());
+    }
+
+    std::vector<uint8_t> m_first;
+    std::vector<uint32_t> m_sizes;
+    std::vector<int64_t> m_arrivals;
+};
+
+// A listener slower than the packets arrive.
+class SlowRecorder : public DatagramRecorder {
+   public:
+    virtual void nextDatagram(uint8_t const *a_data, uint32_t a_size, 
+        odcore::data::TimeStamp const &a_arrival) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        DatagramRecorder::nextDatagram(a_data, a_size, a_arrival);
+    }
+};
+
 class QualisysTest : public CxxTest::TestSuite {
    public:
     void setUp() {}
@@ -34,6 +88,553 @@ class QualisysTest : public CxxTest::TestSuite {
     void testApplication() {
         TS_ASSERT(true);
     }
+
+    // A data packet with one 3D component, in the byte order of the host.
+    std::vector<uint8_t> getPacket(int32_t a_componentType, 
+        std::vector<float> const &a_coordinates, int32_t a_markerCount) {
+        bool const isLabelled = (a_componentType == 1);
+        int32_t const stride = isLabelled ? 12 : 16;
+        int32_t const componentSize = 16 + a_markerCount * stride;
+        opendlv::proxy::miniature::Buffer buffer;
+        buffer.AppendInteger32(24 + componentSize);
+        buffer.AppendInteger32(3);
+        buffer.AppendInteger64(123456);
+        buffer.AppendInteger32(42);
+        buffer.AppendInteger32(1);
+        buffer.AppendInteger32(componentSize);
+        buffer.AppendInteger32(a_componentType);
+        buffer.AppendInteger32(a_markerCount);
+        buffer.AppendInteger16(10);
+        buffer.AppendInteger16(30);
+        for (uint32_t i = 0; i < a_coordinates.size(); i += 3) {
+            buffer.AppendFloat32(a_coordinates[i]);
+            buffer.AppendFloat32(a_coordinates[i + 1]);
+            buffer.AppendFloat32(a_coordinates[i + 2]);
+            if (!isLabelled) {
+                buffer.AppendInteger32(static_cast<int32_t>(i / 3 + 7));
+            }
+        }
+        return buffer.GetData();
+    }
+
+    void testQtmPacketNoLabels() {
+        float const nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<uint8_t> const bytes = getPacket(2, 
+            {1000.0f, -2000.0f, 3000.0f, nan, nan, nan, 
+            500.0f, 0.0f, 100.0f}, 3);
+
+        opendlv::proxy::miniature::QtmPacket packet;
+        TS_ASSERT(packet.Parse(bytes.data(), 
+            static_cast<uint32_t>(bytes.size())));
+        TS_ASSERT_EQUALS(packet.GetType(), 3);
+        TS_ASSERT_EQUALS(packet.GetTimestamp(), 123456);
+        TS_ASSERT_EQUALS(packet.GetFrameNumber(), 42);
+        TS_ASSERT_EQUALS(packet.GetComponentCount(), 1u);
+        TS_ASSERT_EQUALS(packet.GetComponentType(0), 2);
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        float quality = 0.0f;
+        TS_ASSERT(packet.Read3d(0, markers, quality));
+        TS_ASSERT_DELTA(quality, 0.02f, 1e-6f);
+        TS_ASSERT_EQUALS(markers.GetCount(), 2u);
+        TS_ASSERT_DELTA(markers.GetX()[0], 1.0f, 1e-6f);
+        TS_ASSERT_DELTA(markers.GetY()[0], -2.0f, 1e-6f);
+        TS_ASSERT_DELTA(markers.GetZ()[0], 3.0f, 1e-6f);
+        TS_ASSERT_DELTA(markers.GetX()[1], 0.5f, 1e-6f);
+        TS_ASSERT_DELTA(markers.GetZ()[1], 0.1f, 1e-6f);
+        TS_ASSERT_EQUALS(markers.GetIds()[0], -1);
+    }
+
+    void testQtmPacketLabelledBigEndian() {
+        float const nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<uint8_t> bytes = getPacket(1, 
+            {nan, nan, nan, 1000.0f, 2000.0f, 3000.0f}, 2);
+        // Every field is 4 bytes but the timestamp and the rates.
+        std::vector<uint32_t> const fieldSizes = 
+            {4, 4, 8, 4, 4, 4, 4, 4, 2, 2, 4, 4, 4, 4, 4, 4};
+        uint32_t offset = 0;
+        for (uint32_t fieldSize : fieldSizes) {
+            std::reverse(bytes.begin() + offset, 
+                bytes.begin() + offset + fieldSize);
+            offset += fieldSize;
+        }
+        TS_ASSERT_EQUALS(offset, bytes.size());
+
+        opendlv::proxy::miniature::QtmPacket packet;
+        packet.SetBigEndian(true);
+        TS_ASSERT(packet.Parse(bytes.data(), 
+            static_cast<uint32_t>(bytes.size())));
+        TS_ASSERT_EQUALS(packet.GetTimestamp(), 123456);
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        float quality = 0.0f;
+        TS_ASSERT(packet.Read3d(0, markers, quality));
+        TS_ASSERT_EQUALS(markers.GetCount(), 1u);
+        TS_ASSERT_DELTA(markers.GetY()[0], 2.0f, 1e-6f);
+        TS_ASSERT_EQUALS(markers.GetIds()[0], 1);
+    }
+
+    void testQtmPacketManyMarkers() {
+        // Enough markers for the four at a time conversion and a remainder.
+        for (int32_t componentType : {1, 2}) {
+            std::vector<float> coordinates;
+            for (uint32_t i = 0; i < 30; i++) {
+                coordinates.push_back(static_cast<float>(i));
+            }
+            std::vector<uint8_t> const bytes = 
+                getPacket(componentType, coordinates, 10);
+            opendlv::proxy::miniature::QtmPacket packet;
+            TS_ASSERT(packet.Parse(bytes.data(), 
+                static_cast<uint32_t>(bytes.size())));
+            opendlv::proxy::miniature::MarkerBuffer markers;
+            float quality = 0.0f;
+            TS_ASSERT(packet.Read3d(0, markers, quality));
+            TS_ASSERT_EQUALS(markers.GetCount(), 10u);
+            for (uint32_t j = 0; j < 10; j++) {
+                TS_ASSERT_DELTA(markers.GetX()[j], 3 * j * 1e-3f, 1e-6f);
+                TS_ASSERT_DELTA(markers.GetY()[j], (3 * j + 1) * 1e-3f, 
+                    1e-6f);
+                TS_ASSERT_DELTA(markers.GetZ()[j], (3 * j + 2) * 1e-3f, 
+                    1e-6f);
+            }
+        }
+    }
+
+    void testQtmPacketComponents() {
+        float const nan = std::numeric_limits<float>::quiet_NaN();
+        opendlv::proxy::miniature::Buffer components;
+        // 3D without labels and residuals, one marker.
+        components.AppendInteger32(16 + 20);
+        components.AppendInteger32(10);
+        components.AppendInteger32(1);
+        components.AppendInteger16(0);
+        components.AppendInteger16(0);
+        for (float value : {100.0f, 200.0f, 300.0f}) {
+            components.AppendFloat32(value);
+        }
+        components.AppendInteger32(5);
+        components.AppendFloat32(0.5f);
+        // 6D with residuals, a body turned a quarter left and one not seen.
+        components.AppendInteger32(16 + 2 * 52);
+        components.AppendInteger32(11);
+        components.AppendInteger32(2);
+        components.AppendInteger16(0);
+        components.AppendInteger16(0);
+        for (float value : {1000.0f, 2000.0f, 0.0f, 
+            0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 
+            0.7f}) {
+            components.AppendFloat32(value);
+        }
+        for (uint32_t i = 0; i < 13; i++) {
+            components.AppendFloat32(nan);
+        }
+        // 6D Euler, one body.
+        components.AppendInteger32(16 + 24);
+        components.AppendInteger32(6);
+        components.AppendInteger32(1);
+        components.AppendInteger16(0);
+        components.AppendInteger16(0);
+        for (float value : {0.0f, 0.0f, 500.0f, 0.0f, 0.0f, -90.0f}) {
+            components.AppendFloat32(value);
+        }
+
+        opendlv::proxy::miniature::Buffer buffer;
+        buffer.AppendInteger32(24 + components.GetSize());
+        buffer.AppendInteger32(3);
+        buffer.AppendInteger64(0);
+        buffer.AppendInteger32(1);
+        buffer.AppendInteger32(3);
+        buffer.AppendBytesRaw(components.GetData());
+        std::vector<uint8_t> const bytes = buffer.GetData();
+
+        opendlv::proxy::miniature::QtmPacket packet;
+        TS_ASSERT(packet.Parse(bytes.data(), 
+            static_cast<uint32_t>(bytes.size())));
+        TS_ASSERT_EQUALS(packet.GetComponentCount(), 3u);
+
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        float quality = 0.0f;
+        TS_ASSERT(packet.Read3d(0, markers, quality));
+        TS_ASSERT_EQUALS(markers.GetCount(), 1u);
+        TS_ASSERT_DELTA(markers.GetZ()[0], 0.3f, 1e-6f);
+        TS_ASSERT(!packet.Read3d(1, markers, quality));
+        TS_ASSERT_EQUALS(packet.GetBodyCount(0), 0u);
+
+        opendlv::model::Cartesian3 position;
+        opendlv::model::Cartesian3 angles;
+        float residual = 0.0f;
+        TS_ASSERT_EQUALS(packet.GetBodyCount(1), 2u);
+        TS_ASSERT(packet.ReadBody(1, 0, position, angles, residual));
+        TS_ASSERT_DELTA(position.getX(), 1.0f, 1e-6f);
+        TS_ASSERT_DELTA(position.getY(), 2.0f, 1e-6f);
+        TS_ASSERT_DELTA(angles.getX(), 0.0f, 1e-6f);
+        TS_ASSERT_DELTA(angles.getY(), 0.0f, 1e-6f);
+        TS_ASSERT_DELTA(angles.getZ(), 1.5707963f, 1e-6f);
+        TS_ASSERT_DELTA(residual, 0.0007f, 1e-7f);
+        TS_ASSERT(!packet.ReadBody(1, 1, position, angles, residual));
+        TS_ASSERT(!packet.ReadBody(1, 2, position, angles, residual));
+
+        TS_ASSERT_EQUALS(packet.GetBodyCount(2), 1u);
+        TS_ASSERT(packet.ReadBody(2, 0, position, angles, residual));
+        TS_ASSERT_DELTA(position.getZ(), 0.5f, 1e-6f);
+        TS_ASSERT_DELTA(angles.getZ(), -1.5707963f, 1e-6f);
+        TS_ASSERT_DELTA(residual, 0.0f, 1e-9f);
+    }
+
+    void testBatchUdpReceiver() {
+        uint32_t const port = 30123;
+        uint32_t const datagramCount = 40;
+        DatagramRecorder recorder;
+        opendlv::proxy::miniature::BatchUdpReceiver receiver("127.0.0.1", 
+            port, 8, 1 << 20);
+        TS_ASSERT_EQUALS(receiver.GetBatchSize(), 8u);
+        TS_ASSERT(receiver.GetReceiveBufferSize() >= (1 << 20));
+        receiver.SetDatagramListener(&recorder);
+
+        // The socket is bound already, so the datagrams queue up until the
+        // receiver starts, and are drained in full batches.
+        odcore::data::TimeStamp before;
+        int sender = socket(AF_INET, SOCK_DGRAM, 0);
+        TS_ASSERT(sender >= 0);
+        struct sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        for (uint32_t i = 0; i < datagramCount; i++) {
+            std::vector<uint8_t> datagram(100 + i, static_cast<uint8_t>(i));
+            sendto(sender, datagram.data(), datagram.size(), 0, 
+                reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+        }
+        close(sender);
+
+        receiver.start();
+        for (uint32_t i = 0; i < 200 
+            && receiver.GetDatagramCount() < datagramCount; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        receiver.stop();
+        odcore::data::TimeStamp after;
+
+        TS_ASSERT_EQUALS(receiver.GetDatagramCount(), datagramCount);
+        TS_ASSERT_EQUALS(receiver.GetBatchCount(), datagramCount / 8);
+        TS_ASSERT_EQUALS(receiver.GetLargestBatch(), 8u);
+        TS_ASSERT_EQUALS(receiver.GetTruncatedCount(), 0u);
+        TS_ASSERT_EQUALS(recorder.m_sizes.size(), datagramCount);
+        for (uint32_t i = 0; i < recorder.m_sizes.size(); i++) {
+            TS_ASSERT_EQUALS(recorder.m_first[i], i);
+            TS_ASSERT_EQUALS(recorder.m_sizes[i], 100 + i);
+            TS_ASSERT(recorder.m_arrivals[i] >= before.toMicroseconds());
+            TS_ASSERT(recorder.m_arrivals[i] <= after.toMicroseconds());
+        }
+    }
+
+    void testFrameMailbox() {
+        opendlv::proxy::miniature::FrameMailbox mailbox(16);
+        TS_ASSERT(!mailbox.Take(0));
+
+        std::vector<uint8_t> packet(16, 0);
+        for (uint8_t i = 1; i <= 3; i++) {
+            packet[0] = i;
+            mailbox.Post(packet.data(), i, odcore::data::TimeStamp(i, 0));
+        }
+        TS_ASSERT(mailbox.Take(0));
+        TS_ASSERT_EQUALS(mailbox.GetData()[0], 3);
+        TS_ASSERT_EQUALS(mailbox.GetSize(), 3u);
+        TS_ASSERT_EQUALS(mailbox.GetArrival().getSeconds(), 3);
+        TS_ASSERT(!mailbox.Take(0));
+
+        // The taken packet stays valid while the writer goes on.
+        for (uint8_t i = 4; i <= 6; i++) {
+            packet[0] = i;
+            mailbox.Post(packet.data(), i, odcore::data::TimeStamp(i, 0));
+            TS_ASSERT_EQUALS(mailbox.GetData()[0], 3);
+        }
+        TS_ASSERT(mailbox.Take(0));
+        TS_ASSERT_EQUALS(mailbox.GetData()[0], 6);
+
+        std::vector<uint8_t> large(17, 0);
+        mailbox.Post(large.data(), 17, odcore::data::TimeStamp());
+        TS_ASSERT(!mailbox.Take(0));
+
+        TS_ASSERT_EQUALS(mailbox.GetPostedCount(), 7u);
+        TS_ASSERT_EQUALS(mailbox.GetTakenCount(), 2u);
+        TS_ASSERT_EQUALS(mailbox.GetDroppedCount(), 5u);
+    }
+
+    void testFramePublisherSkipsFrames() {
+        uint32_t const packetCount = 100;
+        SlowRecorder recorder;
+        opendlv::proxy::miniature::FramePublisher publisher(recorder);
+        opendlv::proxy::miniature::DatagramListener &listener = publisher;
+        publisher.start();
+
+        std::vector<uint8_t> packet(8, 0);
+        for (uint32_t i = 0; i < packetCount; i++) {
+            packet[0] = static_cast<uint8_t>(i);
+            listener.nextDatagram(packet.data(), 8, odcore::data::TimeStamp());
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        for (uint32_t i = 0; i < 100 
+            && (recorder.m_first.empty() 
+            || recorder.m_first.back() != packetCount - 1); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        publisher.stop();
+
+        // The last packet is always published, and the ones published are in
+        // order.
+        TS_ASSERT_EQUALS(publisher.GetReceivedCount(), packetCount);
+        TS_ASSERT(publisher.GetDroppedCount() > 0);
+        TS_ASSERT_EQUALS(publisher.GetPublishedCount() 
+            + publisher.GetDroppedCount(), packetCount);
+        TS_ASSERT_EQUALS(recorder.m_first.size(), 
+            publisher.GetPublishedCount());
+        TS_ASSERT_EQUALS(recorder.m_first.back(), packetCount - 1);
+        TS_ASSERT(std::is_sorted(recorder.m_first.begin(), 
+            recorder.m_first.end()));
+    }
+
+    void testQtmStreamSettings() {
+        opendlv::proxy::miniature::QtmStreamSettings const frequency(100, 0, 
+            false, 30000, "3D  6DRes");
+        TS_ASSERT_EQUALS(frequency.GetCommand(), 
+            "StreamFrames Frequency:100 UDP:30000 3D 6DRes");
+        TS_ASSERT_DELTA(frequency.GetRate(200.0f), 100.0f, 1e-6f);
+        TS_ASSERT_DELTA(frequency.GetRate(60.0f), 60.0f, 1e-6f);
+        TS_ASSERT(frequency.GetUnknownComponents().empty());
+
+        opendlv::proxy::miniature::QtmStreamSettings const divisor(100, 4, 
+            false, 30000, "3DNoLabels 6d");
+        TS_ASSERT_EQUALS(divisor.GetCommand(), 
+            "StreamFrames FrequencyDivisor:4 UDP:30000 3DNoLabels 6d");
+        TS_ASSERT_DELTA(divisor.GetRate(200.0f), 50.0f, 1e-6f);
+        TS_ASSERT_EQUALS(divisor.GetUnknownComponents().size(), 1u);
+        TS_ASSERT_EQUALS(divisor.GetUnknownComponents()[0], "6d");
+
+        opendlv::proxy::miniature::QtmStreamSettings const allFrames(100, 4, 
+            true, 30000, "3D");
+        TS_ASSERT_EQUALS(allFrames.GetCommand(), 
+            "StreamFrames AllFrames UDP:30000 3D");
+        TS_ASSERT_DELTA(allFrames.GetRate(200.0f), 200.0f, 1e-6f);
+    }
+
+    // A QTM RT packet of the given type with a string, little endian.
+    std::string getReply(int32_t a_type, std::string const &a_string) {
+        opendlv::proxy::miniature::Buffer buffer;
+        buffer.AppendInteger32(static_cast<int32_t>(9 + a_string.size()));
+        buffer.AppendInteger32(a_type);
+        buffer.AppendStringRaw(a_string);
+        buffer.AppendByte(0);
+        std::vector<uint8_t> const bytes = buffer.GetData();
+        return std::string(bytes.begin(), bytes.end());
+    }
+
+    void testQualisysStringDecoder() {
+        opendlv::proxy::miniature::QualisysStringDecoder decoder;
+        TS_ASSERT(!decoder.WaitForByteOrder(0));
+        TS_ASSERT(!decoder.WaitForCameraFrequency(0));
+
+        // Replies joined in one string, and one split over two.
+        std::string const replies = getReply(1, "QTM RT Interface connected") 
+            + getReply(1, "Version is set to 1.12") 
+            + getReply(1, "Byte order is little endian");
+        std::string const error = getReply(0, "Parse error");
+        std::string const xml = getReply(2, "<QTM_Parameters_Ver_1.12>"
+            "<General><Frequency>180</Frequency><Capture_Time>1.0"
+            "</Capture_Time></General></QTM_Parameters_Ver_1.12>");
+        decoder.nextString(replies + error.substr(0, 5));
+        TS_ASSERT_EQUALS(decoder.GetVersion(), "1.12");
+        TS_ASSERT(decoder.WaitForByteOrder(0));
+        TS_ASSERT_EQUALS(decoder.GetByteOrder(), "little");
+        TS_ASSERT(decoder.GetErrors().empty());
+        decoder.nextString(error.substr(5) + xml.substr(0, 20));
+        TS_ASSERT_EQUALS(decoder.GetErrors().size(), 1u);
+        TS_ASSERT_EQUALS(decoder.GetErrors()[0], "Parse error");
+        TS_ASSERT(!decoder.WaitForCameraFrequency(0));
+        decoder.nextString(xml.substr(20));
+        TS_ASSERT(decoder.WaitForCameraFrequency(0));
+        TS_ASSERT_DELTA(decoder.GetCameraFrequency(), 180.0f, 1e-6f);
+    }
+
+    void testQtmPacketMalformed() {
+        std::vector<uint8_t> bytes = getPacket(2, 
+            {1000.0f, 2000.0f, 3000.0f}, 1);
+        opendlv::proxy::miniature::QtmPacket packet;
+        // Shorter than the header says.
+        TS_ASSERT(!packet.Parse(bytes.data(), 
+            static_cast<uint32_t>(bytes.size() - 1)));
+        TS_ASSERT(!packet.Parse(bytes.data(), 6));
+
+        // More markers than the component holds.
+        int32_t const markerCount = 2;
+        std::memcpy(&bytes[32], &markerCount, 4);
+        TS_ASSERT(packet.Parse(bytes.data(), 
+            static_cast<uint32_t>(bytes.size())));
+        opendlv::proxy::miniature::MarkerBuffer markers;
+        float quality = 0.0f;
+        TS_ASSERT(!packet.Read3d(0, markers, quality));
+
+        // A component larger than the packet.
+        int32_t const componentSize = 100;
+        std::memcpy(&bytes[24], &componentSize, 4);
+        TS_ASSERT(!packet.Parse(bytes.data(), 
+            static_cast<uint32_t>(bytes.size())));
+    }
+
+    void testStreamStatistics() {
+        opendlv::proxy::miniature::StreamStatistics statistics;
+        // Every second frame of a 200 Hz stream, with frames 9 and 15 lost,
+        // frame 11 arriving again after 13, and a stall before frame 17.
+        int32_t const frames[] = {1, 3, 5, 7, 11, 13, 11, 17, 19};
+        int64_t const arrivals[] = {0, 10000, 20000, 30000, 50000, 60000, 
+            60500, 130000, 140000};
+        for (uint32_t i = 0; i < 9; i++) {
+            statistics.Add(frames[i], arrivals[i], 100);
+        }
+        // Only some of the frames are decoded, the others were skipped.
+        statistics.AddDecoded(0.001f, 0.5f);
+        statistics.AddDecoded(0.003f, 0.7f);
+        statistics.AddMalformed(145000, 10);
+        TS_ASSERT(!statistics.IsDue(145000, 1.0));
+        TS_ASSERT(statistics.IsDue(200000, 0.2));
+
+        opendlv::proxy::QtmStreamStatistics const report = 
+            statistics.Report(200000, 7);
+        TS_ASSERT_DELTA(report.getPeriod(), 0.2f, 1e-6f);
+        TS_ASSERT_EQUALS(report.getPacketCount(), 9u);
+        TS_ASSERT_EQUALS(report.getMalformedCount(), 1u);
+        TS_ASSERT_EQUALS(report.getLostFrameCount(), 2u);
+        TS_ASSERT_EQUALS(report.getReorderedCount(), 1u);
+        TS_ASSERT_EQUALS(report.getDroppedCount(), 7u);
+        TS_ASSERT_DELTA(report.getPacketRate(), 45.0f, 1e-3f);
+        TS_ASSERT_DELTA(report.getByteRate(), 4550.0f, 1e-2f);
+        TS_ASSERT_DELTA(report.getMeanInterval(), 0.0175f, 1e-6f);
+        TS_ASSERT_DELTA(report.getMaxInterval(), 0.0695f, 1e-6f);
+        TS_ASSERT(report.getIntervalJitter() > 0.015f);
+        std::vector<uint32_t> const histogram = 
+            report.getListOfIntervalHistogram();
+        TS_ASSERT_EQUALS(histogram.size(), 8u);
+        TS_ASSERT_EQUALS(histogram[1], 1u);
+        TS_ASSERT_EQUALS(histogram[5], 5u);
+        TS_ASSERT_EQUALS(histogram[6], 1u);
+        TS_ASSERT_EQUALS(histogram[7], 1u);
+        TS_ASSERT_DELTA(report.getMeanDecodeTime(), 0.002f, 1e-6f);
+        TS_ASSERT_DELTA(report.getMaxDecodeTime(), 0.003f, 1e-6f);
+        TS_ASSERT_DELTA(report.getMeanQuality(), 0.6f, 1e-6f);
+
+        // The next window starts from the last frame of this one.
+        TS_ASSERT(!statistics.IsDue(200000, 0.2));
+        statistics.Add(25, 240000, 100);
+        opendlv::proxy::QtmStreamStatistics const next = 
+            statistics.Report(400000, 0);
+        TS_ASSERT_EQUALS(next.getPacketCount(), 1u);
+        TS_ASSERT_EQUALS(next.getLostFrameCount(), 2u);
+        TS_ASSERT_EQUALS(next.getReorderedCount(), 0u);
+        TS_ASSERT_EQUALS(next.getDroppedCount(), 0u);
+        TS_ASSERT_DELTA(next.getMeanDecodeTime(), 0.0f, 1e-9f);
+    }
+
+    void testQtmRecorderAndLog() {
+        char directory[] = "/tmp/qtmlogXXXXXX";
+        TS_ASSERT(mkdtemp(directory) != nullptr);
+        std::string const prefix = std::string(directory) + "/capture";
+        uint32_t const packetCount = 100;
+        uint32_t const maxSize = 
+            opendlv::proxy::miniature::BatchUdpReceiver::MAX_DATAGRAM_SIZE;
+        DatagramRecorder passed;
+        {
+            // Too small a segment is grown to fit the largest packet, so
+            // about 32 of these packets fit in each.
+            opendlv::proxy::miniature::QtmRecorder recorder(prefix, 1000, 
+                &passed);
+            TS_ASSERT(recorder.GetSegmentSize() > maxSize);
+            opendlv::proxy::miniature::DatagramListener &listener = recorder;
+            for (uint32_t i = 0; i < packetCount; i++) {
+                std::vector<uint8_t> packet(2001 + i, static_cast<uint8_t>(i));
+                listener.nextDatagram(packet.data(), 
+                    static_cast<uint32_t>(packet.size()), 
+                    odcore::data::TimeStamp(10, static_cast<int32_t>(i * 100)));
+            }
+            TS_ASSERT_EQUALS(recorder.GetRecordedCount(), packetCount);
+            TS_ASSERT_EQUALS(recorder.GetSegmentCount(), 4u);
+        }
+        TS_ASSERT_EQUALS(passed.m_sizes.size(), packetCount);
+
+        opendlv::proxy::miniature::QtmLog log(prefix);
+        TS_ASSERT_EQUALS(log.GetCount(), packetCount);
+        TS_ASSERT_EQUALS(log.GetSegmentCount(), 4u);
+        for (uint32_t i = 0; i < log.GetCount(); i++) {
+            TS_ASSERT_EQUALS(log.GetSize(i), 2001 + i);
+            TS_ASSERT_EQUALS(log.GetArrival(i), 10000000 + i * 100);
+            TS_ASSERT_EQUALS(log.GetData(i)[0], i);
+            TS_ASSERT_EQUALS(log.GetData(i)[log.GetSize(i) - 1], i);
+        }
+
+        // The full segments are cut to the records in them.
+        struct stat fileStatus;
+        TS_ASSERT_EQUALS(stat(opendlv::proxy::miniature::QtmLog::
+            GetSegmentFilename(prefix, 0).c_str(), &fileStatus), 0);
+        TS_ASSERT(static_cast<uint32_t>(fileStatus.st_size) < maxSize + 32);
+
+        TS_ASSERT_THROWS(opendlv::proxy::miniature::QtmLog(prefix + "x"), 
+            std::runtime_error);
+
+        // An offset that would wrap around when the size is added to it.
+        uint64_t const offset = std::numeric_limits<uint64_t>::max() - 100;
+        std::FILE *index = std::fopen(opendlv::proxy::miniature::QtmLog::
+            GetIndexFilename(prefix).c_str(), "r+b");
+        TS_ASSERT(index != nullptr);
+        std::fseek(index, 
+            sizeof(opendlv::proxy::miniature::QtmLog::fileHeader) + 8, 
+            SEEK_SET);
+        std::fwrite(&offset, sizeof(offset), 1, index);
+        std::fclose(index);
+        TS_ASSERT_THROWS(opendlv::proxy::miniature::QtmLog corrupt(prefix), 
+            std::runtime_error);
+        std::system((std::string("rm -r ") + directory).c_str());
+    }
+
+    void testQtmReplayer() {
+        char directory[] = "/tmp/qtmlogXXXXXX";
+        TS_ASSERT(mkdtemp(directory) != nullptr);
+        std::string const prefix = std::string(directory) + "/capture";
+        uint32_t const packetCount = 20;
+        {
+            opendlv::proxy::miniature::QtmRecorder recorder(prefix, 0, 
+                nullptr);
+            opendlv::proxy::miniature::DatagramListener &listener = recorder;
+            std::vector<uint8_t> packet(50, 0);
+            for (uint32_t i = 0; i < packetCount; i++) {
+                packet[0] = static_cast<uint8_t>(i);
+                listener.nextDatagram(packet.data(), 50, 
+                    odcore::data::TimeStamp(5, static_cast<int32_t>(i * 2000)));
+            }
+        }
+
+        // As fast as possible, and at the recorded pace of 2 ms per packet.
+        for (uint32_t realTime = 0; realTime < 2; realTime++) {
+            DatagramRecorder replayed;
+            opendlv::proxy::miniature::QtmReplayer replayer(prefix, 
+                realTime == 1, replayed);
+            TS_ASSERT_EQUALS(replayer.GetCount(), packetCount);
+            replayer.start();
+            for (uint32_t i = 0; i < 200 && !replayer.IsDone(); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            replayer.stop();
+            TS_ASSERT(replayer.IsDone());
+            TS_ASSERT_EQUALS(replayer.GetReplayedCount(), packetCount);
+            TS_ASSERT_EQUALS(replayed.m_first.size(), packetCount);
+            for (uint32_t i = 0; i < replayed.m_first.size(); i++) {
+                TS_ASSERT_EQUALS(replayed.m_first[i], i);
+                TS_ASSERT_EQUALS(replayed.m_arrivals[i], 5000000 + i * 2000);
+            }
+            if (realTime == 1) {
+                TS_ASSERT(replayer.GetDuration() >= 0.038);
+            }
+        }
+        std::system((std::string("rm -r ") + directory).c_str());
+    }
 };
 
 #endif
@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROXY_MINIATURE_SYSFSATTRIBUTE_H
+#define PROXY_MINIATURE_SYSFSATTRIBUTE_H
+
+#include <cstdint>
+#include <string>
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+/**
+ * A handle to a sysfs attribute, such as the value of a GPIO pin, which is
+ * opened once and then read and written at offset zero with pread and
+ * pwrite. Every access is a single system call into a buffer on the stack,
+ * instead of an open, a read or write, and a close through a stream. The
+ * integers are formatted and parsed by hand. Values are written with a
+ * trailing newline, which sysfs accepts, so that a shorter value also
+ * replaces a longer one in a regular file, as in a fake tree for tests.
+ */
+class SysfsAttribute {
+ public:
+  SysfsAttribute();
+  SysfsAttribute(SysfsAttribute const &) = delete;
+  SysfsAttribute &operator=(SysfsAttribute const &) = delete;
+  SysfsAttribute(SysfsAttribute &&);
+  SysfsAttribute &operator=(SysfsAttribute &&);
+  virtual ~SysfsAttribute();
+  bool Open(std::string const &, bool);
+  void Close();
+  bool IsOpen() const;
+  std::string const &GetPath() const;
+  bool ReadInteger(int64_t &) const;
+  bool WriteInteger(int64_t) const;
+  bool ReadString(std::string &) const;
+  bool WriteString(std::string const &) const;
+
+  static uint32_t const BUFFER_SIZE;
+
+ private:
+  int m_file;
+  std::string m_path;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "SysfsAttribute.h"
+
+namespace opendlv {
+namespace proxy {
+namespace miniature {
+
+// Holds any integer attribute, or a word such as a GPIO direction.
+uint32_t const SysfsAttribute::BUFFER_SIZE = 32;
+
+SysfsAttribute::SysfsAttribute()
+    : m_file(-1)
+    , m_path()
+{
+}
+
+SysfsAttribute::SysfsAttribute(SysfsAttribute &&a_attribute)
+    : m_file(a_attribute.m_file)
+    , m_path(std::move(a_attribute.m_path))
+{
+  a_attribute.m_file = -1;
+}
+
+SysfsAttribute &SysfsAttribute::operator=(SysfsAttribute &&a_attribute)
+{
+  if (this != &a_attribute) {
+    Close();
+    m_file = a_attribute.m_file;
+    m_path = std::move(a_attribute.m_path);
+    a_attribute.m_file = -1;
+  }
+  return *this;
+}
+
+SysfsAttribute::~SysfsAttribute()
+{
+  Close();
+}
+
+/**
+ * Opens the attribute at the given path, for reading and writing if
+ * writable and only for reading otherwise. Any attribute opened before is
+ * closed. Returns false if it could not be opened.
+ */
+bool SysfsAttribute::Open(std::string const &a_path, bool a_isWritable)
+{
+  Close();
+  m_path = a_path;
+  m_file = open(a_path.c_str(), (a_isWritable ? O_RDWR : O_RDONLY) 
+      | O_CLOEXEC);
+  return (m_file >= 0);
+}
+
+void SysfsAttribute::Close()
+{
+  if (m_file >= 0) {
+    close(m_file);
+    m_file = -1;
+  }
+}
+
+bool SysfsAttribute::IsOpen() const
+{
+  return (m_file >= 0);
+}
+
+std::string const &SysfsAttribute::GetPath() const
+{
+  return m_path;
+}
+
+/**
+ * Reads the attribute as a decimal integer, which may be followed by a
+ * newline. Returns false if it could not be read or holds no integer.
+ */
+bool SysfsAttribute::ReadInteger(int64_t &a_value) const
+{
+  char buffer[BUFFER_SIZE];
+  ssize_t const size = pread(m_file, buffer, BUFFER_SIZE, 0);
+  if (size <= 0) {
+    return false;
+  }
+
+  ssize_t i = 0;
+  bool const isNegative = (buffer[0] == '-');
+  if (isNegative) {
+    i++;
+  }
+  ssize_t const firstDigit = i;
+  int64_t value = 0;
+  for (; i < size && buffer[i] >= '0' && buffer[i] <= '9'; i++) {
+    value = value * 10 + (buffer[i] - '0');
+  }
+  if (i == firstDigit) {
+    return false;
+  }
+  a_value = isNegative ? -value : value;
+  return true;
+}
+
+/**
+ * Writes a decimal integer and a newline to the attribute. Returns false
+ * if the whole value was not written.
+ */
+bool SysfsAttribute::WriteInteger(int64_t a_value) const
+{
+  // Formatted backwards from the newline at the end of the buffer.
+  char buffer[BUFFER_SIZE];
+  uint32_t first = BUFFER_SIZE - 1;
+  buffer[first] = '\n';
+  uint64_t magnitude = (a_value < 0) ? 
+      0 - static_cast<uint64_t>(a_value) : static_cast<uint64_t>(a_value);
+  do {
+    buffer[--first] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (a_value < 0) {
+    buffer[--first] = '-';
+  }
+
+  size_t const size = BUFFER_SIZE - first;
+  return (pwrite(m_file, buffer + first, size, 0) 
+      == static_cast<ssize_t>(size));
+}
+
+/**
+ * Reads the attribute as a word, up to the first newline. Returns false if
+ * it could not be read.
+ */
+bool SysfsAttribute::ReadString(std::string &a_value) const
+{
+  char buffer[BUFFER_SIZE];
+  ssize_t const size = pread(m_file, buffer, BUFFER_SIZE, 0);
+  if (size < 0) {
+    return false;
+  }
+  ssize_t length = 0;
+  while (length < size && buffer[length] != '\n') {
+    length++;
+  }
+  a_value.assign(buffer, static_cast<size_t>(length));
+  return true;
+}
+
+/**
+ * Writes a word and a newline to the attribute. Returns false if the whole
+ * word was not written.
+ */
+bool SysfsAttribute::WriteString(std::string const &a_value) const
+{
+  if (a_value.size() >= BUFFER_SIZE) {
+    return false;
+  }
+  char buffer[BUFFER_SIZE];
+  a_value.copy(buffer, a_value.size());
+  buffer[a_value.size()] = '\n';
+  size_t const size = a_value.size() + 1;
+  return (pwrite(m_file, buffer, size, 0) == static_cast<ssize_t>(size));
+}
+
+}
+}
+}
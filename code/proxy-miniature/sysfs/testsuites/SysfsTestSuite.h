@@ -0,0 +1,178 @@
+/**
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SYSFS_TESTSUITE_H
+#define SYSFS_TESTSUITE_H
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "cxxtest/TestSuite.h"
+
+// Include local header files.
+#include "../include/SysfsAttribute.h"
+
+class SysfsTest : public CxxTest::TestSuite {
+   public:
+    SysfsTest() : m_directory() {}
+
+    // A fake sysfs tree of GPIO pins, each with a direction and a value.
+    void setUp() {
+        char directory[] = "/tmp/sysfsXXXXXX";
+        TS_ASSERT(mkdtemp(directory) != nullptr);
+        m_directory = directory;
+        for (uint32_t pin = 0; pin < 4; pin++) {
+            std::string const pinPath = GetPinPath(pin);
+            mkdir(pinPath.c_str(), 0755);
+            std::ofstream(pinPath + "/direction") << "in\n";
+            std::ofstream(pinPath + "/value") << (pin % 2) << "\n";
+        }
+    }
+
+    void tearDown() {
+        std::system(("rm -r " + m_directory).c_str());
+    }
+
+    std::string GetPinPath(uint32_t a_pin) const {
+        return m_directory + "/gpio" + std::to_string(a_pin);
+    }
+
+    // The read system calls made by this process, as counted by the kernel,
+    // or -1 where it does not count them.
+    int64_t GetReadCallCount() const {
+        std::ifstream file("/proc/self/io", std::ifstream::in);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.compare(0, 6, "syscr:") == 0) {
+                return std::stoll(line.substr(6));
+            }
+        }
+        return -1;
+    }
+
+    void testReadAndWrite() {
+        opendlv::proxy::miniature::SysfsAttribute value;
+        TS_ASSERT(!value.IsOpen());
+        TS_ASSERT(value.Open(GetPinPath(1) + "/value", true));
+        int64_t reading = 0;
+        TS_ASSERT(value.ReadInteger(reading));
+        TS_ASSERT_EQUALS(reading, 1);
+
+        // A shorter value replaces a longer one, and reads are repeated
+        // from the start.
+        TS_ASSERT(value.WriteInteger(-1234567890123ll));
+        TS_ASSERT(value.ReadInteger(reading));
+        TS_ASSERT_EQUALS(reading, -1234567890123ll);
+        TS_ASSERT(value.WriteInteger(0));
+        TS_ASSERT(value.ReadInteger(reading));
+        TS_ASSERT_EQUALS(reading, 0);
+        TS_ASSERT(value.ReadInteger(reading));
+        TS_ASSERT_EQUALS(reading, 0);
+
+        opendlv::proxy::miniature::SysfsAttribute direction;
+        TS_ASSERT(direction.Open(GetPinPath(1) + "/direction", true));
+        std::string word;
+        TS_ASSERT(direction.ReadString(word));
+        TS_ASSERT_EQUALS(word, "in");
+        TS_ASSERT(direction.WriteString("out"));
+        TS_ASSERT(direction.ReadString(word));
+        TS_ASSERT_EQUALS(word, "out");
+        TS_ASSERT(!direction.ReadInteger(reading));
+        TS_ASSERT(!direction.WriteString(std::string(
+            opendlv::proxy::miniature::SysfsAttribute::BUFFER_SIZE, 'x')));
+
+        // Read only, missing and moved attributes.
+        opendlv::proxy::miniature::SysfsAttribute readOnly;
+        TS_ASSERT(readOnly.Open(GetPinPath(2) + "/value", false));
+        TS_ASSERT(!readOnly.WriteInteger(1));
+        opendlv::proxy::miniature::SysfsAttribute missing;
+        TS_ASSERT(!missing.Open(GetPinPath(9) + "/value", false));
+        TS_ASSERT(!missing.ReadInteger(reading));
+        opendlv::proxy::miniature::SysfsAttribute moved(std::move(value));
+        TS_ASSERT(!value.IsOpen());
+        TS_ASSERT(moved.ReadInteger(reading));
+        TS_ASSERT_EQUALS(moved.GetPath(), GetPinPath(1) + "/value");
+    }
+
+    // Reads the four values for many ticks, through streams opened every
+    // tick as the proxies did before, and through attributes opened once.
+    // The attributes make one system call per pin per tick, where a stream
+    // makes at least an open, a read and a close. The calls are counted by
+    // the kernel, so the attributes count nothing themselves.
+    void testSystemCallsPerTick() {
+        uint32_t const tickCount = 2000;
+        uint32_t const pinCount = 4;
+
+        std::chrono::steady_clock::time_point start = 
+            std::chrono::steady_clock::now();
+        int64_t streamSum = 0;
+        for (uint32_t tick = 0; tick < tickCount; tick++) {
+            for (uint32_t pin = 0; pin < pinCount; pin++) {
+                std::ifstream file(GetPinPath(pin) + "/value", 
+                    std::ifstream::in);
+                std::string line;
+                std::getline(file, line);
+                streamSum += std::stoi(line);
+                file.close();
+            }
+        }
+        double const streamTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::vector<opendlv::proxy::miniature::SysfsAttribute> values(
+            pinCount);
+        for (uint32_t pin = 0; pin < pinCount; pin++) {
+            TS_ASSERT(values[pin].Open(GetPinPath(pin) + "/value", false));
+        }
+        int64_t const callCount = GetReadCallCount();
+        start = std::chrono::steady_clock::now();
+        int64_t attributeSum = 0;
+        for (uint32_t tick = 0; tick < tickCount; tick++) {
+            for (uint32_t pin = 0; pin < pinCount; pin++) {
+                int64_t reading = 0;
+                values[pin].ReadInteger(reading);
+                attributeSum += reading;
+            }
+        }
+        double const attributeTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        // The few reads of the count itself are lost in the division.
+        int64_t const callsPerTick = (callCount < 0) ? -1 : 
+            (GetReadCallCount() - callCount) / tickCount;
+
+        TS_ASSERT_EQUALS(attributeSum, streamSum);
+        if (callCount >= 0) {
+            TS_ASSERT_EQUALS(callsPerTick, pinCount);
+        }
+        std::cout << std::endl << "[Sysfs] " << pinCount << " pins, " 
+            << 1e6 * streamTime / tickCount << " us per tick with streams, " 
+            << 1e6 * attributeTime / tickCount << " us and " << callsPerTick 
+            << " system calls per tick with attributes." << std::endl;
+    }
+
+   private:
+    std::string m_directory;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * opendlv-sim-miniature-closedloop - In-process closed-loop simulation.
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+
+#include "ClosedLoop.h"
+
+int32_t main(int32_t argc, char **argv) {
+  std::string configuration = "./configuration";
+  double duration = 600.0;
+  float navigationFrequency = 10.0f;
+  float simulationFrequency = 20.0f;
+  bool debug = false;
+
+  for (int32_t i = 1; i < argc; i++) {
+    std::string const argument(argv[i]);
+    std::string const value = argument.substr(argument.find('=') + 1);
+    if (argument.find("--configuration=") == 0) {
+      configuration = value;
+    } else if (argument.find("--duration=") == 0) {
+      duration = std::stod(value);
+    } else if (argument.find("--navigation-freq=") == 0) {
+      navigationFrequency = std::stof(value);
+    } else if (argument.find("--simulation-freq=") == 0) {
+      simulationFrequency = std::stof(value);
+    } else if (argument.find("--verbose=") == 0) {
+      debug = (std::stoi(value) == 1);
+    } else {
+      std::cerr << "Unknown argument: " << argument << std::endl;
+      return 1;
+    }
+  }
+
+  std::ifstream file(configuration);
+  if (!file.is_open()) {
+    std::cerr << "Could not open " << configuration << "." << std::endl;
+    return 1;
+  }
+  odcore::base::KeyValueConfiguration kv;
+  kv.readFrom(file);
+
+  opendlv::sim::miniature::ClosedLoop closedLoop(kv, navigationFrequency, 
+      simulationFrequency, debug);
+
+  auto const start = std::chrono::steady_clock::now();
+  closedLoop.Run(duration);
+  auto const end = std::chrono::steady_clock::now();
+  double const wallTime = 
+      std::chrono::duration<double>(end - start).count();
+
+  std::cout << "Simulated " << closedLoop.GetSimulatedTime() << " s ("
+      << closedLoop.GetSimulationSteps() << " simulation steps, " 
+      << closedLoop.GetNavigationSteps() << " navigation steps, "
+      << closedLoop.GetDeliveredCount() << " containers) in " << wallTime 
+      << " s." << std::endl;
+  std::cout << "Final state: " << closedLoop.GetEgoState().toString() 
+      << std::endl;
+  return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_CLOSEDLOOP_H
+#define SIM_MINIATURE_CLOSEDLOOP_H
+
+#include <random>
+#include <vector>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+
+#include <opendlv/data/environment/EgoState.h>
+#include <opendlv/data/environment/Line.h>
+#include <opendlv/data/environment/Point3.h>
+
+#include <Navigator.h>
+
+#include "DifferentialKinematics.h"
+#include "MessageBus.h"
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+/**
+ * Runs the navigation logic and the differential kinematics in one process
+ * on a virtual clock. Both are stepped at their own frequencies, in time
+ * order, and exchange containers through an in-memory message bus. The
+ * simulation runs as fast as the CPU allows and is fully deterministic, also
+ * when noise is added to the LPS since the noise generator is seeded.
+ */
+class ClosedLoop {
+ public:
+  ClosedLoop(odcore::base::KeyValueConfiguration const &, float, float, bool);
+  ClosedLoop(ClosedLoop const &) = delete;
+  ClosedLoop &operator=(ClosedLoop const &) = delete;
+  virtual ~ClosedLoop();
+  void Run(double);
+  bool RunUntilGoals(uint32_t, double);
+  void SetPose(double, double, double);
+  void SetParameters(opendlv::logic::miniature::navigationParameters const &);
+  void SetLpsNoise(double, double, uint32_t);
+  opendlv::data::environment::EgoState GetEgoState() const;
+  double GetSimulatedTime() const;
+  uint64_t GetNavigationSteps() const;
+  uint64_t GetSimulationSteps() const;
+  uint64_t GetDeliveredCount() const;
+  uint32_t GetGoalsReached() const;
+  uint32_t GetCollisions() const;
+  std::vector<opendlv::data::environment::Point3> GetPointsOfInterest() const;
+
+ private:
+  static const double COLLISION_DISTANCE;
+
+  bool RunUntil(int64_t, uint32_t);
+  odcore::data::TimeStamp GetTimeStamp() const;
+  double GetDistanceToClosestWall() const;
+  void StepNavigation();
+  void StepSimulation();
+
+  MessageBus m_bus;
+  opendlv::logic::miniature::Navigator m_navigator;
+  DifferentialKinematics m_kinematics;
+  std::vector<opendlv::data::environment::Line> m_walls;
+  std::mt19937 m_randomGenerator;
+  std::normal_distribution<double> m_noise;
+  double m_positionNoise;
+  double m_yawNoise;
+  int64_t m_navigationPeriod;
+  int64_t m_simulationPeriod;
+  int64_t m_nextNavigation;
+  int64_t m_nextSimulation;
+  int64_t m_now;
+  uint64_t m_navigationSteps;
+  uint64_t m_simulationSteps;
+  uint32_t m_collisions;
+  bool m_isColliding;
+};
+
+}
+}
+}
+
+#endif
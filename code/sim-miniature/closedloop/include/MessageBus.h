@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_MESSAGEBUS_H
+#define SIM_MINIATURE_MESSAGEBUS_H
+
+#include <vector>
+
+#include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+#include <opendavinci/odcore/io/conference/ContainerListener.h>
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+/**
+ * An in-memory stand-in for the container conference. Sent containers are
+ * queued and handed to every listener on the next call to Deliver, so a
+ * container sent at one tick is seen by all modules at the next tick, in the
+ * order it was sent.
+ */
+class MessageBus {
+ public:
+  MessageBus();
+  MessageBus(MessageBus const &) = delete;
+  MessageBus &operator=(MessageBus const &) = delete;
+  virtual ~MessageBus();
+  void AddListener(odcore::io::conference::ContainerListener *);
+  void Send(odcore::data::Container &, odcore::data::TimeStamp const &);
+  void Deliver(odcore::data::TimeStamp const &);
+  uint64_t GetDeliveredCount() const;
+
+ private:
+  std::vector<odcore::io::conference::ContainerListener *> m_listeners;
+  std::vector<odcore::data::Container> m_queue;
+  std::vector<odcore::data::Container> m_delivering;
+  uint64_t m_deliveredCount;
+};
+
+}
+}
+}
+
+#endif
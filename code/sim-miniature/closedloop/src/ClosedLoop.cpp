@@ -0,0 +1,273 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <opendavinci/odcore/data/Container.h>
+
+#include <odvdopendlvdata/GeneratedHeaders_ODVDOpenDLVData.h>
+
+#include "ClosedLoop.h"
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+// The robot radius in the scaled units of the simulation, closer to a wall
+// than this counts as a collision.
+const double ClosedLoop::COLLISION_DISTANCE = 1.2;
+
+/*
+  The virtual clock starts at zero and counts in microseconds, the periods
+  of the two modules are derived from their frequencies.
+*/
+ClosedLoop::ClosedLoop(odcore::base::KeyValueConfiguration const &a_kv, 
+    float a_navigationFrequency, float a_simulationFrequency, bool a_debug)
+  : m_bus()
+  , m_navigator(a_debug)
+  , m_kinematics()
+  , m_walls()
+  , m_randomGenerator()
+  , m_noise(0.0, 1.0)
+  , m_positionNoise(0.0)
+  , m_yawNoise(0.0)
+  , m_navigationPeriod(static_cast<int64_t>(1000000 / a_navigationFrequency))
+  , m_simulationPeriod(static_cast<int64_t>(1000000 / a_simulationFrequency))
+  , m_nextNavigation(0)
+  , m_nextSimulation(0)
+  , m_now(0)
+  , m_navigationSteps(0)
+  , m_simulationSteps(0)
+  , m_collisions(0)
+  , m_isColliding(false)
+{
+  // The navigation drives the left wheel with PWM stamp 0 and pins 60 and
+  // 51, and the right wheel with stamp 2 and pins 30 and 31.
+  m_kinematics.SetWiring(0, 60, 51, 2, 30, 31);
+  m_navigator.setUp(a_kv, GetTimeStamp());
+  m_walls = m_navigator.getWalls();
+  m_bus.AddListener(&m_navigator);
+  m_bus.AddListener(&m_kinematics);
+}
+
+ClosedLoop::~ClosedLoop()
+{
+}
+
+/*
+  Advances the virtual clock by the given number of seconds. At each instant
+  the simulation is stepped before the navigation, so that the navigation
+  acts on the latest simulated pose, just as when the modules are scheduled
+  by odsupercomponent.
+*/
+void ClosedLoop::Run(double a_duration)
+{
+  int64_t const end = m_now + static_cast<int64_t>(a_duration * 1000000.0);
+  RunUntil(end, 0);
+}
+
+/*
+  Runs until the navigation has reached the given number of goals, or until
+  the given number of seconds has passed. Returns true if the goals were
+  reached in time.
+*/
+bool ClosedLoop::RunUntilGoals(uint32_t a_goals, double a_timeout)
+{
+  int64_t const end = m_now + static_cast<int64_t>(a_timeout * 1000000.0);
+  return RunUntil(end, a_goals);
+}
+
+/*
+  Places the robot, in the units of the navigation map.
+*/
+void ClosedLoop::SetPose(double a_posX, double a_posY, double a_yaw)
+{
+  m_kinematics.SetPose(a_posX, a_posY, a_yaw);
+}
+
+void ClosedLoop::SetParameters(
+    opendlv::logic::miniature::navigationParameters const &a_parameters)
+{
+  m_navigator.setParameters(a_parameters);
+}
+
+/*
+  Adds zero mean Gaussian noise, with the given standard deviations, to the
+  position and yaw reported by the simulated LPS.
+*/
+void ClosedLoop::SetLpsNoise(double a_positionNoise, double a_yawNoise, 
+    uint32_t a_seed)
+{
+  m_positionNoise = a_positionNoise;
+  m_yawNoise = a_yawNoise;
+  m_randomGenerator.seed(a_seed);
+  m_noise.reset();
+}
+
+/*
+  Steps until the virtual clock reaches the end. A goal count of zero means
+  that the goals are not checked.
+*/
+bool ClosedLoop::RunUntil(int64_t a_end, uint32_t a_goals)
+{
+  while (true) {
+    if (a_goals > 0 && m_navigator.getGoalsReached() >= a_goals) {
+      return true;
+    }
+    bool const isSimulationNext = (m_nextSimulation <= m_nextNavigation);
+    int64_t const next = isSimulationNext ? m_nextSimulation : m_nextNavigation;
+    if (next >= a_end) {
+      break;
+    }
+    m_now = next;
+    m_bus.Deliver(GetTimeStamp());
+    if (isSimulationNext) {
+      StepSimulation();
+      m_nextSimulation += m_simulationPeriod;
+    } else {
+      StepNavigation();
+      m_nextNavigation += m_navigationPeriod;
+    }
+  }
+  m_now = a_end;
+  return false;
+}
+
+opendlv::data::environment::EgoState ClosedLoop::GetEgoState() const
+{
+  return m_kinematics.GetEgoState();
+}
+
+double ClosedLoop::GetSimulatedTime() const
+{
+  return static_cast<double>(m_now) / 1000000.0;
+}
+
+uint64_t ClosedLoop::GetNavigationSteps() const
+{
+  return m_navigationSteps;
+}
+
+uint64_t ClosedLoop::GetSimulationSteps() const
+{
+  return m_simulationSteps;
+}
+
+uint64_t ClosedLoop::GetDeliveredCount() const
+{
+  return m_bus.GetDeliveredCount();
+}
+
+uint32_t ClosedLoop::GetGoalsReached() const
+{
+  return m_navigator.getGoalsReached();
+}
+
+/*
+  The number of times the robot has hit a wall, a robot staying in contact
+  with a wall is counted once.
+*/
+uint32_t ClosedLoop::GetCollisions() const
+{
+  return m_collisions;
+}
+
+std::vector<opendlv::data::environment::Point3> 
+    ClosedLoop::GetPointsOfInterest() const
+{
+  return m_navigator.getPointsOfInterest();
+}
+
+odcore::data::TimeStamp ClosedLoop::GetTimeStamp() const
+{
+  return odcore::data::TimeStamp(static_cast<int32_t>(m_now / 1000000), 
+      static_cast<int32_t>(m_now % 1000000));
+}
+
+void ClosedLoop::StepNavigation()
+{
+  std::vector<odcore::data::Container> containers = 
+      m_navigator.step(GetTimeStamp());
+  for (auto &c : containers) {
+    m_bus.Send(c, GetTimeStamp());
+  }
+  m_navigationSteps++;
+}
+
+void ClosedLoop::StepSimulation()
+{
+  double const deltaTime = static_cast<double>(m_simulationPeriod) / 1000000.0;
+  opendlv::data::environment::EgoState egoState = 
+      m_kinematics.Step(deltaTime);
+  odcore::data::Container c(egoState);
+  m_bus.Send(c, GetTimeStamp());
+
+  bool const isColliding = (GetDistanceToClosestWall() < COLLISION_DISTANCE);
+  if (isColliding && !m_isColliding) {
+    m_collisions++;
+  }
+  m_isColliding = isColliding;
+
+  opendlv::model::State lpsState = m_kinematics.GetLpsState();
+  if (m_positionNoise > 0.0 || m_yawNoise > 0.0) {
+    opendlv::model::Cartesian3 position = lpsState.getPosition();
+    opendlv::model::Cartesian3 orientation = lpsState.getAngularDisplacement();
+    position.setX(static_cast<float>(static_cast<double>(position.getX())
+        + m_positionNoise * m_noise(m_randomGenerator)));
+    position.setY(static_cast<float>(static_cast<double>(position.getY())
+        + m_positionNoise * m_noise(m_randomGenerator)));
+    orientation.setZ(static_cast<float>(static_cast<double>(orientation.getZ())
+        + m_yawNoise * m_noise(m_randomGenerator)));
+    lpsState = opendlv::model::State(position, orientation, 
+        lpsState.getFrameId());
+  }
+  odcore::data::Container lpsContainer(lpsState);
+  m_bus.Send(lpsContainer, GetTimeStamp());
+  m_simulationSteps++;
+}
+
+double ClosedLoop::GetDistanceToClosestWall() const
+{
+  opendlv::data::environment::Point3 const position = 
+      m_kinematics.GetEgoState().getPosition();
+  double closest = INFINITY;
+  for (auto const &wall : m_walls) {
+    opendlv::data::environment::Point3 const a = wall.getA();
+    opendlv::data::environment::Point3 const b = wall.getB();
+    double const dx = b.getX() - a.getX();
+    double const dy = b.getY() - a.getY();
+    double const lengthSquared = dx * dx + dy * dy;
+    double t = 0.0;
+    if (lengthSquared > 0.0) {
+      t = ((position.getX() - a.getX()) * dx 
+          + (position.getY() - a.getY()) * dy) / lengthSquared;
+      t = std::max(0.0, std::min(1.0, t));
+    }
+    double const ex = a.getX() + t * dx - position.getX();
+    double const ey = a.getY() + t * dy - position.getY();
+    closest = std::min(closest, std::sqrt(ex * ex + ey * ey));
+  }
+  return closest;
+}
+
+}
+}
+}
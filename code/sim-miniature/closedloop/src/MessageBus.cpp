@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "MessageBus.h"
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+MessageBus::MessageBus()
+  : m_listeners()
+  , m_queue()
+  , m_delivering()
+  , m_deliveredCount(0)
+{
+}
+
+MessageBus::~MessageBus()
+{
+}
+
+void MessageBus::AddListener(
+    odcore::io::conference::ContainerListener *a_listener)
+{
+  m_listeners.push_back(a_listener);
+}
+
+void MessageBus::Send(odcore::data::Container &a_container, 
+    odcore::data::TimeStamp const &a_now)
+{
+  a_container.setSentTimeStamp(a_now);
+  m_queue.push_back(a_container);
+}
+
+void MessageBus::Deliver(odcore::data::TimeStamp const &a_now)
+{
+  // Listeners may send while being delivered to, those containers are kept
+  // for the next delivery.
+  m_delivering.swap(m_queue);
+  for (auto &container : m_delivering) {
+    container.setReceivedTimeStamp(a_now);
+    for (auto listener : m_listeners) {
+      listener->nextContainer(container);
+    }
+    m_deliveredCount++;
+  }
+  m_delivering.clear();
+}
+
+uint64_t MessageBus::GetDeliveredCount() const
+{
+  return m_deliveredCount;
+}
+
+}
+}
+}
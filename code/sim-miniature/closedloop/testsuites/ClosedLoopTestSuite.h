@@ -0,0 +1,92 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_CLOSEDLOOP_TESTSUITE_H
+#define SIM_MINIATURE_CLOSEDLOOP_TESTSUITE_H
+
+#include <algorithm>
+#include <sstream>
+
+#include "cxxtest/TestSuite.h"
+
+// Include local header files.
+#include "../include/ClosedLoop.h"
+
+class ClosedLoopTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    odcore::base::KeyValueConfiguration getConfiguration() {
+        std::stringstream configuration;
+        configuration 
+            << "logic-miniature-navigation.gpio-pins = 31" << std::endl
+            << "logic-miniature-navigation.pwm-pins = 0,1" << std::endl
+            << "logic-miniature-navigation.outer-walls = " 
+            << "20.0,-10.0;-10.0,-10.0;-10.0,10.0;20.0,10.0;" << std::endl
+            << "logic-miniature-navigation.inner-walls = " 
+            << "5.0,-2.0;5.0,2.0;" << std::endl
+            << "logic-miniature-navigation.points-of-interest = " 
+            << "15.0,5.0;-5.0,-5.0;15.0,-5.0;" << std::endl;
+        odcore::base::KeyValueConfiguration kv;
+        kv.readFrom(configuration);
+        return kv;
+    }
+
+    void testStepsFollowVirtualClock() {
+        opendlv::sim::miniature::ClosedLoop closedLoop(getConfiguration(), 
+            10.0f, 20.0f, false);
+        closedLoop.Run(60.0);
+        TS_ASSERT_EQUALS(closedLoop.GetNavigationSteps(), 600u);
+        TS_ASSERT_EQUALS(closedLoop.GetSimulationSteps(), 1200u);
+        TS_ASSERT_DELTA(closedLoop.GetSimulatedTime(), 60.0, 1e-9);
+    }
+
+    void testReachesPointOfInterest() {
+        opendlv::sim::miniature::ClosedLoop closedLoop(getConfiguration(), 
+            10.0f, 20.0f, false);
+        TS_ASSERT(closedLoop.RunUntilGoals(1, 300.0));
+        TS_ASSERT_EQUALS(closedLoop.GetGoalsReached(), 1u);
+
+        opendlv::data::environment::Point3 const position = 
+            closedLoop.GetEgoState().getPosition();
+        double closest = 1e9;
+        for (auto const &pointOfInterest : closedLoop.GetPointsOfInterest()) {
+            closest = std::min(closest, pointOfInterest.getDistanceTo(position));
+        }
+        // The goal is the end of the planned path, the map node closest to
+        // the point of interest, reached within the goal tolerance of 3.
+        TS_ASSERT_LESS_THAN(closest, 5.0);
+    }
+
+    void testDeterministic() {
+        opendlv::sim::miniature::ClosedLoop closedLoop1(getConfiguration(), 
+            10.0f, 20.0f, false);
+        opendlv::sim::miniature::ClosedLoop closedLoop2(getConfiguration(), 
+            10.0f, 20.0f, false);
+        closedLoop1.Run(60.0);
+        closedLoop2.Run(60.0);
+        TS_ASSERT_EQUALS(closedLoop1.GetEgoState().toString(), 
+            closedLoop2.GetEgoState().toString());
+        TS_ASSERT_EQUALS(closedLoop1.GetDeliveredCount(), 
+            closedLoop2.GetDeliveredCount());
+    }
+};
+
+#endif
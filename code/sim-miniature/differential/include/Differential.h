@@ -27,7 +27,8 @@
 #include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
 
 #include <automotivedata/GeneratedHeaders_AutomotiveData.h>
-#include <opendlv/data/environment/EgoState.h>
+
+#include "DifferentialKinematics.h"
 
 namespace opendlv {
 namespace sim {
@@ -46,21 +47,13 @@ class Differential :
   virtual void setUp();
   virtual void tearDown();
   odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
-  void ConvertPwmToWheelAngularVelocity(uint16_t, uint32_t);
   void ConvertBoardDataToSensorReading(
     automotive::miniature::SensorBoardData const &);
-  void SetMotorControl(uint16_t, bool);
 
   odcore::base::Mutex m_mutex;
-  opendlv::data::environment::EgoState m_currentEgoState;
+  DifferentialKinematics m_kinematics;
   bool m_debug;
-  bool m_gpioInA;
-  bool m_gpioInB;
-  bool m_gpioInC;
-  bool m_gpioInD;
   double m_deltaTime;
-  double m_leftWheelAngularVelocity;
-  double m_rightWheelAngularVelocity;
   double m_globalTime;
 };
 
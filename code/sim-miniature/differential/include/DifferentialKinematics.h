@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_DIFFERENTIALKINEMATICS_H
+#define SIM_MINIATURE_DIFFERENTIALKINEMATICS_H
+
+#include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/io/conference/ContainerListener.h>
+
+#include <odvdopendlvdata/GeneratedHeaders_ODVDOpenDLVData.h>
+#include <opendlv/data/environment/EgoState.h>
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+/**
+ * Kinematics of the differential drive robot. The motor requests are given
+ * as containers and Step integrates the pose over the given time step. It
+ * has no conference or clock of its own, so it can be stepped by the module
+ * or directly by an in-process simulation.
+ */
+class DifferentialKinematics : 
+  public odcore::io::conference::ContainerListener {
+ public:
+  DifferentialKinematics();
+  DifferentialKinematics(DifferentialKinematics const &) = delete;
+  DifferentialKinematics &operator=(DifferentialKinematics const &) = delete;
+  virtual ~DifferentialKinematics();
+  virtual void nextContainer(odcore::data::Container &);
+  opendlv::data::environment::EgoState Step(double);
+  opendlv::data::environment::EgoState GetEgoState() const;
+  opendlv::model::State GetLpsState() const;
+  void SetPose(double, double, double);
+  void SetWiring(uint32_t, uint16_t, uint16_t, uint32_t, uint16_t, uint16_t);
+  void ConvertPwmToWheelAngularVelocity(uint32_t, uint32_t);
+  void SetMotorControl(uint16_t, bool);
+
+ private:
+  opendlv::data::environment::EgoState m_currentEgoState;
+  uint32_t m_leftSenderStamp;
+  uint16_t m_leftForwardPin;
+  uint16_t m_leftReversePin;
+  uint32_t m_rightSenderStamp;
+  uint16_t m_rightForwardPin;
+  uint16_t m_rightReversePin;
+  bool m_isLeftForward;
+  bool m_isLeftReverse;
+  bool m_isRightForward;
+  bool m_isRightReverse;
+  double m_leftWheelAngularVelocity;
+  double m_rightWheelAngularVelocity;
+};
+
+}
+}
+}
+
+#endif
@@ -32,12 +32,6 @@
 
 #include "Differential.h"
 
-#define ROBOT_RADIUS 0.12
-#define WHEEL_RADIUS 0.06
-#define VELOCITY_0 0.5
-#define TIME_1 3
-#define TIME_2 10
-
 namespace opendlv {
 namespace sim {
 namespace miniature {
@@ -46,15 +40,9 @@ Differential::Differential(const int &argc, char **argv)
   : TimeTriggeredConferenceClientModule(
       argc, argv, "sim-miniature-differential")
   , m_mutex()
-  , m_currentEgoState()
+  , m_kinematics()
   , m_debug()
-  , m_gpioInA(false)
-  , m_gpioInB(false)
-  , m_gpioInC(false)
-  , m_gpioInD(false)
   , m_deltaTime()
-  , m_leftWheelAngularVelocity(0.0)
-  , m_rightWheelAngularVelocity(0.0)
   , m_globalTime()
 {
 }
@@ -78,9 +66,7 @@ void Differential::nextContainer(odcore::data::Container &a_c)
     ConvertBoardDataToSensorReading(sensorBoardData);
   } else if (dataType == opendlv::proxy::ToggleRequest::ID()) {
     auto request = a_c.getData<opendlv::proxy::ToggleRequest>();
-    uint16_t pin = request.getPin();
-    bool state = (request.getState() == opendlv::proxy::ToggleRequest::ToggleState::On);
-    SetMotorControl(pin, state);
+    m_kinematics.nextContainer(a_c);
     if (m_debug) {
       std::cout << "[" << getName() << "] Received a ToggleRequest: "
           << request.toString() << "." << std::endl;
@@ -91,9 +77,7 @@ void Differential::nextContainer(odcore::data::Container &a_c)
       std::cout << "[" << getName() << "] Received a PwmRequest: "
           << request.toString() << "." << std::endl;
     }
-    uint16_t senderStamp = a_c.getSenderStamp();
-    uint32_t dutyCycleNs = request.getDutyCycleNs();
-    ConvertPwmToWheelAngularVelocity(senderStamp, dutyCycleNs);
+    m_kinematics.nextContainer(a_c);
   }
 }
 
@@ -122,93 +106,23 @@ odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode Differential::body()
   
     odcore::base::Lock l(m_mutex);
   
-    opendlv::data::environment::Point3 prevPosition = 
-      m_currentEgoState.getPosition();
-    opendlv::data::environment::Point3 prevRotation = 
-      m_currentEgoState.getRotation();
-    opendlv::data::environment::Point3 prevVelocity = 
-      m_currentEgoState.getVelocity();
-
-    double prevVelX = prevVelocity.getX();
-    double prevVelY = prevVelocity.getY();
-    
-    // The division is needed due to a scaling problem, in order to convert into
-    // meters. In your code below, everything will be meters.
-    double prevPosX = prevPosition.getX() / 10.0;
-    double prevPosY = prevPosition.getY() / 10.0;
-
-    double prevYaw = atan2(prevRotation.getY(), prevRotation.getX());
-    // NOTE: Do not change the code above.
-
-
-
-
-    ///// TODO: Add kinematic equations below. Use the prepared class global
-    ///// variables for wheel speeds (already saved, see the below method).
-
-    double velX = 0.0; // Placeholder.
-    double velY = 0.0; // Placeholder.
-    double yawRate = 0.0; // Placeholder.
-    double velL = m_leftWheelAngularVelocity*WHEEL_RADIUS;
-    double velR = m_rightWheelAngularVelocity*WHEEL_RADIUS;
-
+    opendlv::data::environment::EgoState egoState = 
+        m_kinematics.Step(m_deltaTime);
 
+    opendlv::data::environment::Point3 position = egoState.getPosition();
+    opendlv::data::environment::Point3 rotation = egoState.getRotation();
+    double yaw = atan2(rotation.getY(), rotation.getX());
 
-    velX = (velL+velR)/(2)*cos(prevYaw);
-    velY = (velL+velR)/(2)*sin(prevYaw);
-    yawRate = -(velL-velR)/(2*ROBOT_RADIUS);
-
-
-    ///// TODO: Integrate simulation below. The time step is already saved in
-    ///// a global variable.
-
-    double posX = prevPosX + velX*m_deltaTime; // Placeholder.
-    double posY = prevPosY + velY*m_deltaTime; // Placeholder.
-    double yaw = prevYaw + yawRate*m_deltaTime; // Placeholder.
-    
-    //std::cout << "TODO: Integrate simulation." << std::endl;
-    ///// Integration above.
-
-    std::cout << "PosX: " << posX << " Pos Y: " << posY << " Yaw: " << yaw << std::endl;
+    std::cout << "PosX: " << position.getX() / 10.0 << " Pos Y: " 
+        << position.getY() / 10.0 << " Yaw: " << yaw << std::endl;
 
     m_globalTime = m_globalTime + m_deltaTime;
 
-
-    
-
-    // Due to a simulation scaling problem, the position is scaled. 
-    // NOTE: Do not change the code below.
-    posX = posX * 10.0;
-    posY = posY * 10.0;
-
-    double posZ = 0.0;
-    double velZ = 0.0;
-    double accZ = 0.0;
-
-    double accX = (velX - prevVelX) / m_deltaTime;
-    double accY = (velY - prevVelY) / m_deltaTime;
-
-    opendlv::data::environment::Point3 position(posX, posY, posZ);
-    opendlv::data::environment::Point3 rotation(1.0, 0.0, 0.0);
-    opendlv::data::environment::Point3 velocity(velX, velY, velZ);
-    opendlv::data::environment::Point3 acceleration(accX, accY, accZ);
-
-
-    rotation.rotateZ(yaw);
-    rotation.normalize();
-
-    opendlv::data::environment::EgoState egoState(position, rotation, velocity,
-        acceleration);
-
-    m_currentEgoState = egoState;
-
     odcore::data::Container c(egoState);
     getConference().send(c);
 
     // Simulate LPS.
-    opendlv::model::Cartesian3 lpsPosition(static_cast<float>(posX), static_cast<float>(posY), 0.0f);
-    opendlv::model::Cartesian3 lpsOrientation(0.0f, 0.0f, static_cast<float>(yaw));
-    opendlv::model::State lpsState(lpsPosition, lpsOrientation, 0);
+    opendlv::model::State lpsState = m_kinematics.GetLpsState();
     odcore::data::Container lpsContainer(lpsState);
     getConference().send(lpsContainer);
   }
@@ -216,44 +130,6 @@ odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode Differential::body()
   return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
 }
 
-void Differential::ConvertPwmToWheelAngularVelocity(uint16_t a_senderStamp, 
-    uint32_t a_dutyCycleNs)
-{
-  int32_t const minDutyCycleNs = 25000; 
-  int32_t const maxDutyCycleNs = 50000; 
-
-  double const maxAngularVelocity = 10.0;
-
-  a_dutyCycleNs = (a_dutyCycleNs < minDutyCycleNs) ? minDutyCycleNs : a_dutyCycleNs; 
-  a_dutyCycleNs = (a_dutyCycleNs > maxDutyCycleNs) ? maxDutyCycleNs : a_dutyCycleNs; 
-  
-  double wheelAngularVelocity = maxAngularVelocity * 
-    (a_dutyCycleNs - minDutyCycleNs) / 
-    static_cast<double>(maxDutyCycleNs - minDutyCycleNs); 
-      
-  if (a_senderStamp == 1) {
-    if (m_gpioInA && !m_gpioInB) {
-      // Clockwise
-      m_leftWheelAngularVelocity = -wheelAngularVelocity;
-    } else if (!m_gpioInA && m_gpioInB) {
-      // Counter clockwise
-      m_leftWheelAngularVelocity = wheelAngularVelocity;
-    } else {
-      m_leftWheelAngularVelocity = 0.0;
-    }
-  } else if (a_senderStamp == 2) {
-    if (m_gpioInC && !m_gpioInD) {
-      // Clockwise
-      m_rightWheelAngularVelocity = wheelAngularVelocity;
-    } else if (!m_gpioInC && m_gpioInD) {
-      // Counter clockwise
-      m_rightWheelAngularVelocity = -wheelAngularVelocity;
-    } else {
-      m_rightWheelAngularVelocity = 0.0f;
-    }
-  }
-}
-
 void Differential::ConvertBoardDataToSensorReading(
   automotive::miniature::SensorBoardData const &a_sensorBoardData)
 {
@@ -281,35 +157,6 @@ void Differential::ConvertBoardDataToSensorReading(
   }
 }
 
-void Differential::SetMotorControl(uint16_t a_pin, bool a_state)
-{
-  switch (a_pin) {
-    case 30:
-      {
-        m_gpioInB = a_state;
-        break;
-      }
-    case 31:
-      {
-        m_gpioInA = a_state;
-        break;
-      }
-    case 60:
-      {
-        m_gpioInC = a_state;
-        break;
-      }
-    case 51:
-      {
-        m_gpioInD = a_state;
-        break;
-      }
-    default:
-      {
-      }
-  }
-}
-
 }
 }
 } 
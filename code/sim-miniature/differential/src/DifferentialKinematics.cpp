@@ -0,0 +1,266 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <math.h>
+
+#include <opendlv/data/environment/Point3.h>
+
+#include <odvdminiature/GeneratedHeaders_ODVDMiniature.h>
+
+#include "DifferentialKinematics.h"
+
+#define ROBOT_RADIUS 0.12
+#define WHEEL_RADIUS 0.06
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+DifferentialKinematics::DifferentialKinematics()
+  : m_currentEgoState()
+  , m_leftSenderStamp(1)
+  , m_leftForwardPin(30)
+  , m_leftReversePin(31)
+  , m_rightSenderStamp(2)
+  , m_rightForwardPin(60)
+  , m_rightReversePin(51)
+  , m_isLeftForward(false)
+  , m_isLeftReverse(false)
+  , m_isRightForward(false)
+  , m_isRightReverse(false)
+  , m_leftWheelAngularVelocity(0.0)
+  , m_rightWheelAngularVelocity(0.0)
+{
+}
+
+DifferentialKinematics::~DifferentialKinematics()
+{
+}
+
+void DifferentialKinematics::nextContainer(odcore::data::Container &a_c)
+{
+  int32_t dataType = a_c.getDataType();
+  if (dataType == opendlv::proxy::ToggleRequest::ID()) {
+    auto request = a_c.getData<opendlv::proxy::ToggleRequest>();
+    uint16_t pin = request.getPin();
+    bool state = (request.getState() == opendlv::proxy::ToggleRequest::ToggleState::On);
+    SetMotorControl(pin, state);
+  } else if (dataType == opendlv::proxy::PwmRequest::ID()) {
+    auto request = a_c.getData<opendlv::proxy::PwmRequest>();
+    uint32_t senderStamp = a_c.getSenderStamp();
+    uint32_t dutyCycleNs = request.getDutyCycleNs();
+    ConvertPwmToWheelAngularVelocity(senderStamp, dutyCycleNs);
+  }
+}
+
+opendlv::data::environment::EgoState DifferentialKinematics::Step(
+    double a_deltaTime)
+{
+  opendlv::data::environment::Point3 prevPosition = 
+    m_currentEgoState.getPosition();
+  opendlv::data::environment::Point3 prevRotation = 
+    m_currentEgoState.getRotation();
+  opendlv::data::environment::Point3 prevVelocity = 
+    m_currentEgoState.getVelocity();
+
+  double prevVelX = prevVelocity.getX();
+  double prevVelY = prevVelocity.getY();
+  
+  // The division is needed due to a scaling problem, in order to convert into
+  // meters. In your code below, everything will be meters.
+  double prevPosX = prevPosition.getX() / 10.0;
+  double prevPosY = prevPosition.getY() / 10.0;
+
+  double prevYaw = atan2(prevRotation.getY(), prevRotation.getX());
+  // NOTE: Do not change the code above.
+
+
+
+
+  ///// TODO: Add kinematic equations below. Use the prepared class global
+  ///// variables for wheel speeds (already saved, see the below method).
+
+  double velX = 0.0; // Placeholder.
+  double velY = 0.0; // Placeholder.
+  double yawRate = 0.0; // Placeholder.
+  double velL = m_leftWheelAngularVelocity*WHEEL_RADIUS;
+  double velR = m_rightWheelAngularVelocity*WHEEL_RADIUS;
+
+
+
+  velX = (velL+velR)/(2)*cos(prevYaw);
+  velY = (velL+velR)/(2)*sin(prevYaw);
+  yawRate = -(velL-velR)/(2*ROBOT_RADIUS);
+
+
+  ///// TODO: Integrate simulation below. The time step is already saved in
+  ///// a global variable.
+
+  double posX = prevPosX + velX*a_deltaTime; // Placeholder.
+  double posY = prevPosY + velY*a_deltaTime; // Placeholder.
+  double yaw = prevYaw + yawRate*a_deltaTime; // Placeholder.
+  
+  //std::cout << "TODO: Integrate simulation." << std::endl;
+  ///// Integration above.
+
+
+  // Due to a simulation scaling problem, the position is scaled. 
+  // NOTE: Do not change the code below.
+  posX = posX * 10.0;
+  posY = posY * 10.0;
+
+  double posZ = 0.0;
+  double velZ = 0.0;
+  double accZ = 0.0;
+
+  double accX = (velX - prevVelX) / a_deltaTime;
+  double accY = (velY - prevVelY) / a_deltaTime;
+
+  opendlv::data::environment::Point3 position(posX, posY, posZ);
+  opendlv::data::environment::Point3 rotation(1.0, 0.0, 0.0);
+  opendlv::data::environment::Point3 velocity(velX, velY, velZ);
+  opendlv::data::environment::Point3 acceleration(accX, accY, accZ);
+
+
+  rotation.rotateZ(yaw);
+  rotation.normalize();
+
+  opendlv::data::environment::EgoState egoState(position, rotation, velocity,
+      acceleration);
+
+  m_currentEgoState = egoState;
+
+  return egoState;
+}
+
+opendlv::data::environment::EgoState DifferentialKinematics::GetEgoState() 
+    const
+{
+  return m_currentEgoState;
+}
+
+/**
+ * The simulated LPS, that is the pose of the robot as reported by the
+ * motion capture system.
+ */
+opendlv::model::State DifferentialKinematics::GetLpsState() const
+{
+  opendlv::data::environment::Point3 position = 
+    m_currentEgoState.getPosition();
+  opendlv::data::environment::Point3 rotation = 
+    m_currentEgoState.getRotation();
+  double yaw = atan2(rotation.getY(), rotation.getX());
+
+  opendlv::model::Cartesian3 lpsPosition(static_cast<float>(position.getX()), 
+      static_cast<float>(position.getY()), 0.0f);
+  opendlv::model::Cartesian3 lpsOrientation(0.0f, 0.0f, 
+      static_cast<float>(yaw));
+  opendlv::model::State lpsState(lpsPosition, lpsOrientation, 0);
+  return lpsState;
+}
+
+/**
+ * Places the robot at the given position, in the same scaled units as the
+ * output, with the given yaw and at rest.
+ */
+void DifferentialKinematics::SetPose(double a_posX, double a_posY, 
+    double a_yaw)
+{
+  opendlv::data::environment::Point3 position(a_posX, a_posY, 0.0);
+  opendlv::data::environment::Point3 rotation(1.0, 0.0, 0.0);
+  rotation.rotateZ(a_yaw);
+  rotation.normalize();
+  opendlv::data::environment::Point3 velocity;
+  opendlv::data::environment::Point3 acceleration;
+
+  m_currentEgoState = opendlv::data::environment::EgoState(position, rotation, 
+      velocity, acceleration);
+}
+
+/**
+ * Sets which PWM sender stamp drives each wheel, and which GPIO pins turn
+ * the wheel forward and in reverse. By default the left wheel is stamp 1 on
+ * pins 30 and 31, and the right wheel is stamp 2 on pins 60 and 51.
+ */
+void DifferentialKinematics::SetWiring(uint32_t a_leftSenderStamp, 
+    uint16_t a_leftForwardPin, uint16_t a_leftReversePin, 
+    uint32_t a_rightSenderStamp, uint16_t a_rightForwardPin, 
+    uint16_t a_rightReversePin)
+{
+  m_leftSenderStamp = a_leftSenderStamp;
+  m_leftForwardPin = a_leftForwardPin;
+  m_leftReversePin = a_leftReversePin;
+  m_rightSenderStamp = a_rightSenderStamp;
+  m_rightForwardPin = a_rightForwardPin;
+  m_rightReversePin = a_rightReversePin;
+  m_isLeftForward = false;
+  m_isLeftReverse = false;
+  m_isRightForward = false;
+  m_isRightReverse = false;
+}
+
+void DifferentialKinematics::ConvertPwmToWheelAngularVelocity(
+    uint32_t a_senderStamp, uint32_t a_dutyCycleNs)
+{
+  uint32_t const minDutyCycleNs = 25000; 
+  uint32_t const maxDutyCycleNs = 50000; 
+
+  double const maxAngularVelocity = 10.0;
+
+  a_dutyCycleNs = (a_dutyCycleNs < minDutyCycleNs) ? minDutyCycleNs : a_dutyCycleNs; 
+  a_dutyCycleNs = (a_dutyCycleNs > maxDutyCycleNs) ? maxDutyCycleNs : a_dutyCycleNs; 
+  
+  double wheelAngularVelocity = maxAngularVelocity * 
+    (a_dutyCycleNs - minDutyCycleNs) / 
+    static_cast<double>(maxDutyCycleNs - minDutyCycleNs); 
+      
+  if (a_senderStamp == m_leftSenderStamp) {
+    if (m_isLeftForward && !m_isLeftReverse) {
+      m_leftWheelAngularVelocity = wheelAngularVelocity;
+    } else if (!m_isLeftForward && m_isLeftReverse) {
+      m_leftWheelAngularVelocity = -wheelAngularVelocity;
+    } else {
+      m_leftWheelAngularVelocity = 0.0;
+    }
+  } else if (a_senderStamp == m_rightSenderStamp) {
+    if (m_isRightForward && !m_isRightReverse) {
+      m_rightWheelAngularVelocity = wheelAngularVelocity;
+    } else if (!m_isRightForward && m_isRightReverse) {
+      m_rightWheelAngularVelocity = -wheelAngularVelocity;
+    } else {
+      m_rightWheelAngularVelocity = 0.0;
+    }
+  }
+}
+
+void DifferentialKinematics::SetMotorControl(uint16_t a_pin, bool a_state)
+{
+  if (a_pin == m_leftForwardPin) {
+    m_isLeftForward = a_state;
+  } else if (a_pin == m_leftReversePin) {
+    m_isLeftReverse = a_state;
+  } else if (a_pin == m_rightForwardPin) {
+    m_isRightForward = a_state;
+  } else if (a_pin == m_rightReversePin) {
+    m_isRightReverse = a_state;
+  }
+}
+
+}
+}
+} 
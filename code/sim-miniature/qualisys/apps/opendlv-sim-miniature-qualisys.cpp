@@ -0,0 +1,182 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/strings/StringToolbox.h>
+
+#include "QtmScene.h"
+#include "QtmServer.h"
+
+static opendlv::sim::miniature::QtmServer *g_server = nullptr;
+
+static void StopServer(int32_t)
+{
+  if (g_server != nullptr) {
+    g_server->Stop();
+  }
+}
+
+static std::vector<float> ReadValueList(std::string const &a_values, 
+    char a_delimiter)
+{
+  std::vector<float> values;
+  std::vector<std::string> valueStrings = 
+      odcore::strings::StringToolbox::split(a_values, a_delimiter);
+  for (auto const &value : valueStrings) {
+    std::vector<std::string> const coordinates = 
+        odcore::strings::StringToolbox::split(value, ',');
+    for (auto const &coordinate : coordinates) {
+      values.push_back(std::stof(coordinate));
+    }
+  }
+  return values;
+}
+
+/**
+ * Reads the markers of the bodies as the LPS does, from 'bodies' and
+ * 'body<frameId>.markers', or from the forward and leftward markers of a
+ * single body.
+ */
+static std::vector<std::vector<float>> ReadBodies(
+    odcore::base::KeyValueConfiguration const &a_kv, 
+    std::string const &a_prefix)
+{
+  std::vector<std::vector<float>> bodies;
+  bool hasBodies = false;
+  std::string const bodiesString = a_kv.getOptionalValue<std::string>(
+      a_prefix + ".bodies", hasBodies);
+  if (hasBodies) {
+    for (auto const &frameId : 
+        odcore::strings::StringToolbox::split(bodiesString, ',')) {
+      bodies.push_back(ReadValueList(a_kv.getValue<std::string>(
+          a_prefix + ".body" + frameId + ".markers"), ';'));
+    }
+    return bodies;
+  }
+  bodies.push_back(ReadValueList(
+      a_kv.getValue<std::string>(a_prefix + ".forwardMarker") + ";" 
+      + a_kv.getValue<std::string>(a_prefix + ".leftwardMarker"), ';'));
+  return bodies;
+}
+
+int32_t main(int32_t argc, char **argv) {
+  std::string configuration;
+  std::string prefix = "proxy-miniature-lps";
+  uint16_t port = 22223;
+  float cameraFrequency = 100.0f;
+  uint32_t seed = 0;
+  float noise = 0.0f;
+  float dropout = 0.0f;
+  float ghosts = 0.0f;
+  std::vector<float> arena = {-5.0f, -5.0f, 5.0f, 5.0f};
+  std::vector<std::string> trajectories;
+
+  for (int32_t i = 1; i < argc; i++) {
+    std::string const argument(argv[i]);
+    std::string const key = argument.substr(0, argument.find('='));
+    std::string const value = argument.substr(argument.find('=') + 1);
+    if (key == "--configuration") {
+      configuration = value;
+    } else if (key == "--prefix") {
+      prefix = value;
+    } else if (key == "--port") {
+      port = static_cast<uint16_t>(std::stoul(value));
+    } else if (key == "--camera-freq") {
+      cameraFrequency = std::stof(value);
+    } else if (key == "--seed") {
+      seed = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "--noise") {
+      noise = std::stof(value);
+    } else if (key == "--dropout") {
+      dropout = std::stof(value);
+    } else if (key == "--ghosts") {
+      ghosts = std::stof(value);
+    } else if (key == "--arena") {
+      arena = ReadValueList(value, ';');
+    } else if (key == "--trajectory") {
+      trajectories.push_back(value);
+    } else {
+      std::cerr << "Unknown argument: " << argument << std::endl;
+      return 1;
+    }
+  }
+
+  // Without a configuration there is one body with the markers of the
+  // miniature vehicles.
+  std::vector<std::vector<float>> bodies = {{0.149f, 0.0f, 0.0f, 
+      0.0f, 0.095f, 0.0f}};
+  if (!configuration.empty()) {
+    std::ifstream file(configuration);
+    if (!file.is_open()) {
+      std::cerr << "Could not open " << configuration << "." << std::endl;
+      return 1;
+    }
+    odcore::base::KeyValueConfiguration kv;
+    kv.readFrom(file);
+    bodies = ReadBodies(kv, prefix);
+  }
+  if (arena.size() != 4) {
+    std::cerr << "The arena is given as xmin,ymin,xmax,ymax." << std::endl;
+    return 1;
+  }
+
+  // Bodies without a trajectory of their own stand still next to each other.
+  opendlv::sim::miniature::QtmScene scene(seed);
+  scene.SetNoise(noise);
+  scene.SetDropout(dropout);
+  scene.SetGhosts(ghosts, arena[0], arena[1], arena[2], arena[3]);
+  for (uint32_t i = 0; i < bodies.size(); i++) {
+    opendlv::sim::miniature::trajectory path;
+    path.parameters[0] = static_cast<double>(i);
+    try {
+      if (i < trajectories.size()) {
+        path = opendlv::sim::miniature::QtmScene::ReadTrajectory(
+            trajectories[i]);
+      }
+    } catch (std::exception const &exception) {
+      std::cerr << exception.what() << std::endl;
+      return 1;
+    }
+    scene.AddBody(bodies[i], path);
+  }
+
+  opendlv::sim::miniature::QtmServer server(scene, cameraFrequency);
+  try {
+    server.Open(port);
+  } catch (std::exception const &exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+  g_server = &server;
+  std::signal(SIGINT, StopServer);
+  std::signal(SIGTERM, StopServer);
+
+  std::cout << "Simulating QTM with " << scene.GetBodyCount() << " bodies and " 
+      << scene.GetMarkerCount() << " markers at " << cameraFrequency 
+      << " Hz on port " << server.GetPort() << "." << std::endl;
+  server.Serve();
+  g_server = nullptr;
+  return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_QTMSCENE_H
+#define SIM_MINIATURE_QTMSCENE_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+/**
+ * A scripted path of a rigid body in the plane, given as a type and its
+ * parameters in meters and seconds:
+ * 'static,x,y,yaw', 'circle,cx,cy,radius,period', 'line,x0,y0,x1,y1,period'
+ * going back and forth, or 'figure8,cx,cy,size,period'.
+ */
+struct trajectory {
+  trajectory();
+  std::string type;
+  std::vector<double> parameters;
+};
+
+/**
+ * A simulated motion capture scene of rigid bodies following scripted
+ * trajectories, written as QTM RT data packets. The markers get Gaussian
+ * noise, each marker is missed in a frame with a probability, and ghost
+ * markers appear at random in the arena. The labelled components keep the
+ * markers of the bodies in order, with missed markers as NaN, while the
+ * unlabelled ones list the seen markers and the ghosts shuffled. The label
+ * of a marker is its index over all bodies.
+ */
+class QtmScene {
+ public:
+  QtmScene(uint32_t);
+  QtmScene(QtmScene const &) = delete;
+  QtmScene &operator=(QtmScene const &) = delete;
+  virtual ~QtmScene();
+  void AddBody(std::vector<float> const &, trajectory const &);
+  void SetNoise(float);
+  void SetDropout(float);
+  void SetGhosts(float, float, float, float, float);
+  uint32_t GetBodyCount() const;
+  uint32_t GetMarkerCount() const;
+  void GetPose(uint32_t, double, float &, float &, float &) const;
+  void WritePacket(double, uint32_t, std::vector<int32_t> const &, 
+      std::vector<uint8_t> &);
+
+  static int32_t GetComponentType(std::string const &);
+  static trajectory ReadTrajectory(std::string const &);
+
+ private:
+  void Observe(double);
+  void WriteMarkers(int32_t, std::vector<uint8_t> &) const;
+  void WriteBodies(int32_t, std::vector<uint8_t> &) const;
+
+  std::vector<std::vector<float>> m_bodies;
+  std::vector<trajectory> m_trajectories;
+  float m_noise;
+  float m_dropout;
+  float m_ghostCount;
+  float m_arena[4];
+  std::mt19937 m_generator;
+  std::vector<float> m_markers;
+  std::vector<uint8_t> m_seen;
+  std::vector<float> m_ghosts;
+  std::vector<uint32_t> m_order;
+  std::vector<float> m_poses;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_QTMSERVER_H
+#define SIM_MINIATURE_QTMSERVER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include "QtmScene.h"
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+/**
+ * A stand-in for the QTM RT server. It serves one client at a time on the
+ * TCP control port, answering Version, ByteOrder, GetState, GetParameters
+ * General and StreamFrames, and streams the frames of the scene over UDP
+ * from a thread of its own, paced by a steady clock, at up to the camera
+ * frequency.
+ */
+class QtmServer {
+ public:
+  QtmServer(QtmScene &, float);
+  QtmServer(QtmServer const &) = delete;
+  QtmServer &operator=(QtmServer const &) = delete;
+  virtual ~QtmServer();
+  void Open(uint16_t);
+  uint16_t GetPort() const;
+  void Serve();
+  void Stop();
+  uint64_t GetFrameCount() const;
+
+ private:
+  void ServeClient(int, struct sockaddr_in const &);
+  void Reply(int, std::string const &, struct sockaddr_in const &);
+  void StartStream(std::string const &, struct sockaddr_in const &, 
+      std::string &);
+  void StopStream();
+  void Stream(float, struct sockaddr_in);
+  void Send(int, int32_t, std::string const &) const;
+
+  QtmScene &m_scene;
+  float m_cameraFrequency;
+  int m_listener;
+  int m_sender;
+  std::atomic<bool> m_isRunning;
+  std::atomic<bool> m_isStreaming;
+  std::thread m_streamer;
+  std::vector<int32_t> m_components;
+  std::atomic<uint64_t> m_frameCount;
+};
+
+}
+}
+}
+
+#endif
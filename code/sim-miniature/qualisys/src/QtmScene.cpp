@@ -0,0 +1,398 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "QtmScene.h"
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+// The packets are written in the byte order of the host, which is little
+// endian on the platforms the simulator runs on, as QTM replies to ByteOrder.
+template <typename T>
+static void Append(std::vector<uint8_t> &a_bytes, T a_value)
+{
+  std::size_t const size = a_bytes.size();
+  a_bytes.resize(size + sizeof(T));
+  std::memcpy(&a_bytes[size], &a_value, sizeof(T));
+}
+
+template <typename T>
+static void Patch(std::vector<uint8_t> &a_bytes, std::size_t a_offset, 
+    T a_value)
+{
+  std::memcpy(&a_bytes[a_offset], &a_value, sizeof(T));
+}
+
+trajectory::trajectory()
+  : type("static")
+  , parameters(3, 0.0)
+{
+}
+
+/**
+ * The random numbers are drawn from a generator seeded with the given seed,
+ * so that a scene is the same every run.
+ */
+QtmScene::QtmScene(uint32_t a_seed)
+  : m_bodies()
+  , m_trajectories()
+  , m_noise(0.0f)
+  , m_dropout(0.0f)
+  , m_ghostCount(0.0f)
+  , m_arena()
+  , m_generator(a_seed)
+  , m_markers()
+  , m_seen()
+  , m_ghosts()
+  , m_order()
+  , m_poses()
+{
+}
+
+QtmScene::~QtmScene()
+{
+}
+
+/**
+ * Adds a body with the given markers as 'x,y,z,x,y,z,..' relative to its
+ * origo marker, as in the LPS configuration. The origo marker is added
+ * first.
+ */
+void QtmScene::AddBody(std::vector<float> const &a_markers, 
+    trajectory const &a_trajectory)
+{
+  std::vector<float> markers = {0.0f, 0.0f, 0.0f};
+  markers.insert(markers.end(), a_markers.begin(), a_markers.end());
+  m_bodies.push_back(markers);
+  m_trajectories.push_back(a_trajectory);
+}
+
+/**
+ * Sets the standard deviation of the noise of every marker coordinate, in
+ * meters.
+ */
+void QtmScene::SetNoise(float a_noise)
+{
+  m_noise = a_noise;
+}
+
+/**
+ * Sets the probability that a marker is not seen in a frame.
+ */
+void QtmScene::SetDropout(float a_dropout)
+{
+  m_dropout = a_dropout;
+}
+
+/**
+ * Sets the mean number of ghost markers in a frame, and the arena as
+ * 'xmin,ymin,xmax,ymax' they appear in.
+ */
+void QtmScene::SetGhosts(float a_ghostCount, float a_xMin, float a_yMin, 
+    float a_xMax, float a_yMax)
+{
+  m_ghostCount = a_ghostCount;
+  m_arena[0] = a_xMin;
+  m_arena[1] = a_yMin;
+  m_arena[2] = a_xMax;
+  m_arena[3] = a_yMax;
+}
+
+uint32_t QtmScene::GetBodyCount() const
+{
+  return static_cast<uint32_t>(m_bodies.size());
+}
+
+/**
+ * The number of markers of all bodies, which is the number of labels.
+ */
+uint32_t QtmScene::GetMarkerCount() const
+{
+  uint32_t count = 0;
+  for (auto const &body : m_bodies) {
+    count += static_cast<uint32_t>(body.size() / 3);
+  }
+  return count;
+}
+
+/**
+ * The true pose of a body at the given time, with the yaw along the path.
+ */
+void QtmScene::GetPose(uint32_t a_body, double a_time, float &a_x, 
+    float &a_y, float &a_yaw) const
+{
+  trajectory const &path = m_trajectories[a_body];
+  std::vector<double> const &p = path.parameters;
+  double const pi = 3.14159265358979323846;
+  if (path.type == "circle") {
+    double const angle = 2.0 * pi * a_time / p[3];
+    a_x = static_cast<float>(p[0] + p[2] * std::cos(angle));
+    a_y = static_cast<float>(p[1] + p[2] * std::sin(angle));
+    a_yaw = static_cast<float>(std::remainder(angle + pi / 2.0, 2.0 * pi));
+  } else if (path.type == "line") {
+    double const phase = std::fmod(a_time / p[4], 1.0);
+    double const share = (phase < 0.5) ? 2.0 * phase : 2.0 - 2.0 * phase;
+    a_x = static_cast<float>(p[0] + share * (p[2] - p[0]));
+    a_y = static_cast<float>(p[1] + share * (p[3] - p[1]));
+    double const yaw = std::atan2(p[3] - p[1], p[2] - p[0]);
+    a_yaw = static_cast<float>((phase < 0.5) ? yaw : 
+        std::remainder(yaw + pi, 2.0 * pi));
+  } else if (path.type == "figure8") {
+    double const angle = 2.0 * pi * a_time / p[3];
+    a_x = static_cast<float>(p[0] + p[2] * std::sin(angle));
+    a_y = static_cast<float>(p[1] 
+        + p[2] * std::sin(angle) * std::cos(angle));
+    a_yaw = static_cast<float>(std::atan2(std::cos(2.0 * angle), 
+        std::cos(angle)));
+  } else {
+    a_x = static_cast<float>(p[0]);
+    a_y = static_cast<float>(p[1]);
+    a_yaw = static_cast<float>(p[2]);
+  }
+}
+
+/**
+ * Writes a QTM RT data packet of the scene at the given time, with the given
+ * components, into the bytes. The bytes are reused between frames.
+ */
+void QtmScene::WritePacket(double a_time, uint32_t a_frameNumber, 
+    std::vector<int32_t> const &a_components, std::vector<uint8_t> &a_bytes)
+{
+  Observe(a_time);
+
+  a_bytes.clear();
+  Append<int32_t>(a_bytes, 0);
+  Append<int32_t>(a_bytes, 3);
+  Append<int64_t>(a_bytes, static_cast<int64_t>(a_time * 1e6));
+  Append<int32_t>(a_bytes, static_cast<int32_t>(a_frameNumber));
+  Append<int32_t>(a_bytes, static_cast<int32_t>(a_components.size()));
+  for (int32_t const type : a_components) {
+    std::size_t const start = a_bytes.size();
+    Append<int32_t>(a_bytes, 0);
+    Append<int32_t>(a_bytes, type);
+    if (type == 5 || type == 6 || type == 11 || type == 12) {
+      WriteBodies(type, a_bytes);
+    } else {
+      WriteMarkers(type, a_bytes);
+    }
+    Patch<int32_t>(a_bytes, start, 
+        static_cast<int32_t>(a_bytes.size() - start));
+  }
+  Patch<int32_t>(a_bytes, 0, static_cast<int32_t>(a_bytes.size()));
+}
+
+/**
+ * The QTM component type of a component name of the StreamFrames command,
+ * or -1 for components the scene does not have.
+ */
+int32_t QtmScene::GetComponentType(std::string const &a_name)
+{
+  std::vector<std::string> const names = {"3D", "3DNoLabels", "6D", 
+      "6DEuler", "3DRes", "3DNoLabelsRes", "6DRes", "6DEulerRes"};
+  std::vector<int32_t> const types = {1, 2, 5, 6, 9, 10, 11, 12};
+  for (uint32_t i = 0; i < names.size(); i++) {
+    if (names[i] == a_name) {
+      return types[i];
+    }
+  }
+  return -1;
+}
+
+/**
+ * Reads a trajectory given as 'type,parameter,parameter,..'. Throws
+ * std::runtime_error if the type or the number of parameters is wrong.
+ */
+trajectory QtmScene::ReadTrajectory(std::string const &a_string)
+{
+  trajectory path;
+  std::istringstream stream(a_string);
+  std::getline(stream, path.type, ',');
+  path.parameters.clear();
+  std::string value;
+  while (std::getline(stream, value, ',')) {
+    path.parameters.push_back(std::stod(value));
+  }
+
+  uint32_t const count = static_cast<uint32_t>(path.parameters.size());
+  if ((path.type == "static" && count == 3) 
+      || (path.type == "circle" && count == 4) 
+      || (path.type == "line" && count == 5) 
+      || (path.type == "figure8" && count == 4)) {
+    return path;
+  }
+  throw std::runtime_error(std::string("Unknown trajectory: ") + a_string);
+}
+
+/**
+ * Places the markers of every body at the given time, with noise, decides
+ * which of them are seen, and draws the ghost markers.
+ */
+void QtmScene::Observe(double a_time)
+{
+  std::normal_distribution<float> noise(0.0f, m_noise);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+  m_markers.clear();
+  m_seen.clear();
+  m_poses.clear();
+  for (uint32_t i = 0; i < m_bodies.size(); i++) {
+    float x;
+    float y;
+    float yaw;
+    GetPose(i, a_time, x, y, yaw);
+    m_poses.push_back(x);
+    m_poses.push_back(y);
+    m_poses.push_back(yaw);
+    float const c = std::cos(yaw);
+    float const s = std::sin(yaw);
+    std::vector<float> const &body = m_bodies[i];
+    for (uint32_t j = 0; j < body.size(); j += 3) {
+      m_markers.push_back(x + c * body[j] - s * body[j + 1]);
+      m_markers.push_back(y + s * body[j] + c * body[j + 1]);
+      m_markers.push_back(body[j + 2]);
+      if (m_noise > 0.0f) {
+        for (uint32_t k = m_markers.size() - 3; k < m_markers.size(); k++) {
+          m_markers[k] += noise(m_generator);
+        }
+      }
+      m_seen.push_back(uniform(m_generator) >= m_dropout);
+    }
+  }
+
+  // The number of ghosts is Poisson distributed around the mean, and they
+  // appear up to 0.3 meters above the floor.
+  m_ghosts.clear();
+  if (m_ghostCount > 0.0f) {
+    std::poisson_distribution<uint32_t> ghostCount(m_ghostCount);
+    uint32_t const count = ghostCount(m_generator);
+    for (uint32_t i = 0; i < count; i++) {
+      m_ghosts.push_back(m_arena[0] + uniform(m_generator) 
+          * (m_arena[2] - m_arena[0]));
+      m_ghosts.push_back(m_arena[1] + uniform(m_generator) 
+          * (m_arena[3] - m_arena[1]));
+      m_ghosts.push_back(0.3f * uniform(m_generator));
+    }
+  }
+
+  // Unlabelled markers come in no particular order, the seen markers of the
+  // bodies first and the ghosts after.
+  m_order.clear();
+  for (uint32_t i = 0; i < m_seen.size(); i++) {
+    if (m_seen[i] != 0) {
+      m_order.push_back(i);
+    }
+  }
+  for (uint32_t i = 0; i < m_ghosts.size() / 3; i++) {
+    m_order.push_back(static_cast<uint32_t>(m_seen.size()) + i);
+  }
+  std::shuffle(m_order.begin(), m_order.end(), m_generator);
+}
+
+/**
+ * Writes a 3D component, in millimeters. Labelled components have every
+ * label, with NaN for markers not seen, and no ghosts. The residual is the
+ * noise.
+ */
+void QtmScene::WriteMarkers(int32_t a_type, std::vector<uint8_t> &a_bytes) 
+    const
+{
+  bool const isLabelled = (a_type == 1 || a_type == 9);
+  bool const hasResidual = (a_type == 9 || a_type == 10);
+  float const nan = std::numeric_limits<float>::quiet_NaN();
+  uint32_t const count = isLabelled ? 
+      static_cast<uint32_t>(m_seen.size()) : 
+      static_cast<uint32_t>(m_order.size());
+  Append<int32_t>(a_bytes, static_cast<int32_t>(count));
+  Append<int16_t>(a_bytes, 0);
+  Append<int16_t>(a_bytes, 0);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t const index = isLabelled ? i : m_order[i];
+    float const *marker = (index < m_seen.size()) ? &m_markers[3 * index] : 
+        &m_ghosts[3 * (index - m_seen.size())];
+    bool const isSeen = !isLabelled || m_seen[index] != 0;
+    for (uint32_t k = 0; k < 3; k++) {
+      Append<float>(a_bytes, isSeen ? marker[k] * 1000.0f : nan);
+    }
+    if (!isLabelled) {
+      Append<int32_t>(a_bytes, static_cast<int32_t>(index + 1));
+    }
+    if (hasResidual) {
+      Append<float>(a_bytes, m_noise * 1000.0f);
+    }
+  }
+}
+
+/**
+ * Writes a 6D component, with the position in millimeters and the rotation
+ * as a matrix by columns or as roll, pitch and yaw in degrees. A body is
+ * only solved if at least three of its markers are seen, otherwise it is
+ * NaN.
+ */
+void QtmScene::WriteBodies(int32_t a_type, std::vector<uint8_t> &a_bytes) 
+    const
+{
+  bool const isEuler = (a_type == 6 || a_type == 12);
+  bool const hasResidual = (a_type == 11 || a_type == 12);
+  float const nan = std::numeric_limits<float>::quiet_NaN();
+  float const degree = 180.0f / 3.14159265f;
+  Append<int32_t>(a_bytes, static_cast<int32_t>(m_bodies.size()));
+  Append<int16_t>(a_bytes, 0);
+  Append<int16_t>(a_bytes, 0);
+  uint32_t marker = 0;
+  for (uint32_t i = 0; i < m_bodies.size(); i++) {
+    uint32_t const markerCount = static_cast<uint32_t>(m_bodies[i].size() / 3);
+    uint32_t seenCount = 0;
+    for (uint32_t j = 0; j < markerCount; j++) {
+      seenCount += m_seen[marker + j];
+    }
+    marker += markerCount;
+    bool const isSolved = (seenCount >= 3);
+
+    float const *pose = &m_poses[3 * i];
+    float const c = std::cos(pose[2]);
+    float const s = std::sin(pose[2]);
+    Append<float>(a_bytes, isSolved ? pose[0] * 1000.0f : nan);
+    Append<float>(a_bytes, isSolved ? pose[1] * 1000.0f : nan);
+    Append<float>(a_bytes, isSolved ? 0.0f : nan);
+    if (isEuler) {
+      Append<float>(a_bytes, isSolved ? 0.0f : nan);
+      Append<float>(a_bytes, isSolved ? 0.0f : nan);
+      Append<float>(a_bytes, isSolved ? pose[2] * degree : nan);
+    } else {
+      float const rotation[9] = {c, s, 0.0f, -s, c, 0.0f, 0.0f, 0.0f, 1.0f};
+      for (float const value : rotation) {
+        Append<float>(a_bytes, isSolved ? value : nan);
+      }
+    }
+    if (hasResidual) {
+      Append<float>(a_bytes, isSolved ? m_noise * 1000.0f : nan);
+    }
+  }
+}
+
+}
+}
+}
@@ -0,0 +1,354 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "QtmServer.h"
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+static std::string ToLower(std::string a_string)
+{
+  std::transform(a_string.begin(), a_string.end(), a_string.begin(), 
+      [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return a_string;
+}
+
+/**
+ * Serves the scene, which is only used by the stream thread once the server
+ * is open, with cameras at the given frequency in Hz.
+ */
+QtmServer::QtmServer(QtmScene &a_scene, float a_cameraFrequency)
+  : m_scene(a_scene)
+  , m_cameraFrequency(a_cameraFrequency)
+  , m_listener(-1)
+  , m_sender(-1)
+  , m_isRunning(false)
+  , m_isStreaming(false)
+  , m_streamer()
+  , m_components()
+  , m_frameCount(0)
+{
+}
+
+QtmServer::~QtmServer()
+{
+  StopStream();
+  if (m_listener >= 0) {
+    close(m_listener);
+  }
+  if (m_sender >= 0) {
+    close(m_sender);
+  }
+}
+
+/**
+ * Listens on the given TCP port, where port 0 takes any free port. Throws
+ * std::runtime_error on errors.
+ */
+void QtmServer::Open(uint16_t a_port)
+{
+  m_listener = socket(AF_INET, SOCK_STREAM, 0);
+  m_sender = socket(AF_INET, SOCK_DGRAM, 0);
+  if (m_listener < 0 || m_sender < 0) {
+    throw std::runtime_error(std::string("Could not create socket: ") 
+        + std::strerror(errno));
+  }
+  int const enable = 1;
+  setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  struct sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(a_port);
+  if (bind(m_listener, reinterpret_cast<struct sockaddr *>(&address), 
+      sizeof(address)) < 0 || listen(m_listener, 1) < 0) {
+    throw std::runtime_error(std::string("Could not listen on port ") 
+        + std::to_string(a_port) + ": " + std::strerror(errno));
+  }
+  m_isRunning = true;
+}
+
+uint16_t QtmServer::GetPort() const
+{
+  struct sockaddr_in address;
+  socklen_t length = sizeof(address);
+  getsockname(m_listener, reinterpret_cast<struct sockaddr *>(&address), 
+      &length);
+  return ntohs(address.sin_port);
+}
+
+/**
+ * Accepts and serves clients, one at a time, until stopped.
+ */
+void QtmServer::Serve()
+{
+  struct pollfd descriptor;
+  descriptor.fd = m_listener;
+  descriptor.events = POLLIN;
+  while (m_isRunning) {
+    descriptor.revents = 0;
+    if (poll(&descriptor, 1, 100) <= 0) {
+      continue;
+    }
+    struct sockaddr_in peer;
+    socklen_t length = sizeof(peer);
+    int const client = accept(m_listener, 
+        reinterpret_cast<struct sockaddr *>(&peer), &length);
+    if (client < 0) {
+      continue;
+    }
+    std::cout << "[QtmServer] Client " << inet_ntoa(peer.sin_addr) 
+        << " connected." << std::endl;
+    ServeClient(client, peer);
+    StopStream();
+    close(client);
+    std::cout << "[QtmServer] Client disconnected, sent " << m_frameCount 
+        << " frames." << std::endl;
+  }
+}
+
+/**
+ * Stops serving, from another thread.
+ */
+void QtmServer::Stop()
+{
+  m_isRunning = false;
+}
+
+uint64_t QtmServer::GetFrameCount() const
+{
+  return m_frameCount;
+}
+
+/**
+ * Greets the client and answers its commands until it disconnects. The
+ * commands may arrive split or joined, so they are split by the sizes in
+ * their headers.
+ */
+void QtmServer::ServeClient(int a_client, struct sockaddr_in const &a_peer)
+{
+  Send(a_client, 1, "QTM RT Interface connected");
+
+  std::string pending;
+  std::vector<char> buffer(4096);
+  struct pollfd descriptor;
+  descriptor.fd = a_client;
+  descriptor.events = POLLIN;
+  while (m_isRunning) {
+    descriptor.revents = 0;
+    if (poll(&descriptor, 1, 100) <= 0) {
+      continue;
+    }
+    ssize_t const count = recv(a_client, buffer.data(), buffer.size(), 0);
+    if (count <= 0) {
+      return;
+    }
+    pending.append(buffer.data(), static_cast<std::size_t>(count));
+
+    while (pending.size() >= 8) {
+      int32_t size;
+      std::memcpy(&size, pending.data(), sizeof(size));
+      if (size < 8) {
+        return;
+      }
+      if (pending.size() < static_cast<std::size_t>(size)) {
+        break;
+      }
+      std::string command = pending.substr(8, static_cast<std::size_t>(size) 
+          - 8);
+      command = command.substr(0, command.find('\0'));
+      pending.erase(0, static_cast<std::size_t>(size));
+      Reply(a_client, command, a_peer);
+    }
+  }
+}
+
+/**
+ * Answers a command as QTM does. StreamFrames has no reply unless it is
+ * refused.
+ */
+void QtmServer::Reply(int a_client, std::string const &a_command, 
+    struct sockaddr_in const &a_peer)
+{
+  std::cout << "[QtmServer] Received: " << a_command << std::endl;
+  std::string const command = ToLower(a_command);
+  if (command.compare(0, 8, "version ") == 0) {
+    Send(a_client, 1, "Version is set to " + a_command.substr(8));
+  } else if (command == "byteorder") {
+    Send(a_client, 1, "Byte order is little endian");
+  } else if (command == "getstate") {
+    // The event of a connected QTM that is not capturing.
+    Send(a_client, 6, std::string(1, static_cast<char>(1)));
+  } else if (command == "getparameters general") {
+    std::ostringstream xml;
+    xml << "<QTM_Parameters_Ver_1.12><General><Frequency>" 
+        << m_cameraFrequency << "</Frequency></General>"
+        << "</QTM_Parameters_Ver_1.12>";
+    Send(a_client, 2, xml.str());
+  } else if (command == "streamframes stop") {
+    StopStream();
+  } else if (command.compare(0, 13, "streamframes ") == 0) {
+    std::string error;
+    try {
+      StartStream(a_command.substr(13), a_peer, error);
+    } catch (std::exception const &) {
+      error = "Parse error";
+    }
+    if (!error.empty()) {
+      Send(a_client, 0, error);
+    }
+  } else {
+    Send(a_client, 0, "Parse error");
+  }
+}
+
+/**
+ * Starts streaming as given by the arguments of StreamFrames, to the UDP
+ * port on the address of the client, or on the given address. Sets the
+ * error if the arguments are refused.
+ */
+void QtmServer::StartStream(std::string const &a_arguments, 
+    struct sockaddr_in const &a_peer, std::string &a_error)
+{
+  float rate = m_cameraFrequency;
+  struct sockaddr_in destination = a_peer;
+  bool hasPort = false;
+  std::vector<int32_t> components;
+
+  std::istringstream stream(a_arguments);
+  std::string argument;
+  while (stream >> argument) {
+    std::string const lower = ToLower(argument);
+    if (lower == "allframes") {
+      rate = m_cameraFrequency;
+    } else if (lower.compare(0, 10, "frequency:") == 0) {
+      rate = std::min(std::stof(argument.substr(10)), m_cameraFrequency);
+    } else if (lower.compare(0, 17, "frequencydivisor:") == 0) {
+      rate = m_cameraFrequency 
+          / std::max(std::stof(argument.substr(17)), 1.0f);
+    } else if (lower.compare(0, 4, "udp:") == 0) {
+      std::string address = argument.substr(4);
+      std::size_t const colon = address.rfind(':');
+      if (colon != std::string::npos) {
+        inet_pton(AF_INET, address.substr(0, colon).c_str(), 
+            &destination.sin_addr);
+        address = address.substr(colon + 1);
+      }
+      destination.sin_port = htons(static_cast<uint16_t>(std::stoul(address)));
+      hasPort = true;
+    } else {
+      int32_t const type = QtmScene::GetComponentType(argument);
+      if (type < 0) {
+        a_error = "Unknown component: " + argument;
+        return;
+      }
+      components.push_back(type);
+    }
+  }
+  if (!hasPort) {
+    a_error = "Only streaming over UDP is simulated";
+    return;
+  }
+  if (components.empty() || !(rate > 0.0f)) {
+    a_error = "Parse error";
+    return;
+  }
+
+  StopStream();
+  m_components = components;
+  m_isStreaming = true;
+  m_streamer = std::thread(&QtmServer::Stream, this, rate, destination);
+  std::cout << "[QtmServer] Streaming " << m_components.size() 
+      << " components at " << rate << " Hz to " 
+      << inet_ntoa(destination.sin_addr) << ":" 
+      << ntohs(destination.sin_port) << "." << std::endl;
+}
+
+void QtmServer::StopStream()
+{
+  m_isStreaming = false;
+  if (m_streamer.joinable()) {
+    m_streamer.join();
+  }
+}
+
+/**
+ * Sends the frames at the given rate. Each frame is due at a fixed time from
+ * the start, so that the rate does not drift with the time taken to write
+ * and send the frames. The frame number counts frames of the cameras.
+ */
+void QtmServer::Stream(float a_rate, struct sockaddr_in a_destination)
+{
+  std::vector<uint8_t> packet;
+  double const period = 1.0 / static_cast<double>(a_rate);
+  std::chrono::steady_clock::time_point const start = 
+      std::chrono::steady_clock::now();
+  for (uint64_t i = 0; m_isStreaming; i++) {
+    double const time = static_cast<double>(i) * period;
+    uint32_t const frameNumber = static_cast<uint32_t>(
+        std::llround(time * static_cast<double>(m_cameraFrequency)));
+    m_scene.WritePacket(time, frameNumber, m_components, packet);
+    sendto(m_sender, packet.data(), packet.size(), 0, 
+        reinterpret_cast<struct sockaddr const *>(&a_destination), 
+        sizeof(a_destination));
+    m_frameCount++;
+
+    std::this_thread::sleep_until(start 
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(time + period)));
+  }
+}
+
+/**
+ * Sends a QTM RT packet of the given type. Strings are null terminated, the
+ * single byte of an event is not.
+ */
+void QtmServer::Send(int a_client, int32_t a_type, 
+    std::string const &a_payload) const
+{
+  std::string payload = a_payload;
+  if (a_type != 6) {
+    payload.push_back('\0');
+  }
+  int32_t const size = static_cast<int32_t>(8 + payload.size());
+  std::string packet(8, '\0');
+  std::memcpy(&packet[0], &size, sizeof(size));
+  std::memcpy(&packet[4], &a_type, sizeof(a_type));
+  packet += payload;
+  send(a_client, packet.data(), packet.size(), MSG_NOSIGNAL);
+}
+
+}
+}
+}
@@ -0,0 +1,268 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_QUALISYS_TESTSUITE_H
+#define SIM_MINIATURE_QUALISYS_TESTSUITE_H
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "cxxtest/TestSuite.h"
+
+// Include local header files.
+#include "../include/QtmScene.h"
+#include "../include/QtmServer.h"
+
+class QualisysTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    template <typename T>
+    T read(std::vector<uint8_t> const &a_bytes, uint32_t a_offset) {
+        T value;
+        std::memcpy(&value, &a_bytes[a_offset], sizeof(T));
+        return value;
+    }
+
+    void testScenePoses() {
+        opendlv::sim::miniature::QtmScene scene(0);
+        scene.AddBody({0.1f, 0.0f, 0.0f}, 
+            opendlv::sim::miniature::QtmScene::ReadTrajectory(
+            "circle,1.0,2.0,0.5,8.0"));
+        scene.AddBody({0.1f, 0.0f, 0.0f}, 
+            opendlv::sim::miniature::QtmScene::ReadTrajectory(
+            "line,0.0,0.0,2.0,0.0,4.0"));
+        TS_ASSERT_EQUALS(scene.GetBodyCount(), 2u);
+        TS_ASSERT_EQUALS(scene.GetMarkerCount(), 4u);
+
+        float x;
+        float y;
+        float yaw;
+        scene.GetPose(0, 0.0, x, y, yaw);
+        TS_ASSERT_DELTA(x, 1.5f, 1e-5f);
+        TS_ASSERT_DELTA(y, 2.0f, 1e-5f);
+        TS_ASSERT_DELTA(yaw, 1.5707963f, 1e-5f);
+        scene.GetPose(0, 2.0, x, y, yaw);
+        TS_ASSERT_DELTA(x, 1.0f, 1e-5f);
+        TS_ASSERT_DELTA(y, 2.5f, 1e-5f);
+        TS_ASSERT_DELTA(std::fabs(yaw), 3.1415927f, 1e-5f);
+
+        scene.GetPose(1, 1.0, x, y, yaw);
+        TS_ASSERT_DELTA(x, 1.0f, 1e-5f);
+        TS_ASSERT_DELTA(yaw, 0.0f, 1e-5f);
+        scene.GetPose(1, 3.0, x, y, yaw);
+        TS_ASSERT_DELTA(x, 1.0f, 1e-5f);
+        TS_ASSERT_DELTA(std::fabs(yaw), 3.1415927f, 1e-5f);
+
+        TS_ASSERT_THROWS(opendlv::sim::miniature::QtmScene::ReadTrajectory(
+            "circle,1.0"), std::runtime_error);
+        TS_ASSERT_THROWS(opendlv::sim::miniature::QtmScene::ReadTrajectory(
+            "spiral,1.0,1.0,1.0"), std::runtime_error);
+    }
+
+    void testScenePacket() {
+        opendlv::sim::miniature::QtmScene scene(0);
+        scene.AddBody({0.1f, 0.0f, 0.0f, 0.0f, 0.05f, 0.0f}, 
+            opendlv::sim::miniature::QtmScene::ReadTrajectory(
+            "static,1.0,2.0,1.5707963"));
+        std::vector<uint8_t> packet;
+        scene.WritePacket(0.5, 50, {2, 1, 6, 5}, packet);
+
+        TS_ASSERT_EQUALS(read<int32_t>(packet, 0), 
+            static_cast<int32_t>(packet.size()));
+        TS_ASSERT_EQUALS(read<int32_t>(packet, 4), 3);
+        TS_ASSERT_EQUALS(read<int64_t>(packet, 8), 500000);
+        TS_ASSERT_EQUALS(read<int32_t>(packet, 16), 50);
+        TS_ASSERT_EQUALS(read<int32_t>(packet, 20), 4);
+
+        // 3D without labels, three markers with ids.
+        uint32_t offset = 24;
+        TS_ASSERT_EQUALS(read<int32_t>(packet, offset), 16 + 3 * 16);
+        TS_ASSERT_EQUALS(read<int32_t>(packet, offset + 8), 3);
+        offset += 16 + 3 * 16;
+
+        // Labelled 3D, the origo and the markers turned a quarter left.
+        TS_ASSERT_EQUALS(read<int32_t>(packet, offset), 16 + 3 * 12);
+        TS_ASSERT_EQUALS(read<int32_t>(packet, offset + 4), 1);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 16), 1000.0f, 1e-2f);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 20), 2000.0f, 1e-2f);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 28), 1000.0f, 1e-2f);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 32), 2100.0f, 1e-2f);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 40), 950.0f, 1e-2f);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 44), 2000.0f, 1e-2f);
+        offset += 16 + 3 * 12;
+
+        // 6D Euler, and 6D with the rotation by columns.
+        TS_ASSERT_EQUALS(read<int32_t>(packet, offset), 16 + 24);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 36), 90.0f, 1e-3f);
+        offset += 16 + 24;
+        TS_ASSERT_EQUALS(read<int32_t>(packet, offset), 16 + 48);
+        TS_ASSERT_EQUALS(read<int32_t>(packet, offset + 8), 1);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 16), 1000.0f, 1e-2f);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 28), 0.0f, 1e-6f);
+        TS_ASSERT_DELTA(read<float>(packet, offset + 32), 1.0f, 1e-6f);
+        offset += 16 + 48;
+        TS_ASSERT_EQUALS(offset, packet.size());
+    }
+
+    void testSceneDropoutAndGhosts() {
+        opendlv::sim::miniature::QtmScene scene(1);
+        scene.AddBody({0.1f, 0.0f, 0.0f, 0.0f, 0.05f, 0.0f}, 
+            opendlv::sim::miniature::trajectory());
+        scene.SetDropout(1.0f);
+        scene.SetGhosts(5.0f, -1.0f, -2.0f, 1.0f, 2.0f);
+
+        std::vector<uint8_t> packet;
+        uint32_t ghostCount = 0;
+        uint32_t const frameCount = 200;
+        for (uint32_t i = 0; i < frameCount; i++) {
+            scene.WritePacket(0.01 * i, i, {2, 1, 5}, packet);
+            uint32_t const count = 
+                static_cast<uint32_t>(read<int32_t>(packet, 32));
+            for (uint32_t j = 0; j < count; j++) {
+                float const x = read<float>(packet, 40 + 16 * j);
+                float const y = read<float>(packet, 44 + 16 * j);
+                TS_ASSERT(x >= -1000.0f && x <= 1000.0f);
+                TS_ASSERT(y >= -2000.0f && y <= 2000.0f);
+                TS_ASSERT(read<int32_t>(packet, 52 + 16 * j) > 3);
+            }
+            ghostCount += count;
+
+            uint32_t const labelled = 24 + 16 + count * 16;
+            TS_ASSERT_EQUALS(read<int32_t>(packet, labelled + 8), 3);
+            TS_ASSERT(std::isnan(read<float>(packet, labelled + 16)));
+            uint32_t const bodies = labelled + 16 + 3 * 12;
+            TS_ASSERT(std::isnan(read<float>(packet, bodies + 16)));
+        }
+        float const meanGhostCount = 
+            static_cast<float>(ghostCount) / frameCount;
+        TS_ASSERT_DELTA(meanGhostCount, 5.0f, 0.5f);
+    }
+
+    // Sends a QTM RT command packet.
+    void sendCommand(int a_socket, std::string const &a_command) {
+        int32_t const size = static_cast<int32_t>(9 + a_command.size());
+        int32_t const type = 1;
+        std::string packet(8, '\0');
+        std::memcpy(&packet[0], &size, 4);
+        std::memcpy(&packet[4], &type, 4);
+        packet += a_command;
+        packet.push_back('\0');
+        send(a_socket, packet.data(), packet.size(), 0);
+    }
+
+    // Receives one QTM RT packet, and returns its type and payload.
+    int32_t receiveReply(int a_socket, std::string &a_payload) {
+        char header[8];
+        if (recv(a_socket, header, 8, MSG_WAITALL) != 8) {
+            return -1;
+        }
+        int32_t size;
+        int32_t type;
+        std::memcpy(&size, header, 4);
+        std::memcpy(&type, header + 4, 4);
+        a_payload.assign(static_cast<std::size_t>(size - 8), '\0');
+        recv(a_socket, &a_payload[0], a_payload.size(), MSG_WAITALL);
+        a_payload = a_payload.substr(0, a_payload.find('\0'));
+        return type;
+    }
+
+    void testServer() {
+        opendlv::sim::miniature::QtmScene scene(0);
+        scene.AddBody({0.1f, 0.0f, 0.0f, 0.0f, 0.05f, 0.0f}, 
+            opendlv::sim::miniature::trajectory());
+        opendlv::sim::miniature::QtmServer server(scene, 1000.0f);
+        server.Open(0);
+        std::thread serving(&opendlv::sim::miniature::QtmServer::Serve, 
+            &server);
+
+        struct sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+        bind(receiver, reinterpret_cast<struct sockaddr *>(&address), 
+            sizeof(address));
+        socklen_t length = sizeof(address);
+        getsockname(receiver, reinterpret_cast<struct sockaddr *>(&address), 
+            &length);
+        uint16_t const udpPort = ntohs(address.sin_port);
+
+        int client = socket(AF_INET, SOCK_STREAM, 0);
+        address.sin_port = htons(server.GetPort());
+        TS_ASSERT_EQUALS(connect(client, 
+            reinterpret_cast<struct sockaddr *>(&address), sizeof(address)), 
+            0);
+
+        std::string reply;
+        TS_ASSERT_EQUALS(receiveReply(client, reply), 1);
+        TS_ASSERT_EQUALS(reply, "QTM RT Interface connected");
+        sendCommand(client, "Version 1.12");
+        TS_ASSERT_EQUALS(receiveReply(client, reply), 1);
+        TS_ASSERT_EQUALS(reply, "Version is set to 1.12");
+        sendCommand(client, "ByteOrder");
+        TS_ASSERT_EQUALS(receiveReply(client, reply), 1);
+        TS_ASSERT_EQUALS(reply, "Byte order is little endian");
+        sendCommand(client, "GetParameters General");
+        TS_ASSERT_EQUALS(receiveReply(client, reply), 2);
+        TS_ASSERT(reply.find("<Frequency>1000</Frequency>") 
+            != std::string::npos);
+        sendCommand(client, "StreamFrames AllFrames UDP:1 Skeleton");
+        TS_ASSERT_EQUALS(receiveReply(client, reply), 0);
+
+        sendCommand(client, "StreamFrames FrequencyDivisor:2 UDP:" 
+            + std::to_string(udpPort) + " 3D 6DRes");
+        std::vector<uint8_t> packet(1500);
+        struct pollfd descriptor;
+        descriptor.fd = receiver;
+        descriptor.events = POLLIN;
+        int32_t previousFrame = -2;
+        uint32_t const frameCount = 50;
+        uint32_t received = 0;
+        while (received < frameCount && poll(&descriptor, 1, 1000) > 0) {
+            ssize_t const size = recv(receiver, packet.data(), packet.size(), 0);
+            TS_ASSERT_EQUALS(read<int32_t>(packet, 0), size);
+            TS_ASSERT_EQUALS(read<int32_t>(packet, 4), 3);
+            TS_ASSERT_EQUALS(read<int32_t>(packet, 20), 2);
+            TS_ASSERT_EQUALS(read<int32_t>(packet, 16), previousFrame + 2);
+            previousFrame = read<int32_t>(packet, 16);
+            received++;
+        }
+        TS_ASSERT_EQUALS(received, frameCount);
+
+        sendCommand(client, "StreamFrames Stop");
+        close(client);
+        server.Stop();
+        serving.join();
+        close(receiver);
+        TS_ASSERT(server.GetFrameCount() >= frameCount);
+    }
+};
+
+#endif
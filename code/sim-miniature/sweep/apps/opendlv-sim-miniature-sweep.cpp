@@ -0,0 +1,177 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+#include <opendavinci/odcore/strings/StringToolbox.h>
+
+#include <Navigator.h>
+
+#include "Sweep.h"
+
+static std::vector<double> ReadValueList(std::string const &a_values)
+{
+  std::vector<double> values;
+  std::vector<std::string> valueStrings = 
+      odcore::strings::StringToolbox::split(a_values, ',');
+  for (auto const &value : valueStrings) {
+    values.push_back(std::stod(value));
+  }
+  return values;
+}
+
+int32_t main(int32_t argc, char **argv) {
+  std::string configuration = "./configuration";
+  uint32_t missions = 100;
+  uint32_t goals = 1;
+  double timeout = 120.0;
+  uint32_t threads = std::thread::hardware_concurrency();
+  uint32_t seed = 0;
+  double positionNoise = 0.0;
+  double yawNoise = 0.0;
+  double startJitter = 1.0;
+  float navigationFrequency = 10.0f;
+  float simulationFrequency = 20.0f;
+  std::map<std::string, std::vector<double>> sweptValues;
+
+  std::vector<std::string> const sweepable = {"goal-tolerance", 
+      "min-preview-length", "max-preview-length", "turn-rate", "engine-still", 
+      "engine-dyn-follow-speed"};
+
+  for (int32_t i = 1; i < argc; i++) {
+    std::string const argument(argv[i]);
+    std::string const key = argument.substr(0, argument.find('='));
+    std::string const value = argument.substr(argument.find('=') + 1);
+    if (key == "--configuration") {
+      configuration = value;
+    } else if (key == "--missions") {
+      missions = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "--goals") {
+      goals = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "--timeout") {
+      timeout = std::stod(value);
+    } else if (key == "--threads") {
+      threads = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "--seed") {
+      seed = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "--position-noise") {
+      positionNoise = std::stod(value);
+    } else if (key == "--yaw-noise") {
+      yawNoise = std::stod(value);
+    } else if (key == "--start-jitter") {
+      startJitter = std::stod(value);
+    } else if (key == "--navigation-freq") {
+      navigationFrequency = std::stof(value);
+    } else if (key == "--simulation-freq") {
+      simulationFrequency = std::stof(value);
+    } else if (key.find("--") == 0 && std::find(sweepable.begin(), 
+          sweepable.end(), key.substr(2)) != sweepable.end()) {
+      sweptValues[key.substr(2)] = ReadValueList(value);
+    } else {
+      std::cerr << "Unknown argument: " << argument << std::endl;
+      return 1;
+    }
+  }
+
+  std::ifstream file(configuration);
+  if (!file.is_open()) {
+    std::cerr << "Could not open " << configuration << "." << std::endl;
+    return 1;
+  }
+  odcore::base::KeyValueConfiguration kv;
+  kv.readFrom(file);
+
+  // Parameters that are not swept keep the value from the configuration.
+  opendlv::logic::miniature::Navigator navigator(false);
+  navigator.setUp(kv, odcore::data::TimeStamp());
+  std::vector<opendlv::logic::miniature::navigationParameters> parameterSets = 
+      {navigator.getParameters()};
+
+  for (auto const &swept : sweptValues) {
+    std::vector<opendlv::logic::miniature::navigationParameters> expanded;
+    for (auto const &parameters : parameterSets) {
+      for (double const value : swept.second) {
+        opendlv::logic::miniature::navigationParameters p = parameters;
+        if (swept.first == "goal-tolerance") {
+          p.goalTolerance = value;
+        } else if (swept.first == "min-preview-length") {
+          p.minPreviewLength = value;
+        } else if (swept.first == "max-preview-length") {
+          p.maxPreviewLength = value;
+        } else if (swept.first == "turn-rate") {
+          p.turnRate = value;
+        } else if (swept.first == "engine-still") {
+          p.eStill = static_cast<int32_t>(value);
+        } else if (swept.first == "engine-dyn-follow-speed") {
+          p.eDynFollowSpeed = static_cast<int32_t>(value);
+        }
+        expanded.push_back(p);
+      }
+    }
+    parameterSets = expanded;
+  }
+
+  opendlv::sim::miniature::Sweep sweep(kv, navigationFrequency, 
+      simulationFrequency);
+  for (auto const &parameters : parameterSets) {
+    sweep.AddParameters(parameters);
+  }
+  sweep.SetMissions(missions, goals, timeout);
+  sweep.SetNoise(positionNoise, yawNoise);
+  sweep.SetStartJitter(startJitter);
+
+  std::cout << "Running " << parameterSets.size() * missions 
+      << " missions on " << threads << " threads." << std::endl;
+
+  auto const start = std::chrono::steady_clock::now();
+  sweep.Run(threads, seed);
+  auto const end = std::chrono::steady_clock::now();
+  double const wallTime = 
+      std::chrono::duration<double>(end - start).count();
+
+  std::cout << "Done in " << wallTime << " s." << std::endl;
+  std::cout << "rank,goal-tolerance,min-preview-length,max-preview-length,"
+      << "turn-rate,engine-still,engine-dyn-follow-speed,missions,failures,"
+      << "collisions,mean-mission-time" << std::endl;
+
+  std::vector<opendlv::sim::miniature::sweepResult> ranking = 
+      sweep.GetRanking();
+  for (uint32_t i = 0; i < ranking.size(); i++) {
+    opendlv::sim::miniature::sweepResult const &result = ranking[i];
+    double const meanMissionTime = (result.missions > 0) ? 
+        result.totalMissionTime / result.missions : 0.0;
+    std::cout << (i + 1) << "," << result.parameters.goalTolerance << ","
+        << result.parameters.minPreviewLength << "," 
+        << result.parameters.maxPreviewLength << ","
+        << result.parameters.turnRate << "," << result.parameters.eStill << ","
+        << result.parameters.eDynFollowSpeed << "," << result.missions << ","
+        << result.failures << "," << result.collisions << "," 
+        << meanMissionTime << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_SWEEP_H
+#define SIM_MINIATURE_SWEEP_H
+
+#include <atomic>
+#include <vector>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+
+#include <Navigator.h>
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+/**
+ * The outcome of all missions flown with one set of navigation parameters.
+ */
+struct sweepResult {
+  sweepResult();
+  opendlv::logic::miniature::navigationParameters parameters;
+  uint32_t missions;
+  uint32_t failures;
+  uint32_t collisions;
+  double totalMissionTime;
+};
+
+/**
+ * Monte Carlo evaluation of navigation parameter sets. Each set is flown in
+ * a number of closed loop missions, from randomized start poses and with
+ * noise on the LPS, and the sets are ranked by failed missions, collisions
+ * and mean mission time. The missions are spread over a number of threads,
+ * and since each mission is seeded by its index the result does not depend
+ * on the number of threads.
+ */
+class Sweep {
+ public:
+  Sweep(odcore::base::KeyValueConfiguration const &, float, float);
+  Sweep(Sweep const &) = delete;
+  Sweep &operator=(Sweep const &) = delete;
+  virtual ~Sweep();
+  void AddParameters(opendlv::logic::miniature::navigationParameters const &);
+  void SetMissions(uint32_t, uint32_t, double);
+  void SetNoise(double, double);
+  void SetStartJitter(double);
+  void Run(uint32_t, uint32_t);
+  std::vector<sweepResult> GetRanking() const;
+
+ private:
+  void RunMissions();
+  void RunMission(uint32_t);
+
+  odcore::base::KeyValueConfiguration m_kv;
+  float m_navigationFrequency;
+  float m_simulationFrequency;
+  std::vector<opendlv::logic::miniature::navigationParameters> m_parameters;
+  std::vector<sweepResult> m_results;
+  uint32_t m_missions;
+  uint32_t m_goals;
+  double m_timeout;
+  double m_positionNoise;
+  double m_yawNoise;
+  double m_startJitter;
+  uint32_t m_seed;
+  std::atomic<uint32_t> m_nextMission;
+  std::vector<double> m_missionTimes;
+  std::vector<uint32_t> m_missionCollisions;
+  std::vector<uint8_t> m_missionSucceeded;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include "ClosedLoop.h"
+#include "Sweep.h"
+
+namespace opendlv {
+namespace sim {
+namespace miniature {
+
+sweepResult::sweepResult()
+  : parameters()
+  , missions(0)
+  , failures(0)
+  , collisions(0)
+  , totalMissionTime(0.0)
+{
+}
+
+Sweep::Sweep(odcore::base::KeyValueConfiguration const &a_kv, 
+    float a_navigationFrequency, float a_simulationFrequency)
+  : m_kv(a_kv)
+  , m_navigationFrequency(a_navigationFrequency)
+  , m_simulationFrequency(a_simulationFrequency)
+  , m_parameters()
+  , m_results()
+  , m_missions(100)
+  , m_goals(1)
+  , m_timeout(120.0)
+  , m_positionNoise(0.0)
+  , m_yawNoise(0.0)
+  , m_startJitter(0.0)
+  , m_seed(0)
+  , m_nextMission(0)
+  , m_missionTimes()
+  , m_missionCollisions()
+  , m_missionSucceeded()
+{
+}
+
+Sweep::~Sweep()
+{
+}
+
+void Sweep::AddParameters(
+    opendlv::logic::miniature::navigationParameters const &a_parameters)
+{
+  m_parameters.push_back(a_parameters);
+}
+
+/*
+  Each parameter set is flown in the given number of missions, a mission is
+  successful when the given number of goals are reached before the timeout.
+*/
+void Sweep::SetMissions(uint32_t a_missions, uint32_t a_goals, 
+    double a_timeout)
+{
+  m_missions = a_missions;
+  m_goals = a_goals;
+  m_timeout = a_timeout;
+}
+
+/*
+  The standard deviations of the LPS position and yaw noise.
+*/
+void Sweep::SetNoise(double a_positionNoise, double a_yawNoise)
+{
+  m_positionNoise = a_positionNoise;
+  m_yawNoise = a_yawNoise;
+}
+
+/*
+  The largest distance from a point of interest that a mission starts at.
+*/
+void Sweep::SetStartJitter(double a_startJitter)
+{
+  m_startJitter = a_startJitter;
+}
+
+/*
+  Runs all missions on the given number of threads. The missions are handed
+  out one by one through an atomic counter, and each mission writes its
+  outcome to its own slot, so the workers share no other state.
+*/
+void Sweep::Run(uint32_t a_threads, uint32_t a_seed)
+{
+  uint32_t const missionCount = 
+      static_cast<uint32_t>(m_parameters.size()) * m_missions;
+  m_seed = a_seed;
+  m_nextMission = 0;
+  m_missionTimes.assign(missionCount, 0.0);
+  m_missionCollisions.assign(missionCount, 0);
+  m_missionSucceeded.assign(missionCount, 0);
+
+  std::vector<std::thread> workers;
+  for (uint32_t i = 0; i < std::max(a_threads, 1u); i++) {
+    workers.push_back(std::thread(&Sweep::RunMissions, this));
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  m_results.clear();
+  for (uint32_t i = 0; i < m_parameters.size(); i++) {
+    sweepResult result;
+    result.parameters = m_parameters[i];
+    for (uint32_t j = i * m_missions; j < (i + 1) * m_missions; j++) {
+      result.missions++;
+      result.collisions += m_missionCollisions[j];
+      result.totalMissionTime += m_missionTimes[j];
+      if (m_missionSucceeded[j] == 0) {
+        result.failures++;
+      }
+    }
+    m_results.push_back(result);
+  }
+}
+
+/*
+  The parameter sets with the fewest failed missions first, then the fewest
+  collisions and then the shortest mission time.
+*/
+std::vector<sweepResult> Sweep::GetRanking() const
+{
+  std::vector<sweepResult> ranking(m_results);
+  std::stable_sort(ranking.begin(), ranking.end(), 
+      [](sweepResult const &a, sweepResult const &b) {
+        if (a.failures != b.failures) {
+          return a.failures < b.failures;
+        }
+        if (a.collisions != b.collisions) {
+          return a.collisions < b.collisions;
+        }
+        return a.totalMissionTime < b.totalMissionTime;
+      });
+  return ranking;
+}
+
+void Sweep::RunMissions()
+{
+  uint32_t const missionCount = 
+      static_cast<uint32_t>(m_missionTimes.size());
+  while (true) {
+    uint32_t const mission = m_nextMission++;
+    if (mission >= missionCount) {
+      break;
+    }
+    RunMission(mission);
+  }
+}
+
+/*
+  The start pose and the noise of a mission only depend on the seed and the
+  mission number within the parameter set, so all sets are flown from the
+  same start poses.
+*/
+void Sweep::RunMission(uint32_t a_mission)
+{
+  uint32_t const set = a_mission / m_missions;
+  uint32_t const seed = m_seed + a_mission % m_missions;
+
+  ClosedLoop closedLoop(m_kv, m_navigationFrequency, m_simulationFrequency, 
+      false);
+  closedLoop.SetParameters(m_parameters[set]);
+
+  std::mt19937 randomGenerator(seed);
+  std::vector<opendlv::data::environment::Point3> pointsOfInterest = 
+      closedLoop.GetPointsOfInterest();
+  double posX = 0.0;
+  double posY = 0.0;
+  if (!pointsOfInterest.empty()) {
+    // The navigator goes to the first point first, so starting on it would
+    // reach the first goal without driving. It is only used when alone.
+    size_t const firstStart = (pointsOfInterest.size() > 1) ? 1 : 0;
+    std::uniform_int_distribution<size_t> pointDistribution(firstStart, 
+        pointsOfInterest.size() - 1);
+    opendlv::data::environment::Point3 const start = 
+        pointsOfInterest[pointDistribution(randomGenerator)];
+    std::uniform_real_distribution<double> jitterDistribution(-m_startJitter, 
+        m_startJitter);
+    posX = start.getX() + jitterDistribution(randomGenerator);
+    posY = start.getY() + jitterDistribution(randomGenerator);
+  }
+  std::uniform_real_distribution<double> yawDistribution(-M_PI, M_PI);
+  double const yaw = yawDistribution(randomGenerator);
+  closedLoop.SetPose(posX, posY, yaw);
+  closedLoop.SetLpsNoise(m_positionNoise, m_yawNoise, seed);
+
+  bool const isSucceeded = closedLoop.RunUntilGoals(m_goals, m_timeout);
+  m_missionTimes[a_mission] = closedLoop.GetSimulatedTime();
+  m_missionCollisions[a_mission] = closedLoop.GetCollisions();
+  m_missionSucceeded[a_mission] = isSucceeded ? 1 : 0;
+}
+
+}
+}
+}
@@ -0,0 +1,129 @@
+/**
+ * Copyright (C) 2017 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIM_MINIATURE_SWEEP_TESTSUITE_H
+#define SIM_MINIATURE_SWEEP_TESTSUITE_H
+
+#include <sstream>
+
+#include "cxxtest/TestSuite.h"
+
+// Include local header files.
+#include "../include/Sweep.h"
+
+class SweepTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    odcore::base::KeyValueConfiguration getConfiguration() {
+        std::stringstream configuration;
+        configuration 
+            << "logic-miniature-navigation.gpio-pins = 31" << std::endl
+            << "logic-miniature-navigation.pwm-pins = 0,1" << std::endl
+            << "logic-miniature-navigation.outer-walls = " 
+            << "20.0,-10.0;-10.0,-10.0;-10.0,10.0;20.0,10.0;" << std::endl
+            << "logic-miniature-navigation.inner-walls = " 
+            << "5.0,-2.0;5.0,2.0;" << std::endl
+            << "logic-miniature-navigation.points-of-interest = " 
+            << "15.0,5.0;-5.0,-5.0;15.0,-5.0;" << std::endl;
+        odcore::base::KeyValueConfiguration kv;
+        kv.readFrom(configuration);
+        return kv;
+    }
+
+    std::vector<opendlv::sim::miniature::sweepResult> runSweep(
+        uint32_t threads) {
+        opendlv::sim::miniature::Sweep sweep(getConfiguration(), 10.0f, 
+            20.0f);
+        opendlv::logic::miniature::navigationParameters parameters;
+        sweep.AddParameters(parameters);
+        parameters.turnRate = 0.2;
+        sweep.AddParameters(parameters);
+        sweep.SetMissions(4, 1, 30.0);
+        sweep.SetNoise(0.1, 0.02);
+        sweep.SetStartJitter(1.0);
+        sweep.Run(threads, 1);
+        return sweep.GetRanking();
+    }
+
+    void testEveryMissionIsFlown() {
+        std::vector<opendlv::sim::miniature::sweepResult> ranking = 
+            runSweep(2);
+        TS_ASSERT_EQUALS(ranking.size(), 2u);
+        for (auto const &result : ranking) {
+            TS_ASSERT_EQUALS(result.missions, 4u);
+            TS_ASSERT(result.failures <= result.missions);
+        }
+    }
+
+    void testDefaultParametersCompleteMissions() {
+        opendlv::sim::miniature::Sweep sweep(getConfiguration(), 10.0f, 
+            20.0f);
+        opendlv::logic::miniature::navigationParameters parameters;
+        sweep.AddParameters(parameters);
+        sweep.SetMissions(4, 1, 120.0);
+        sweep.SetNoise(0.1, 0.02);
+        sweep.SetStartJitter(1.0);
+        sweep.Run(2, 1);
+        std::vector<opendlv::sim::miniature::sweepResult> ranking = 
+            sweep.GetRanking();
+        TS_ASSERT_EQUALS(ranking.size(), 1u);
+        TS_ASSERT_EQUALS(ranking[0].missions, 4u);
+        TS_ASSERT_EQUALS(ranking[0].failures, 0u);
+    }
+
+    void testBadParametersRankLast() {
+        opendlv::sim::miniature::Sweep sweep(getConfiguration(), 10.0f, 
+            20.0f);
+        opendlv::logic::miniature::navigationParameters parameters;
+        // A robot that never turns towards its preview point, added first so
+        // that the ranking has to move it.
+        parameters.turnRate = 0.0;
+        sweep.AddParameters(parameters);
+        parameters.turnRate = 0.1;
+        sweep.AddParameters(parameters);
+        sweep.SetMissions(4, 1, 120.0);
+        sweep.SetNoise(0.1, 0.02);
+        sweep.SetStartJitter(1.0);
+        sweep.Run(2, 1);
+        std::vector<opendlv::sim::miniature::sweepResult> ranking = 
+            sweep.GetRanking();
+        TS_ASSERT_EQUALS(ranking.size(), 2u);
+        TS_ASSERT_DELTA(ranking[0].parameters.turnRate, 0.1, 1e-9);
+        TS_ASSERT_DELTA(ranking[1].parameters.turnRate, 0.0, 1e-9);
+        TS_ASSERT_LESS_THAN(ranking[0].failures, ranking[1].failures);
+    }
+
+    void testIndependentOfThreads() {
+        std::vector<opendlv::sim::miniature::sweepResult> ranking1 = 
+            runSweep(1);
+        std::vector<opendlv::sim::miniature::sweepResult> ranking4 = 
+            runSweep(4);
+        TS_ASSERT_EQUALS(ranking1.size(), ranking4.size());
+        for (uint32_t i = 0; i < ranking1.size(); i++) {
+            TS_ASSERT_EQUALS(ranking1[i].failures, ranking4[i].failures);
+            TS_ASSERT_EQUALS(ranking1[i].collisions, ranking4[i].collisions);
+            TS_ASSERT_DELTA(ranking1[i].totalMissionTime, 
+                ranking4[i].totalMissionTime, 1e-9);
+        }
+    }
+};
+
+#endif